@@ -0,0 +1,77 @@
+// Measures what high-frequency sampling costs: CPU time of the sampler
+// thread per sample and as a share of one core, how long reading
+// /proc/stat, /proc/meminfo and /proc/net/dev takes, and how far the ticks
+// stray from their interval. The main thread drains the ring every 33 ms
+// like the GUI does at 30 fps.
+//
+// Usage: burst_sampler_bench [seconds]
+
+#include "burst_sampler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int64_t INTERVALS_MS[] = {100, 10, 1};
+const int FRAME_MS = 33;
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(fraction * (values.size() - 1))];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? std::max(1, atoi(argv[1])) : 10;
+
+    printf("%-10s %9s %7s %7s %14s %8s %15s %15s %17s %17s\n", "Interval", "Samples", "Missed", "Dropped",
+           "CPU/sample us", "CPU %", "Collect p50 us", "Collect p99 us", "Period p50 err us", "Period p99 err us");
+
+    for (int64_t intervalMs : INTERVALS_MS) {
+        BurstSampler sampler;
+        std::vector<BurstSample> samples;
+        samples.reserve(seconds * 1000 / intervalMs + 1024);
+
+        auto begin = std::chrono::steady_clock::now();
+        sampler.start(intervalMs * 1000000);
+        while (std::chrono::steady_clock::now() - begin < std::chrono::seconds(seconds)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(FRAME_MS));
+            sampler.drain(samples);
+        }
+        sampler.stop();
+        sampler.drain(samples);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        BurstSampler::Stats stats = sampler.getStats();
+        std::vector<double> collect;
+        std::vector<double> periodError;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            collect.push_back(samples[i].collectNs / 1000.0);
+            if (i > 0) {
+                double period = (samples[i].timeNs - samples[i - 1].timeNs) / 1000.0;
+                periodError.push_back(std::abs(period - intervalMs * 1000.0));
+            }
+        }
+
+        // The first tick only sets the rate baseline and is not counted
+        double cpuPerSample = stats.samples > 0 ? stats.threadCpuNs / 1000.0 / (stats.samples + 1) : 0.0;
+        printf("%7lld ms %9llu %7llu %7llu %14.1f %8.2f %15.1f %15.1f %17.1f %17.1f\n",
+               static_cast<long long>(intervalMs),
+               static_cast<unsigned long long>(stats.samples),
+               static_cast<unsigned long long>(stats.missedDeadlines),
+               static_cast<unsigned long long>(stats.dropped),
+               cpuPerSample, 100.0 * stats.threadCpuNs / 1e9 / elapsed,
+               percentile(collect, 0.5), percentile(collect, 0.99),
+               percentile(periodError, 0.5), percentile(periodError, 0.99));
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Compares the Gorilla block encoding of CompressedSeries with a raw array
+// of (timestamp, double) pairs: bytes per sample, and how fast a chart
+// range decodes, for a day of 1 s samples with typical value shapes.
+//
+// Usage: history_codec_bench [samples]
+
+#include "gorilla_codec.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int64_t START_MS = 1700000000000LL;
+const int64_t INTERVAL_MS = 1000;
+const int REPEATS = 9;
+
+struct RawSample {
+    int64_t timeMs;
+    double value;
+};
+
+struct Profile {
+    const char* name;
+    double (*next)(std::mt19937_64& rng, double previous);
+};
+
+// Used RAM in bytes: moves by whole pages
+double memoryBytes(std::mt19937_64& rng, double previous) {
+    return previous + 4096.0 * (static_cast<int>(rng() % 41) - 20);
+}
+
+// CPU usage in percent, as a double straight from the tick deltas
+double cpuPercent(std::mt19937_64& rng, double) {
+    return 100.0 * static_cast<double>(rng() % 1000) / 997.0;
+}
+
+// Network bytes per second on a mostly idle interface
+double idleRate(std::mt19937_64& rng, double) {
+    return rng() % 20 == 0 ? static_cast<double>(rng() % 100000) : 0.0;
+}
+
+// Totals that never change, like MemTotal
+double constant(std::mt19937_64&, double previous) {
+    return previous;
+}
+
+const Profile PROFILES[] = {
+    {"memory bytes", memoryBytes},
+    {"cpu percent", cpuPercent},
+    {"idle rate", idleRate},
+    {"constant", constant},
+};
+
+double medianMs(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+template <typename Function>
+double timeMs(Function function) {
+    std::vector<double> runs;
+    for (int i = 0; i < REPEATS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        runs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return medianMs(runs);
+}
+
+// What the raw layout does for a chart range: find it and copy it out
+void decodeRaw(const std::vector<RawSample>& samples, int64_t fromMs, int64_t toMs,
+               std::vector<int64_t>& times, std::vector<double>& values) {
+    auto first = std::lower_bound(samples.begin(), samples.end(), fromMs,
+                                  [](const RawSample& sample, int64_t time) { return sample.timeMs < time; });
+    for (auto it = first; it != samples.end() && it->timeMs <= toMs; ++it) {
+        times.push_back(it->timeMs);
+        values.push_back(it->value);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t sampleCount = argc > 1 ? std::max(1000L, atol(argv[1])) : 86400;
+    size_t blockCount = sampleCount / 64 + 1;   // Never drops a block here
+
+    printf("%zu samples at 1 s with up to 2 ms jitter, median of %d runs\n", sampleCount, REPEATS);
+    printf("%-14s %9s %9s %8s %14s %14s %12s %12s\n", "profile", "raw B", "gorilla B", "ratio",
+           "raw Msamples/s", "gor Msamples/s", "raw 10m us", "gor 10m us");
+
+    for (const Profile& profile : PROFILES) {
+        std::mt19937_64 rng(1);
+        std::vector<RawSample> raw;
+        raw.reserve(sampleCount);
+        CompressedSeries compressed(blockCount);
+
+        int64_t time = START_MS;
+        double value = 6.0 * 1024 * 1024 * 1024;
+        for (size_t i = 0; i < sampleCount; ++i) {
+            time += INTERVAL_MS + static_cast<int64_t>(rng() % 5) - 2;
+            value = profile.next(rng, value);
+            raw.push_back({time, value});
+            compressed.append(time, value);
+        }
+
+        double rawBytes = static_cast<double>(sizeof(RawSample));
+        double gorillaBytes = static_cast<double>(compressed.getCompressedBytes()) / compressed.size();
+
+        std::vector<int64_t> times;
+        std::vector<double> values;
+        times.reserve(sampleCount);
+        values.reserve(sampleCount);
+        auto reset = [&]() {
+            times.clear();
+            values.clear();
+        };
+
+        // Everything, as for the widest chart range
+        double rawFullMs = timeMs([&]() { reset(); decodeRaw(raw, START_MS, time, times, values); });
+        double gorillaFullMs = timeMs([&]() { reset(); compressed.decode(START_MS, time, times, values); });
+
+        // The last ten minutes, as for the default chart range
+        int64_t from = time - 10 * 60 * 1000;
+        double rawRangeMs = timeMs([&]() { reset(); decodeRaw(raw, from, time, times, values); });
+        double gorillaRangeMs = timeMs([&]() { reset(); compressed.decode(from, time, times, values); });
+
+        printf("%-14s %9.2f %9.2f %7.1fx %14.1f %14.1f %12.1f %12.1f\n", profile.name, rawBytes, gorillaBytes,
+               rawBytes / gorillaBytes, sampleCount / rawFullMs / 1000.0, sampleCount / gorillaFullMs / 1000.0,
+               rawRangeMs * 1000.0, gorillaRangeMs * 1000.0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+// Measures the per-tick cost of updating the MemoryWindow charts for
+// growing history lengths: the old clear-and-re-append of every point,
+// RollingLineSeries, which appends the new point and drops the oldest
+// one, and a single replace() of each series with a prebuilt window.
+//
+// Usage: memory_chart_bench [ticks] [--paint]
+//
+// Runs without a display through the offscreen platform plugin. Each tick
+// includes processing the resulting events; --paint also renders the
+// chart view, which costs O(points) for either strategy.
+
+#include "rolling_line_series.h"
+#include <QApplication>
+#include <QDateTime>
+#include <QtCharts/QChart>
+#include <QtCharts/QChartView>
+#include <QtCharts/QValueAxis>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+QT_CHARTS_USE_NAMESPACE
+
+namespace {
+
+const int HISTORY_LENGTHS[] = {60, 600, 1500, 6000, 60000};     // 1,500 is MAX_CHART_POINTS
+const int SERIES_COUNT = 3;
+const qint64 TICK_MSECS = 10000;
+
+struct Chart {
+    QChart *chart;
+    QChartView *view;
+    std::vector<QLineSeries*> series;
+    QDateTimeAxis *timeAxis;
+    QValueAxis *valueAxis;
+};
+
+Chart createChart() {
+    Chart result;
+    result.chart = new QChart();
+    result.chart->legend()->setVisible(true);
+
+    result.timeAxis = new QDateTimeAxis;
+    result.timeAxis->setFormat("hh:mm:ss");
+    result.chart->addAxis(result.timeAxis, Qt::AlignBottom);
+
+    result.valueAxis = new QValueAxis;
+    result.valueAxis->setRange(0, 16);
+    result.chart->addAxis(result.valueAxis, Qt::AlignLeft);
+
+    for (int i = 0; i < SERIES_COUNT; ++i) {
+        QLineSeries *series = new QLineSeries();
+        result.chart->addSeries(series);
+        series->attachAxis(result.timeAxis);
+        series->attachAxis(result.valueAxis);
+        result.series.push_back(series);
+    }
+
+    result.view = new QChartView(result.chart);
+    result.view->resize(800, 400);
+    result.view->show();
+    return result;
+}
+
+double valueAt(int series, qint64 tick) {
+    return 4.0 + series * 3.0 + std::sin(tick * 0.1 + series);
+}
+
+// The update MemoryWindow::updateUI() used to do every tick
+void clearAndReplot(Chart &chart, const std::vector<qint64> &times) {
+    for (int i = 0; i < SERIES_COUNT; ++i) {
+        chart.series[i]->clear();
+    }
+    for (qint64 time : times) {
+        qint64 tick = time / TICK_MSECS;
+        for (int i = 0; i < SERIES_COUNT; ++i) {
+            chart.series[i]->append(time, valueAt(i, tick));
+        }
+    }
+    chart.timeAxis->setRange(QDateTime::fromMSecsSinceEpoch(times.front()),
+                             QDateTime::fromMSecsSinceEpoch(times.back()));
+}
+
+double medianMs(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+double runTick(Chart &chart, bool paint, const std::function<void()> &update) {
+    auto start = std::chrono::steady_clock::now();
+    update();
+    QCoreApplication::processEvents();
+    if (paint) {
+        chart.view->grab();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int ticks = 20;
+    bool paint = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--paint") == 0) {
+            paint = true;
+        } else {
+            ticks = std::max(1, atoi(argv[i]));
+        }
+    }
+
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty()) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    printf("%d series, %d ticks, median per tick%s\n", SERIES_COUNT, ticks, paint ? " including paint" : "");
+    printf("%10s %14s %14s %14s\n", "points", "replot ms", "rolling ms", "replace ms");
+
+    for (int length : HISTORY_LENGTHS) {
+        qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+        // Old strategy: a full window of history, replotted every tick
+        Chart replotChart = createChart();
+        std::vector<qint64> times;
+        for (int i = 0; i < length; ++i) {
+            times.push_back(now + i * TICK_MSECS);
+        }
+        clearAndReplot(replotChart, times);
+        QCoreApplication::processEvents();
+
+        std::vector<double> replotTimes;
+        for (int tick = 0; tick < ticks; ++tick) {
+            times.erase(times.begin());
+            times.push_back(times.back() + TICK_MSECS);
+            replotTimes.push_back(runTick(replotChart, paint, [&]() { clearAndReplot(replotChart, times); }));
+        }
+
+        // New strategy: the same window, one point in and one out per tick
+        Chart rollingChart = createChart();
+        RollingLineSeries rolling(length);
+        for (QLineSeries *series : rollingChart.series) {
+            rolling.addSeries(series);
+        }
+        rolling.setTimeAxis(rollingChart.timeAxis);
+
+        QVector<qint64> initialTimes;
+        std::vector<QVector<double>> initialValues(SERIES_COUNT);
+        for (int i = 0; i < length; ++i) {
+            initialTimes.append(now + i * TICK_MSECS);
+            for (int s = 0; s < SERIES_COUNT; ++s) {
+                initialValues[s].append(valueAt(s, i));
+            }
+        }
+        rolling.replace(initialTimes, initialValues);
+        QCoreApplication::processEvents();
+
+        std::vector<double> rollingTimes;
+        qint64 nextTick = length;
+        for (int tick = 0; tick < ticks; ++tick, ++nextTick) {
+            rollingTimes.push_back(runTick(rollingChart, paint, [&]() {
+                std::vector<double> values;
+                for (int s = 0; s < SERIES_COUNT; ++s) {
+                    values.push_back(valueAt(s, nextTick));
+                }
+                rolling.append(now + nextTick * TICK_MSECS, values);
+            }));
+        }
+
+        // Alternative: keep the window in vectors and hand each series the
+        // whole of it in one replace() per tick
+        Chart replaceChart = createChart();
+        RollingLineSeries replacing(length);
+        for (QLineSeries *series : replaceChart.series) {
+            replacing.addSeries(series);
+        }
+        replacing.setTimeAxis(replaceChart.timeAxis);
+        replacing.replace(initialTimes, initialValues);
+        QCoreApplication::processEvents();
+
+        std::vector<double> replaceTimes;
+        nextTick = length;
+        for (int tick = 0; tick < ticks; ++tick, ++nextTick) {
+            replaceTimes.push_back(runTick(replaceChart, paint, [&]() {
+                initialTimes.removeFirst();
+                initialTimes.append(now + nextTick * TICK_MSECS);
+                for (int s = 0; s < SERIES_COUNT; ++s) {
+                    initialValues[s].removeFirst();
+                    initialValues[s].append(valueAt(s, nextTick));
+                }
+                replacing.replace(initialTimes, initialValues);
+            }));
+        }
+
+        printf("%10d %14.3f %14.3f %14.3f\n", length, medianMs(replotTimes), medianMs(rollingTimes),
+               medianMs(replaceTimes));
+
+        // The views own their charts
+        delete replotChart.view;
+        delete rollingChart.view;
+        delete replaceChart.view;
+    }
+
+    return 0;
+}
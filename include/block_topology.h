@@ -0,0 +1,91 @@
+#ifndef BLOCK_TOPOLOGY_H
+#define BLOCK_TOPOLOGY_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Request queue attributes from /sys/block/<dev>/queue; -1 where missing
+struct BlockQueueSettings {
+    bool available;                 // Partitions use the queue of their disk
+    std::string scheduler;          // The selected one
+    std::string schedulers;         // Everything offered, as listed
+    int64_t nrRequests;
+    int64_t readAheadKb;
+    int64_t maxSectorsKb;
+    int64_t maxHwSectorsKb;
+    int rotational;
+    std::string writeCache;         // "write back" or "write through"
+};
+
+struct BlockDevice {
+    std::string name;               // sda, sda2, dm-0, md127, nvme0n1
+    unsigned int major;
+    unsigned int minor;
+    std::string kind;               // disk, partition, crypt, lvm, multipath, dm, raid1, loop, ...
+    std::string label;              // Device-mapper name, if any
+    uint64_t sizeBytes;
+    std::string parent;             // Whole disk of a partition
+    std::vector<std::string> slaves;    // Devices this one is built on
+    std::vector<std::string> holders;   // Devices built on this one
+    BlockQueueSettings queue;
+    std::vector<std::string> issues;    // Settings likely to cost throughput
+};
+
+// The block device stack from /sys/class/block: partitions, device-mapper
+// (dm-crypt, LVM, multipath) and md RAID, linked through holders/ and
+// slaves/, with each queue's settings and an audit of them. Walking sysfs
+// for hundreds of devices is not free and the stack rarely changes, so the
+// result is cached and rebuilt only after the kernel announces a block
+// device uevent (add, remove, change) on a NETLINK_KOBJECT_UEVENT socket.
+// Writes to queue attributes raise no uevent; refreshQueueSettings() picks
+// them up.
+class BlockTopologyCollector {
+public:
+    BlockTopologyCollector();
+    ~BlockTopologyCollector();
+
+    BlockTopologyCollector(const BlockTopologyCollector&) = delete;
+    BlockTopologyCollector& operator=(const BlockTopologyCollector&) = delete;
+
+    // Rebuilds if a block uevent arrived since the last call, or always
+    // when uevents are unavailable. Returns true if it rebuilt
+    bool refresh();
+
+    // Re-read the queue settings of the cached devices and audit them again
+    void refreshQueueSettings();
+
+    // True when changes are followed through uevents
+    bool isWatching() const;
+
+    // Sorted by name
+    const std::vector<BlockDevice>& getDevices() const;
+    const BlockDevice* findByName(const std::string& name) const;
+    const BlockDevice* findByNumber(unsigned int major, unsigned int minor) const;
+
+    // Devices directly below this one: its slaves, or the disk of a partition
+    std::vector<const BlockDevice*> getLowerDevices(const BlockDevice& device) const;
+
+    size_t getIssueCount() const;
+    uint64_t getRebuildCount() const;
+
+private:
+    int ueventFd;
+    bool stale;
+    std::vector<char> receiveBuffer;
+    std::vector<BlockDevice> devices;
+    std::unordered_map<std::string, size_t> indexByName;
+    std::unordered_map<uint64_t, size_t> indexByNumber;
+    uint64_t rebuildCount;
+
+    // Helper methods
+    bool drainUevents();
+    void rebuild();
+    void readDevice(int classFd, const char* name, BlockDevice& device);
+    void readQueue(int deviceFd, BlockQueueSettings& queue);
+    const BlockQueueSettings* effectiveQueue(const BlockDevice& device) const;
+    void audit(BlockDevice& device);
+};
+
+#endif // BLOCK_TOPOLOGY_H
@@ -0,0 +1,77 @@
+#ifndef BURST_SAMPLER_H
+#define BURST_SAMPLER_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include "spsc_ring.h"
+#include "sysfs_file.h"
+
+struct BurstSample {
+    int64_t timeNs;             // SampleClock time when collection started
+    uint32_t collectNs;         // Time spent reading the three files
+    float cpuBusyPercent;       // All CPUs, since the previous sample
+    uint64_t availableBytes;    // MemAvailable
+    double rxBytesPerSecond;    // All interfaces except loopback
+    double txBytesPerSecond;
+};
+
+// Samples CPU time, available memory and network bytes at 10-1000 ms on a
+// thread of its own, so a slow GUI frame cannot delay or batch up samples.
+// Ticks are absolute CLOCK_MONOTONIC deadlines; a tick that is missed is
+// skipped rather than caught up, so the phase stays fixed. Samples go into
+// a lock-free ring that the GUI drains at its own frame rate; if the GUI
+// falls behind by more than the ring holds, new samples are dropped and
+// counted.
+class BurstSampler {
+public:
+    struct Stats {
+        uint64_t samples;
+        uint64_t dropped;           // Ring full
+        uint64_t missedDeadlines;   // Ticks skipped because collection overran
+        int64_t threadCpuNs;        // CPU time of the sampler thread so far
+    };
+
+    explicit BurstSampler(size_t ringCapacity = 8192);
+    ~BurstSampler();
+
+    BurstSampler(const BurstSampler&) = delete;
+    BurstSampler& operator=(const BurstSampler&) = delete;
+
+    // Restarts the thread if it is already running
+    bool start(int64_t intervalNs);
+    void stop();
+    bool isRunning() const;
+
+    // Consumer side; appends every sample queued since the last call
+    size_t drain(std::vector<BurstSample>& samples);
+
+    Stats getStats() const;
+
+private:
+    void run(int64_t intervalNs);
+    bool collect(BurstSample& sample);
+
+    // Only touched by the sampler thread while it runs
+    SysfsFile statFile;
+    SysfsFile meminfoFile;
+    SysfsFile netDevFile;
+    std::vector<char> buffer;
+    bool hasPrevious;
+    uint64_t previousBusy;
+    uint64_t previousTotal;
+    uint64_t previousRx;
+    uint64_t previousTx;
+    int64_t previousTimeNs;
+
+    SpscRing<BurstSample> ring;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> samples;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> missedDeadlines;
+    std::atomic<int64_t> threadCpuNs;
+};
+
+#endif // BURST_SAMPLER_H
@@ -0,0 +1,87 @@
+#ifndef BURST_WINDOW_H
+#define BURST_WINDOW_H
+
+#include <QWidget>
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QComboBox>
+#include <QTimer>
+#include <vector>
+#include "burst_sampler.h"
+#include "sample_clock.h"
+
+#ifdef USE_QT_CHARTS
+#include <QtCharts/QChart>
+#include <QtCharts/QChartView>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QAreaSeries>
+#include <QtCharts/QValueAxis>
+#include <QtCharts/QDateTimeAxis>
+#include "rolling_line_series.h"
+QT_CHARTS_USE_NAMESPACE
+#endif
+
+// Sub-second view of CPU, memory and network. BurstSampler collects on its
+// own thread at the chosen interval; this page repaints at most 30 times a
+// second and draws each frame as the min/max envelope of every sample that
+// arrived since the previous one, so no burst between frames is lost and
+// the GUI cost does not grow with the sample rate.
+class BurstWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit BurstWindow(QWidget *parent = nullptr);
+    ~BurstWindow() = default;
+
+private slots:
+    void toggleSampling();
+    void renderFrame();
+
+private:
+    struct Envelope {
+        double min;
+        double max;
+    };
+
+    void setupUI();
+    void updateStatus(qint64 nowMsecs);
+    QString formatSize(double bytes) const;
+
+    BurstSampler sampler;
+    std::vector<BurstSample> pending;      // Drained each frame, reused
+
+    // For the samples/s and sampler CPU figures, once a second
+    qint64 statusMsecs;
+    BurstSampler::Stats statusStats;
+
+    QComboBox *intervalCombo;
+    QPushButton *startButton;
+    QLabel *statusLabel;
+    QLabel *cpuValueLabel;
+    QLabel *memoryValueLabel;
+    QLabel *networkValueLabel;
+    QTimer *frameTimer;
+
+    static const int FRAME_INTERVAL_MS = 33;
+    static const qint64 WINDOW_MSECS = 30 * 1000;
+
+#ifdef USE_QT_CHARTS
+    QChart *cpuChart;
+    QChart *memoryChart;
+    QChart *networkChart;
+    QChartView *cpuChartView;
+    QChartView *memoryChartView;
+    QChartView *networkChartView;
+
+    // Upper and lower lines of each area, one point per frame
+    RollingLineSeries cpuEnvelope;
+    RollingLineSeries memoryEnvelope;
+    RollingLineSeries networkEnvelope;     // Receive, then transmit
+    double memoryAxisMin;
+    double memoryAxisMax;
+    double networkAxisMax;
+#endif
+};
+
+#endif // BURST_WINDOW_H
@@ -0,0 +1,160 @@
+#ifndef CGROUP_INFO_H
+#define CGROUP_INFO_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+
+struct CgroupInfo {
+    std::string path;       // Relative to the cgroup2 mount, "" for the root
+    std::string name;       // Last path component, "/" for the root
+    int depth;
+    bool populated;         // From cgroup.events
+
+    // Raw counters
+    uint64_t cpuUsageUsec;
+    uint64_t cpuThrottledUsec;
+    uint64_t nrThrottled;
+    uint64_t memoryCurrent;
+    uint64_t memoryAnon;
+    uint64_t memoryFile;
+    uint64_t ioReadBytes;   // Summed over all devices in io.stat
+    uint64_t ioWriteBytes;
+    uint64_t pidsCurrent;
+    uint64_t oomKills;      // oom_kill from memory.events (hierarchical)
+
+    // Rates between the last two refreshes
+    double cpuPercent;              // Of one CPU
+    double cpuThrottledPercent;
+    double ioReadBytesPerSec;
+    double ioWriteBytesPerSec;
+
+    // Share of wall time with at least one task stalled ("some") or all
+    // non-idle tasks stalled ("full"), from the *.pressure totals
+    double cpuPressureSome;
+    double memoryPressureSome;
+    double memoryPressureFull;
+    double ioPressureSome;
+    double ioPressureFull;
+};
+
+struct CgroupOomEvent {
+    std::string path;
+    uint64_t kills;         // New oom_kill events in this group itself
+    std::chrono::system_clock::time_point time;
+};
+
+// Walks the cgroup v2 hierarchy once and then follows it through inotify:
+// directory create/delete watches add and remove groups, cgroup.events
+// tracks populated state and memory.events reports OOM kills as they
+// happen. Each group keeps a directory fd open so stat files are opened
+// relative to it instead of resolving the full path every tick.
+class CgroupInfoCollector {
+public:
+    CgroupInfoCollector();
+    ~CgroupInfoCollector();
+
+    CgroupInfoCollector(const CgroupInfoCollector&) = delete;
+    CgroupInfoCollector& operator=(const CgroupInfoCollector&) = delete;
+
+    // False when no cgroup2 hierarchy is mounted
+    bool isAvailable() const;
+    const std::string& getMountPoint() const;
+
+    // True when group changes are followed through inotify
+    bool isWatching() const;
+
+    // Groups of the last refresh, sorted by path (parents before children)
+    const std::vector<CgroupInfo>& getGroups() const;
+
+    // Most recent OOM kills, newest last
+    const std::deque<CgroupOomEvent>& getOomEvents() const;
+
+    // Full walks of the hierarchy (the initial one and inotify overflows)
+    uint64_t getRescanCount() const;
+
+    // Apply pending inotify events and re-read all counters
+    void refresh();
+
+    // Print cgroup information
+    void printAllInfo() const;
+
+    // Mount point of the unified (v2) hierarchy, /sys/fs/cgroup if not found
+    static std::string findMountPoint();
+
+    // Value of "key <number>" in a flat-keyed file such as cpu.stat
+    static bool parseKeyValue(const char* text, const char* key, uint64_t& value);
+
+    // Sum of every "key=<number>" token, e.g. rbytes= over all io.stat lines
+    static uint64_t sumKeyTokens(const char* text, const char* key);
+
+private:
+    enum class WatchKind {
+        DIRECTORY,
+        CGROUP_EVENTS,
+        MEMORY_EVENTS
+    };
+
+    struct Watch {
+        std::string path;
+        WatchKind kind;
+    };
+
+    struct PressureTotals {
+        uint64_t some;
+        uint64_t full;
+    };
+
+    struct Group {
+        int dirFd;
+        int directoryWatch;
+        int cgroupEventsWatch;
+        int memoryEventsWatch;
+        uint64_t oomKillsLocal;
+        CgroupInfo info;
+
+        // Previous cumulative values for rates
+        bool hasPrevious;
+        uint64_t lastCpuUsageUsec;
+        uint64_t lastCpuThrottledUsec;
+        uint64_t lastIoReadBytes;
+        uint64_t lastIoWriteBytes;
+        PressureTotals lastCpuPressure;
+        PressureTotals lastMemoryPressure;
+        PressureTotals lastIoPressure;
+    };
+
+    std::string mountPoint;
+    int rootFd;
+    int inotifyFd;
+    std::map<std::string, Group> groups;
+    std::unordered_map<int, Watch> watches;
+    std::vector<CgroupInfo> snapshot;
+    std::deque<CgroupOomEvent> oomEvents;
+    std::vector<char> readBuffer;
+    std::vector<char> eventBuffer;
+    std::chrono::steady_clock::time_point lastRefreshTime;
+    bool hasPreviousRefresh;
+    uint64_t rescanCount;
+
+    static const size_t MAX_OOM_EVENTS = 50;
+
+    // Helper methods
+    void rescan();
+    void addGroup(const std::string& path);
+    void addGroupTree(const std::string& path);
+    void removeGroupTree(const std::string& path);
+    void removeWatch(int& watch);
+    void drainInotify();
+    void readGroup(Group& group, double elapsedSeconds);
+    bool readPopulated(Group& group);
+    void checkOomKills(Group& group);
+    ssize_t readFile(const Group& group, const char* name);
+    bool readPressure(const Group& group, const char* name, PressureTotals& totals);
+};
+
+#endif // CGROUP_INFO_H
@@ -0,0 +1,64 @@
+#ifndef CGROUP_WINDOW_H
+#define CGROUP_WINDOW_H
+
+#include <QWidget>
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTreeWidget>
+#include <QListWidget>
+#include <QPushButton>
+#include <QTimer>
+#include <QHash>
+#include <QShowEvent>
+#include <QHideEvent>
+#include "cgroup_info.h"
+#include "deadline_timer.h"
+
+class CgroupWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit CgroupWindow(QWidget *parent = nullptr);
+    ~CgroupWindow() = default;
+
+protected:
+    // The hierarchy is only walked while this page is shown
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void refreshData();
+
+private:
+    enum Column {
+        NameColumn,
+        CpuColumn,
+        MemoryColumn,
+        IoReadColumn,
+        IoWriteColumn,
+        TasksColumn,
+        CpuPressureColumn,
+        MemoryPressureColumn,
+        IoPressureColumn,
+        OomColumn,
+        ColumnCount
+    };
+
+    void setupUI();
+    void updateTree();
+    void updateOomList();
+    void setCell(QTreeWidgetItem *item, int column, const QString &text, double value);
+    QString formatSize(uint64_t bytes) const;
+
+    CgroupInfoCollector cgroupInfo;
+    QTreeWidget *cgroupTree;
+    QHash<QString, QTreeWidgetItem*> items;     // By cgroup path
+    QListWidget *oomList;
+    QLabel *statusLabel;
+    QLabel *lastUpdateLabel;
+    QPushButton *refreshButton;
+    DeadlineTimer *autoRefreshTimer;
+    bool autoRefreshEnabled;
+};
+
+#endif // CGROUP_WINDOW_H
@@ -6,7 +6,20 @@
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QTableWidget>
+#include <QTimer>
 #include "cpu_info.h"
+#include "thermal_info.h"
+#include "perf_counters.h"
+#include "deadline_timer.h"
+
+#ifdef USE_QT_CHARTS
+#include <QtCharts/QChart>
+#include <QtCharts/QChartView>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
+#include <QtCharts/QDateTimeAxis>
+QT_CHARTS_USE_NAMESPACE
+#endif
 
 class CPUInfoWidget : public QWidget {
     Q_OBJECT
@@ -17,6 +30,8 @@ public:
 
 private slots:
     void refreshData();
+    void refreshThermalInfo();
+    void refreshPerfCounters();
 
 private:
     void setupUI();
@@ -27,8 +42,10 @@ private:
     // Helper methods to create different sections
     QWidget* createBasicInfoSection();
     QWidget* createFrequencySection();
+    QWidget* createThermalSection();
     QWidget* createCacheSection();
     QWidget* createFlagsSection();
+    QWidget* createPerfCountersSection();
 
     CPUInfo cpuInfo;
     QTabWidget *tabWidget;
@@ -36,6 +53,25 @@ private:
     QTableWidget *cacheInfoTable;
     QTableWidget *flagsTable;
     QLabel *lastUpdateLabel;
+
+    // Thermal and throttling
+    ThermalInfoCollector thermalInfo;
+    QTableWidget *sensorTable;
+    QLabel *coreThrottleValue;
+    QLabel *packageThrottleValue;
+    DeadlineTimer *thermalTimer;
+
+    // Performance counters
+    PerfCounterCollector perfCounters;
+    QTableWidget *perfTable;
+    QLabel *perfStatusLabel;
+    DeadlineTimer *perfTimer;
+
+#ifdef USE_QT_CHARTS
+    QChart *throttleChart;
+    QLineSeries *coreThrottleSeries;
+    QLineSeries *packageThrottleSeries;
+#endif
 };
 
 #endif // CPU_INFO_WIDGET_H
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef DEADLINE_TIMER_H
+#define DEADLINE_TIMER_H
+
+#include <QObject>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <cstdint>
+
+// Periodic timer on absolute CLOCK_MONOTONIC deadlines. QTimer re-arms
+// relative to when its slot ran, so each tick inherits the lateness of the
+// previous one and a 10 s refresh drifts by seconds over hours. A timerfd
+// keeps every expiration on the grid set by start() instead; ticks the
+// event loop was too busy to take are coalesced into one timeout() and
+// counted. Falls back to a precise QTimer where timerfd is unavailable.
+class DeadlineTimer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit DeadlineTimer(QObject *parent = nullptr);
+    ~DeadlineTimer();
+
+    // First tick one interval from now; restarts the grid if active
+    void start(int msec);
+    void stop();
+    bool isActive() const;
+    int interval() const;
+
+    // Deadlines that passed while an earlier timeout() was still pending
+    uint64_t getMissedTicks() const;
+
+signals:
+    void timeout();
+
+private slots:
+    void expired();
+
+private:
+    int fd;
+    QSocketNotifier *notifier;
+    QTimer *fallbackTimer;
+    int intervalMs;
+    bool active;
+    uint64_t missedTicks;
+};
+
+#endif // DEADLINE_TIMER_H
@@ -7,19 +7,42 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include "statvfs_pool.h"
 
 struct DiskInfo {
+    int mountId;                // From /proc/self/mountinfo; reused right after an unmount
+    unsigned int major;         // Device number of the mounted filesystem
+    unsigned int minor;
     std::string device;
     std::string mountPoint;
     std::string fsType;
     uint64_t totalSize;
     uint64_t freeSpace;
     uint64_t availableSpace;
+
+    // Sizes come from the latest statvfs() answer, which may be old: a
+    // mount that has not answered within the deadline is unresponsive and
+    // keeps its last sizes, or zeros if it never answered
+    int64_t sampledNs;          // SampleClock time of that answer, 0 if none
+    bool unresponsive;
+    bool queued;                // Unresponsive while still waiting for a worker
+    int64_t stalledNs;          // How long the pending call has run or waited, if unresponsive
 };
 
+// Keeps the parsed mount table and only re-reads /proc/self/mountinfo when
+// the kernel reports a change on it: the file signals POLLPRI | POLLERR
+// whenever a mount or unmount happens in our namespace. On hosts with
+// thousands of container mounts a refresh then costs one poll() plus the
+// statvfs() calls, rather than parsing the whole table every time. Those
+// run on a StatvfsPool, so a hung network filesystem delays a refresh by
+// the deadline once instead of blocking it for good.
 class DiskInfoCollector {
 public:
     DiskInfoCollector();
+    ~DiskInfoCollector();
+
+    DiskInfoCollector(const DiskInfoCollector&) = delete;
+    DiskInfoCollector& operator=(const DiskInfoCollector&) = delete;
 
     // Get disk information
     std::vector<DiskInfo> getDisks() const;
@@ -30,14 +53,37 @@ public:
     // Add this to the public section of the DiskInfoCollector class
     void refresh();
 
+    // Times the mount table was parsed, the first time included
+    uint64_t getMountTableReads() const;
+
 private:
+    struct MountEntry {
+        int mountId;
+        unsigned int major;
+        unsigned int minor;
+        std::string device;
+        std::string mountPoint;
+        std::string fsType;
+    };
+
     std::vector<DiskInfo> disks;
+    std::vector<MountEntry> mounts;     // Real filesystems only, in table order
+    std::vector<char> readBuffer;
+    int mountInfoFd;
+    uint64_t mountTableReads;
+    StatvfsPool statvfsPool;
+
+    static const int64_t STATVFS_TIMEOUT_NS = 500LL * 1000000;
 
     // Helper methods
     void collectDiskInfo();
+    bool mountTableChanged() const;
+    bool readMountTable();
+    static bool isPseudoFilesystem(const std::string& fsType);
+    static std::string unescapeField(const char* begin, const char* end);
 
     // Format size for display
     std::string formatSize(uint64_t size) const;
 };
 
-#endif // DISK_INFO_H
\ No newline at end of file
+#endif // DISK_INFO_H
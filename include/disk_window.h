@@ -8,7 +8,34 @@
 #include <QScrollArea>
 #include <QGroupBox>
 #include <QGridLayout>
+#include <QTabWidget>
+#include <QTableWidget>
+#include <QTreeWidget>
+#include <QPushButton>
+#include <QTimer>
+#include <QCheckBox>
+#include <memory>
+#include <map>
+#include <string>
+#include <unordered_set>
 #include "disk_info.h"
+#include "disk_stats.h"
+#include "block_topology.h"
+#include "process_info.h"
+#include "process_io.h"
+#include "trend_estimator.h"
+#include "sample_clock.h"
+#include "deadline_timer.h"
+
+#ifdef USE_QT_CHARTS
+#include <QtCharts/QChart>
+#include <QtCharts/QChartView>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
+#include <QtCharts/QDateTimeAxis>
+#include "rolling_line_series.h"
+QT_CHARTS_USE_NAMESPACE
+#endif
 
 class DiskWindow : public QWidget {
     Q_OBJECT
@@ -17,10 +44,164 @@ public:
     explicit DiskWindow(QWidget *parent = nullptr);
     ~DiskWindow() = default;
 
+private slots:
+    void refreshProcessIo();
+    void refreshFilesystems();
+    void refreshBlockDevices();
+    void blockDeviceSelectionChanged();
+    void refreshTopology();
+    void tabChanged(int index);
+
 private:
+    enum ProcessIoColumn {
+        PidColumn,
+        NameColumn,
+        ReadColumn,
+        WriteColumn,
+        ReadCallsColumn,
+        WriteCallsColumn,
+        MajorFaultsColumn,
+        MinorFaultsColumn,
+        ColumnCount
+    };
+
+    enum BlockDeviceColumn {
+        DeviceColumn,
+        ReadIopsColumn,
+        WriteIopsColumn,
+        ReadThroughputColumn,
+        WriteThroughputColumn,
+        ReadAwaitColumn,
+        WriteAwaitColumn,
+        QueueDepthColumn,
+        UtilizationColumn,
+        DiscardIopsColumn,
+        DiscardThroughputColumn,
+        DiscardAwaitColumn,
+        FlushIopsColumn,
+        FlushAwaitColumn,
+        BlockDeviceColumnCount
+    };
+
+    enum TopologyColumn {
+        TopologyDeviceColumn,
+        TopologyTypeColumn,
+        TopologySizeColumn,
+        SchedulerColumn,
+        NrRequestsColumn,
+        ReadAheadColumn,
+        RotationalColumn,
+        MaxSectorsColumn,
+        WriteCacheColumn,
+        TopologyColumnCount
+    };
+
     void setupUI();
+    struct MountGroup;
+
+    void setupFilesystemTab(QWidget *tab);
+    MountGroup createMountGroup(const DiskInfo &disk);
+    static bool isSameMount(const MountGroup &group, const DiskInfo &disk);
+    void updateMountGroup(MountGroup &group, const DiskInfo &disk);
+    void setupBlockDeviceTab(QWidget *tab);
+    void updateBlockDeviceTable();
+    void reloadBlockDeviceCharts();
+    void setupTopologyTab(QWidget *tab);
+    void updateTopologyTree();
+    void addTopologyItem(QTreeWidgetItem *parent, const BlockDevice &device, int depth,
+                         std::unordered_set<std::string> &reached);
+    void setupProcessIoTab(QWidget *tab);
+    void updateProcessIoTable();
+    QString formatSize(uint64_t bytes) const;
 
     DiskInfoCollector diskInfo;
+
+    // One group box per mount, keyed by mount ID. Groups are only
+    // created or deleted when their mount appears or goes away; otherwise
+    // a refresh touches just the labels and bars whose value changed, so
+    // hosts with hundreds of mounts stay cheap to refresh. Mount IDs are
+    // handed out again as soon as they are freed, so a group also records
+    // the device number and mount point it was made for, and is replaced
+    // when its ID turns up with others.
+    struct MountGroup {
+        unsigned int major;
+        unsigned int minor;
+        std::string mountPoint;
+
+        QGroupBox *box;
+        QLabel *mountValue;
+        QLabel *fsValue;
+        QLabel *totalValue;
+        QLabel *freeValue;
+        QLabel *availValue;
+        QLabel *usedValue;
+        QLabel *usageValue;
+        QProgressBar *usageBar;
+        QLabel *forecastLabel;
+        QLabel *stalledLabel;           // Shown while statvfs() does not answer
+
+        // Time until available space runs out, fitted over the last six hours
+        TrendEstimator trend{FORECAST_SAMPLES};
+    };
+    std::map<int, MountGroup> mountGroups;
+    QWidget *mountContent;
+    QVBoxLayout *mountLayout;
+    QLabel *noDisksLabel;
+
+    // Runs whichever tab is shown, so the forecasts keep their samples
+    DeadlineTimer *filesystemTimer;
+    int64_t lastForecastNs;
+    static const int FILESYSTEM_INTERVAL_MS = 5000;
+    static const int64_t FORECAST_INTERVAL_NS = 30LL * 1000000000;
+    static const size_t FORECAST_SAMPLES = 720;
+
+    // Sampled whichever tab is shown so the charts have history; the
+    // table is only rebuilt while its tab is visible
+    DiskStatsCollector diskStats;
+    QWidget *blockDeviceTab;
+    QTableWidget *blockDeviceTable;
+    QCheckBox *showIdleDevicesCheckbox;
+    QLabel *blockDeviceSummaryLabel;
+    DeadlineTimer *blockDeviceTimer;
+    std::string selectedDevice;
+    static const int BLOCK_DEVICE_INTERVAL_MS = 2000;
+
+#ifdef USE_QT_CHARTS
+    // History of the selected device
+    QChart *throughputChart;
+    QChart *latencyChart;
+    QChart *utilizationChart;
+    QChartView *throughputChartView;
+    QChartView *latencyChartView;
+    QChartView *utilizationChartView;
+    RollingLineSeries throughputPoints;     // Read, write
+    RollingLineSeries latencyPoints;        // Read await, write await
+    RollingLineSeries utilizationPoints;    // %util
+    double throughputAxisMax;
+    double latencyAxisMax;
+#endif
+
+    // Mount -> partition -> dm -> md -> disk stacks with their queue
+    // settings; built when the tab is first shown, then only after uevents
+    BlockTopologyCollector topology;
+    QWidget *topologyTab;
+    QTreeWidget *topologyTree;
+    QLabel *topologySummaryLabel;
+    uint64_t topologyMountReads;    // Mount table the tree was built from
+
+    // Created when the Process I/O tab is first shown, the process scan is
+    // not needed for the filesystem view
+    std::unique_ptr<ProcessInfoCollector> processInfo;
+    ProcessIoCollector processIo;
+
+    QTabWidget *tabWidget;
+    QWidget *processIoTab;
+    QTableWidget *processIoTable;
+    QLabel *processIoSummaryLabel;
+    QLabel *lastUpdateLabel;
+    QPushButton *refreshButton;
+    DeadlineTimer *autoRefreshTimer;
+    bool autoRefreshEnabled;
 };
 
 #endif // DISK_WINDOW_H
\ No newline at end of file
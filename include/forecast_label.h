@@ -0,0 +1,15 @@
+#ifndef FORECAST_LABEL_H
+#define FORECAST_LABEL_H
+
+#include <QLabel>
+#include <QString>
+#include "trend_estimator.h"
+
+// Shows a TrendForecast on a label the same way on every page: "Full in
+// ~3.2 h", red within an hour and orange within a day, with the 95% range
+// and the quality of the fit in the tooltip. what names the resource
+// ("RAM", a mount point) and window the span the line was fitted over
+// ("hour", "six hours"). Text, style and tooltip are only set on a change.
+void setForecastLabel(QLabel *label, const TrendForecast &forecast, const QString &what, const QString &window);
+
+#endif // FORECAST_LABEL_H
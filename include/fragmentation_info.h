@@ -0,0 +1,72 @@
+#ifndef FRAGMENTATION_INFO_H
+#define FRAGMENTATION_INFO_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "sysfs_file.h"
+
+struct ZoneFragmentation {
+    static const int MAX_ORDERS = 16;
+    static const int MAX_MIGRATE_TYPES = 8;
+
+    int node;
+    char zone[16];
+    int orderCount;
+    uint64_t freeBlocks[MAX_ORDERS];        // Free blocks of 2^order pages
+
+    // Derived from freeBlocks
+    uint64_t freePages;
+    uint64_t hugeFreePages;                 // In blocks of at least the huge page order
+    double unusableIndex;                   // Share of free pages too fragmented for a huge page
+
+    // Free blocks per migrate type, when /proc/pagetypeinfo is readable
+    int migrateTypeCount;
+    char migrateTypes[MAX_MIGRATE_TYPES][16];
+    uint64_t freeBlocksByType[MAX_MIGRATE_TYPES][MAX_ORDERS];
+    uint32_t lowerBoundsByType[MAX_MIGRATE_TYPES];  // Bit per order printed as ">N"
+};
+
+// Free memory per zone and buddy order from /proc/buddyinfo, and per
+// migrate type from /proc/pagetypeinfo (root only), plus the transparent
+// huge page settings. Both files are re-read into one fixed buffer and
+// parsed in place into zone slots kept from the previous refresh, so a
+// refresh allocates nothing once the zones are known.
+class FragmentationCollector {
+public:
+    FragmentationCollector();
+
+    void refresh();
+
+    const std::vector<ZoneFragmentation>& getZones() const;
+
+    // Order of a huge page (9 for 2 MB on 4 KB pages)
+    int getHugeOrder() const;
+    uint64_t getPageSize() const;
+    bool hasPageTypeInfo() const;
+
+    // Selected choice of transparent_hugepage/enabled and defrag
+    const std::string& getThpEnabled() const;
+    const std::string& getThpDefrag() const;
+
+private:
+    SysfsFile buddyInfo;
+    SysfsFile pageTypeInfo;
+    SysfsFile thpEnabledFile;
+    SysfsFile thpDefragFile;
+    std::vector<char> buffer;
+    std::vector<ZoneFragmentation> zones;
+    std::string thpEnabled;
+    std::string thpDefrag;
+    int hugeOrder;
+    uint64_t pageSize;
+    bool pageTypesRead;
+
+    // Helper methods
+    ZoneFragmentation* findZone(int node, const char* name, size_t length, size_t& cursor);
+    void parseBuddyInfo();
+    void parsePageTypeInfo();
+    void readThpSetting(const SysfsFile& file, std::string& setting);
+};
+
+#endif // FRAGMENTATION_INFO_H
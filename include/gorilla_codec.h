@@ -0,0 +1,79 @@
+#ifndef GORILLA_CODEC_H
+#define GORILLA_CODEC_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// A fixed-size block of samples compressed as in Facebook's Gorilla: each
+// timestamp is stored as the change of its delta to the previous one, and
+// each value as its XOR with the previous value, keeping only the
+// meaningful bits. Regular sampling intervals and slowly changing values
+// shrink to a few bits per sample.
+class GorillaBlock {
+public:
+    static const size_t BLOCK_BYTES = 4096;
+
+    GorillaBlock();
+
+    // Returns false, leaving the block unchanged, once it is full
+    bool append(int64_t timeMs, double value);
+
+    size_t size() const;
+    bool isEmpty() const;
+    int64_t getFirstTime() const;
+    int64_t getLastTime() const;
+    size_t getUsedBytes() const;
+
+    // Decode samples in [fromMs, toMs] and append them to the outputs
+    void decode(int64_t fromMs, int64_t toMs, std::vector<int64_t>& times, std::vector<double>& values) const;
+
+private:
+    static const size_t WORD_COUNT = BLOCK_BYTES / sizeof(uint64_t);
+
+    uint64_t words[WORD_COUNT];
+    size_t bitCount;
+    size_t count;
+
+    int64_t firstTime;
+    double firstValue;
+
+    // Encoder state after the last sample
+    int64_t lastTime;
+    int64_t lastDelta;
+    uint64_t lastValueBits;
+    int lastLeading;            // -1 until a value window exists
+    int lastTrailing;
+
+    // Helper methods
+    void writeBits(uint64_t bits, int length);
+};
+
+// Samples of one metric in a ring of Gorilla blocks, dropping the oldest
+// block once maxBlocks are in use, so memory is bounded at
+// maxBlocks * 4 KB however long the series runs.
+class CompressedSeries {
+public:
+    explicit CompressedSeries(size_t maxBlocks);
+
+    // Samples must arrive in time order; older ones are dropped
+    void append(int64_t timeMs, double value);
+
+    // Decode samples in [fromMs, toMs], skipping blocks outside the range
+    void decode(int64_t fromMs, int64_t toMs, std::vector<int64_t>& times, std::vector<double>& values) const;
+
+    size_t size() const;                // Samples held
+    size_t getCompressedBytes() const;  // Bytes used in the blocks
+    size_t memoryBytes() const;         // Bytes allocated for the blocks
+
+private:
+    std::vector<GorillaBlock> blocks;
+    size_t maxBlocks;
+    size_t head;                        // Index of the oldest block
+    size_t sampleCount;
+
+    // Helper methods
+    const GorillaBlock& blockAt(size_t index) const;
+};
+
+#endif // GORILLA_CODEC_H
@@ -21,6 +21,10 @@ class DiskWindow;     // Forward declaration
 class NetworkWindow;  // Forward declaration
 class ServiceWindow;  // Forward declaration
 class USBWindow;      // Forward declaration
+class ProcessWindow;  // Forward declaration
+class CgroupWindow;   // Forward declaration
+class BurstWindow;    // Forward declaration
+class ProcessScanner; // Forward declaration
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -39,6 +43,9 @@ private slots:
     void showServiceInfo();
     void showUSBInfo();
     void showMemoryInfo();
+    void showProcessInfo();
+    void showCgroupInfo();
+    void showBurstSampling();
     void about();
     void toggleTheme();
 
@@ -55,6 +62,10 @@ private:
     ServiceWindow *serviceWidget;
     USBWindow *usbWidget;
     MemoryWindow *memoryWidget;
+    ProcessWindow *processWidget;
+    CgroupWindow *cgroupWidget;
+    BurstWindow *burstWidget;
+    ProcessScanner *processScanner;    // Shared by the pages that list processes
 
     // Menu actions
     QAction *cpuInfoAction;
@@ -62,6 +73,9 @@ private:
     QAction *networkInfoAction;
     QAction *serviceInfoAction;
     QAction *usbInfoAction;
+    QAction *processInfoAction;
+    QAction *cgroupInfoAction;
+    QAction *burstSamplingAction;
     QAction *exitAction;
     QAction *aboutAction;
     QAction *toggleThemeAction;
@@ -0,0 +1,72 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include "sysfs_file.h"
+
+enum class MemoryStatUnit {
+    BYTES,      // meminfo lines in kB, converted
+    PAGES,      // vmstat nr_* gauges
+    COUNT       // Everything else: HugePages_* and event counters
+};
+
+struct MemoryStatKey {
+    std::string name;
+    bool vmstat;                // From /proc/vmstat, else /proc/meminfo
+    bool counter;               // Cumulative since boot; read as a rate
+    MemoryStatUnit unit;
+};
+
+// Every key of /proc/meminfo and /proc/vmstat in one dense array. The key
+// dictionary is built from the first read; later reads expect the kernel's
+// line order and only fall back to a hash lookup for a line that moved, so
+// a refresh is two pread() calls and one pass over about 250 lines.
+// Counters also get a per-second rate from the previous refresh.
+class MemoryStatsCollector {
+public:
+    MemoryStatsCollector();
+
+    bool refresh();
+
+    const std::vector<MemoryStatKey>& getKeys() const;
+    int indexOf(const std::string& name) const;     // -1 if unknown
+
+    const std::vector<uint64_t>& getValues() const;
+    uint64_t getValue(size_t index) const;
+    uint64_t getValue(const std::string& name) const;
+
+    // Per second since the previous refresh; 0 for gauges and before the
+    // second refresh
+    double getRate(size_t index) const;
+    bool hasRates() const;
+
+private:
+    struct Source {
+        SysfsFile file;
+        bool vmstat;
+        size_t first;           // First key of this file in the dictionary
+        size_t count;
+    };
+
+    Source sources[2];
+    std::vector<MemoryStatKey> keys;
+    std::unordered_map<std::string, size_t> keyIndex;
+    std::vector<uint64_t> values;
+    std::vector<uint64_t> previousValues;
+    std::vector<double> rates;
+    std::vector<size_t> counterIndices;
+    std::vector<char> buffer;
+    std::chrono::steady_clock::time_point lastRefresh;
+    int refreshCount;
+
+    // Helper methods
+    void buildDictionary(Source& source, const char* text);
+    void parse(const Source& source, const char* text);
+};
+
+#endif // MEMORY_STATS_H
@@ -10,7 +10,11 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
+#include <QComboBox>
 #include <QDateTime>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <QPointer>
 
 #ifdef USE_QT_CHARTS
 #include <QtCharts/QChart>
@@ -18,10 +22,20 @@
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QDateTimeAxis>
+#include "rolling_line_series.h"
 QT_CHARTS_USE_NAMESPACE
 #endif
 
-#include <deque>
+#include "process_scanner.h"
+#include "smaps_sampler.h"
+#include "time_series.h"
+#include "memory_stats.h"
+#include "gorilla_codec.h"
+#include "numa_info.h"
+#include "fragmentation_info.h"
+#include "trend_estimator.h"
+#include "sample_clock.h"
+#include "deadline_timer.h"
 
 struct MemoryInfo {
     // RAM info
@@ -40,7 +54,11 @@ struct MemoryInfo {
     uint64_t usedRam;
     uint64_t usedSwap;
 
-    // Timestamps for graphs
+    // When the sample was taken (SampleClock) and how long reading took;
+    // timestamp is the same instant in wall-clock time, for the charts and
+    // the saved history
+    int64_t sampledNs;
+    int64_t collectNs;
     QDateTime timestamp;
 };
 
@@ -48,16 +66,70 @@ class MemoryWindow : public QWidget {
     Q_OBJECT
 
 public:
-    explicit MemoryWindow(QWidget *parent = nullptr);
+    // Top consumers come from the shared scanner's snapshots, asked for
+    // only while this page is shown; memory history is kept regardless
+    explicit MemoryWindow(ProcessScanner *scanner, QWidget *parent = nullptr);
     ~MemoryWindow();
 
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
 private slots:
     void refreshData();
+    void processSnapshotReady();
     void updateUI();
     void toggleAutoRefresh(bool enabled);
+    void historyRangeChanged(int index);
+    void statSelectionChanged(int index);
+    void topConsumerSelectionChanged();
 
 private:
+    // Rows of the details table, created once and updated in place
+    enum DetailRow {
+        TotalRamRow,
+        UsedRamRow,
+        FreeRamRow,
+        AvailableRamRow,
+        BuffersRow,
+        CachedRow,
+        SharedMemoryRow,
+        TotalSwapRow,
+        UsedSwapRow,
+        FreeSwapRow,
+        RamUsageRow,
+        SwapUsageRow,
+        DetailRowCount
+    };
+
+    enum TopConsumerColumn {
+        PidColumn,
+        NameColumn,
+        PssColumn,
+        UssColumn,
+        RssColumn,
+        SwapColumn,
+        AgeColumn,
+        TopConsumerColumnCount
+    };
+
     void setupUI();
+    void updateForecasts(const MemoryInfo &info);
+    void updateTopConsumers();
+    void updateNumaNodes();
+    void updatePlacement();
+    void setupFragmentationGroup(QVBoxLayout *mainLayout);
+    void updateFragmentation(qint64 msecsSinceEpoch);
+    void setDetail(DetailRow row, const QString &value);
+    void openHistoryFiles();
+    void appendHistory(const MemoryInfo &info);
+    void updateCharts(const MemoryInfo &info);
+    void reloadCharts();
+    void appendStatHistory(qint64 msecsSinceEpoch);
+    void reloadStatChart();
+    void updateStatChartTitle(qint64 latestMsecs);
+    double statChartValue(size_t index, double value) const;
+    QString formatStat(size_t index, double value) const;
     MemoryInfo getMemoryInfo();
     QString formatSize(uint64_t bytes) const;
 
@@ -65,9 +137,21 @@ private:
     QLabel *lastUpdateLabel;
     QProgressBar *ramProgressBar;
     QProgressBar *swapProgressBar;
+    QLabel *ramForecastLabel;
+    QLabel *swapForecastLabel;
     QTableWidget *memoryTable;
+    QTableWidget *topConsumersTable;
+    QLabel *topConsumersLabel;
+    QLabel *numaPlacementLabel;
+    std::vector<QProgressBar*> nodeBars;
+    std::vector<QLabel*> nodeRateLabels;
+    QLabel *thpLabel;
+    QTableWidget *fragmentationTable;
     QPushButton *refreshButton;
-    QTimer *refreshTimer;
+    QComboBox *historyRangeCombo;
+    QComboBox *statCombo;
+    QLabel *statValueLabel;
+    DeadlineTimer *refreshTimer;
 
 #ifdef USE_QT_CHARTS
     // Chart components
@@ -80,11 +164,69 @@ private:
     QChart *swapChart;
     QChartView *swapChartView;
     QLineSeries *swapUsageSeries;
+
+    QChart *statChart;
+    QChartView *statChartView;
+    QLineSeries *statSeries;
+
+    QChart *fragmentationChart;
+    QChartView *fragmentationChartView;
+
+    // Append-and-trim windows over the series above
+    RollingLineSeries ramChartPoints;
+    RollingLineSeries swapChartPoints;
+    RollingLineSeries statChartPoints;
+    RollingLineSeries fragmentationChartPoints;     // One series per zone
+    double ramAxisMax;
+    double swapAxisMax;
+    double statAxisMax;
+    qint64 statChartStartMsecs;     // Oldest point on the stat chart, 0 if none
+    double fragmentationAxisMax;
+
+    // Tier shown for the selected range, and its bucket count when loaded;
+    // coarse tiers are reloaded only when they gain a bucket
+    TimeSeriesTier chartTier;
+    uint64_t chartBucketCount;
 #endif
 
-    // Data storage
-    std::deque<MemoryInfo> memoryHistory;
-    const int MAX_HISTORY_SIZE = 60; // Store 60 data points (10 minutes at 10s intervals)
+    // Per-process PSS/USS/swap, read within a time budget per snapshot
+    QPointer<ProcessScanner> processScanner;
+    std::shared_ptr<const ProcessSnapshot> processSnapshot;
+    SmapsSampler smapsSampler;
+
+    // Every meminfo and vmstat key, each with a compressed history so any
+    // of them can be charted when picked. Four 4 KB blocks per key keep
+    // memory near 4 MB for the ~250 keys. At one sample per 10 s that is
+    // about 4 h for a noisy key and about 2 days for a constant one, less
+    // a block after each turnover. When that falls short of the selected
+    // range, the stat chart title says how much history it shows.
+    MemoryStatsCollector memoryStats;
+    std::vector<CompressedSeries> statHistory;
+    static const size_t STAT_HISTORY_BLOCKS = 4;
+
+    // Per-node usage and allocation rates, shown on multi-node machines,
+    // and the node placement of the selected top consumer
+    NumaInfoCollector numaInfo;
+    int placementPid;
+
+    // Free memory per zone and buddy order, and transparent huge pages
+    FragmentationCollector fragmentation;
+
+    // Time until available RAM and free swap run out, fitted over the
+    // last hour of samples
+    TrendEstimator availableRamTrend;
+    TrendEstimator freeSwapTrend;
+    static const size_t FORECAST_SAMPLES = 360;
+
+    // Data storage: the latest sample, and 30 days of downsampled history
+    // kept in ring files that survive restarts
+    MemoryInfo currentInfo;
+    TimeSeries usedRamHistory;
+    TimeSeries cachedHistory;
+    TimeSeries buffersHistory;
+    TimeSeries usedSwapHistory;
+    qint64 historyRangeMsecs;
+    static const int MAX_CHART_POINTS = 1500;
 };
 
 #endif // MEMORY_WINDOW_H
\ No newline at end of file
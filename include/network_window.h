@@ -8,6 +8,7 @@
 #include <QPushButton>
 #include <QTimer>
 #include "network_info.h"
+#include "deadline_timer.h"
 
 class NetworkWindow : public QWidget {
     Q_OBJECT
@@ -27,7 +28,7 @@ private:
     QTableWidget *interfaceTable;
     QPushButton *refreshButton;
     QLabel *lastUpdateLabel;
-    QTimer *autoRefreshTimer;
+    DeadlineTimer *autoRefreshTimer;
 };
 
 #endif // NETWORK_WINDOW_H
\ No newline at end of file
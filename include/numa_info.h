@@ -0,0 +1,76 @@
+#ifndef NUMA_INFO_H
+#define NUMA_INFO_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "sysfs_file.h"
+
+struct NumaNodeInfo {
+    int node;
+
+    // From node<N>/meminfo
+    uint64_t totalBytes;
+    uint64_t freeBytes;
+    uint64_t usedBytes;
+    uint64_t filePagesBytes;
+    uint64_t anonPagesBytes;
+
+    // From node<N>/numastat, in pages allocated since boot
+    uint64_t numaHit;           // Allocated here as intended
+    uint64_t numaMiss;          // Allocated here although meant for another node
+    uint64_t numaForeign;       // Meant for here but allocated elsewhere
+    uint64_t interleaveHit;
+    uint64_t localNode;         // Allocated here by a task running here
+    uint64_t otherNode;         // Allocated here by a task on another node
+
+    // Pages per second since the previous refresh
+    double hitRate;
+    double missRate;
+    double foreignRate;
+    double localRate;
+    double otherRate;
+};
+
+// Memory of one process per NUMA node, from /proc/<pid>/numa_maps
+struct NumaPlacement {
+    std::vector<int> nodes;
+    std::vector<uint64_t> bytes;            // Resident bytes per node
+    std::vector<uint64_t> anonBytes;        // Of which anonymous
+    uint64_t totalBytes;
+};
+
+class NumaInfoCollector {
+public:
+    NumaInfoCollector();
+
+    // Re-read meminfo and numastat of every node
+    void refresh();
+
+    const std::vector<NumaNodeInfo>& getNodes() const;
+
+    // More than one node with memory
+    bool isNuma() const;
+
+    // Walks the page tables of the whole process; meant for one selected
+    // process, not for every process on every refresh
+    static bool readPlacement(int pid, NumaPlacement& placement);
+
+private:
+    struct NodeHandle {
+        SysfsFile meminfo;
+        SysfsFile numastat;
+    };
+
+    std::vector<NumaNodeInfo> nodes;
+    std::vector<NodeHandle> handles;
+    std::vector<char> buffer;
+    std::chrono::steady_clock::time_point lastRefresh;
+    bool hasPreviousRefresh;
+
+    // Helper methods
+    void discoverNodes();
+};
+
+#endif // NUMA_INFO_H
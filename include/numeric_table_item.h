@@ -0,0 +1,22 @@
+#ifndef NUMERIC_TABLE_ITEM_H
+#define NUMERIC_TABLE_ITEM_H
+
+#include <QTableWidgetItem>
+#include <QVariant>
+
+// A table cell that sorts on the raw value stored in Qt::UserRole instead
+// of its display text, so "9.5 MB" sorts below "12 GB". Cells without a
+// value fall back to comparing their text.
+class NumericTableItem : public QTableWidgetItem {
+public:
+    bool operator<(const QTableWidgetItem &other) const override {
+        QVariant left = data(Qt::UserRole);
+        QVariant right = other.data(Qt::UserRole);
+        if (left.isValid() && right.isValid()) {
+            return left.toDouble() < right.toDouble();
+        }
+        return QTableWidgetItem::operator<(other);
+    }
+};
+
+#endif // NUMERIC_TABLE_ITEM_H
@@ -0,0 +1,85 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+enum class PerfCounterMode {
+    HARDWARE,       // PMU events plus software events
+    SOFTWARE_ONLY,  // No usable PMU (e.g. inside a VM)
+    UNAVAILABLE     // perf_event_open refused or not supported
+};
+
+struct PerfCounterRates {
+    double cyclesPerSec;
+    double instructionsPerSec;
+    double instructionsPerCycle;
+    double cacheMissesPerSec;
+    double branchMissesPerSec;
+    double contextSwitchesPerSec;
+    double cpuMigrationsPerSec;
+    double pageFaultsPerSec;
+    bool valid;
+};
+
+class PerfCounterCollector {
+public:
+    PerfCounterCollector();
+    ~PerfCounterCollector();
+
+    PerfCounterCollector(const PerfCounterCollector&) = delete;
+    PerfCounterCollector& operator=(const PerfCounterCollector&) = delete;
+
+    PerfCounterMode getMode() const;
+    std::string getStatusMessage() const;
+    int getMonitoredCpuCount() const;
+
+    // System-wide rates since the previous refresh()
+    PerfCounterRates getRates() const;
+
+    // Read one counter group per CPU and update the rates
+    void refresh();
+
+    // Print counter information
+    void printAllInfo() const;
+
+private:
+    // Slots in the per-CPU group, in read order
+    enum Counter {
+        COUNTER_LEADER,          // cycles (hardware) or cpu-clock (software)
+        COUNTER_INSTRUCTIONS,
+        COUNTER_CACHE_MISSES,
+        COUNTER_BRANCH_MISSES,
+        COUNTER_CONTEXT_SWITCHES,
+        COUNTER_CPU_MIGRATIONS,
+        COUNTER_PAGE_FAULTS,
+        COUNTER_COUNT
+    };
+
+    struct CpuGroup {
+        int cpu;
+        std::vector<int> fds;            // fds[0] is the group leader
+        std::vector<int> counterSlots;   // Counter for each group member
+        uint64_t lastValues[COUNTER_COUNT];
+        uint64_t lastTimeEnabled;
+        uint64_t lastTimeRunning;
+        bool hasPrevious;
+    };
+
+    std::vector<CpuGroup> groups;
+    PerfCounterMode mode;
+    std::string statusMessage;
+    PerfCounterRates rates;
+    std::chrono::steady_clock::time_point lastSampleTime;
+    bool hasPreviousSample;
+
+    bool openGroups(bool hardware, int& error);
+    bool openGroup(CpuGroup& group, bool hardware, int& error);
+    void closeGroups();
+    std::vector<int> getOnlineCpus() const;
+    int readParanoidLevel() const;
+};
+
+#endif // PERF_COUNTERS_H
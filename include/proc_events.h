@@ -0,0 +1,52 @@
+#ifndef PROC_EVENTS_H
+#define PROC_EVENTS_H
+
+#include <vector>
+#include <cstdint>
+
+enum class ProcEventType {
+    FORK,
+    EXEC,
+    EXIT
+};
+
+struct ProcEvent {
+    ProcEventType type;
+    int pid;    // Thread group id of the process the event is about
+};
+
+// Listens for process fork/exec/exit notifications from the kernel's
+// netlink proc connector. Needs CAP_NET_ADMIN; isActive() reports whether
+// the subscription succeeded so callers can fall back to rescanning /proc.
+class ProcEventListener {
+public:
+    ProcEventListener();
+    ~ProcEventListener();
+
+    ProcEventListener(const ProcEventListener&) = delete;
+    ProcEventListener& operator=(const ProcEventListener&) = delete;
+
+    bool isActive() const;
+
+    // Non-blocking: append all queued process (not thread) events to events.
+    // Returns false if the socket overflowed and events were lost, in which
+    // case the caller must resynchronize from /proc.
+    bool drainEvents(std::vector<ProcEvent>& events);
+
+    // Running totals of process (not thread) events since the listener started
+    uint64_t getForkCount() const;
+    uint64_t getExecCount() const;
+    uint64_t getExitCount() const;
+
+private:
+    int socketFd;
+    uint64_t forkCount;
+    uint64_t execCount;
+    uint64_t exitCount;
+    std::vector<char> receiveBuffer;
+
+    bool subscribe(bool enable);
+    void close();
+};
+
+#endif // PROC_EVENTS_H
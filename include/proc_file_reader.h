@@ -0,0 +1,55 @@
+#ifndef PROC_FILE_READER_H
+#define PROC_FILE_READER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+
+struct ProcReadRequest {
+    int dirFd;          // Directory the name is relative to
+    const char* name;
+    char* buffer;       // Caller-owned, NUL terminated on success
+    size_t capacity;
+    ssize_t length;     // Bytes read, or -errno
+};
+
+// Reads many small procfs/sysfs files per call. The io_uring backend
+// submits the opens, reads and closes of a whole batch with one
+// io_uring_enter() per phase instead of three syscalls per file; the
+// synchronous backend is used when io_uring is unavailable.
+class ProcFileReader {
+public:
+    enum class Backend {
+        SYNC,
+        IO_URING
+    };
+
+    explicit ProcFileReader(Backend preferred = Backend::IO_URING);
+    ~ProcFileReader();
+
+    ProcFileReader(const ProcFileReader&) = delete;
+    ProcFileReader& operator=(const ProcFileReader&) = delete;
+
+    Backend getBackend() const;
+
+    // Fill every request's buffer with the file content from offset 0
+    void readAll(std::vector<ProcReadRequest>& requests);
+
+private:
+    struct Ring;
+
+    Backend backend;
+    Ring* ring;
+    std::vector<int> openFds;
+
+    bool setupRing();
+    void destroyRing();
+    void readAllSync(std::vector<ProcReadRequest>& requests);
+    void readAllUring(std::vector<ProcReadRequest>& requests);
+    void readChunkUring(ProcReadRequest* requests, size_t count);
+    void failChunk(ProcReadRequest* requests, size_t count);
+    int submitAndWait(unsigned count);
+};
+
+#endif // PROC_FILE_READER_H
@@ -0,0 +1,116 @@
+#ifndef PROCESS_INFO_H
+#define PROCESS_INFO_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <sys/types.h>
+#include "proc_events.h"
+#include "proc_file_reader.h"
+
+struct ProcessInfo {
+    int pid;
+    int ppid;
+    std::string name;       // comm from /proc/<pid>/stat
+    char state;
+    uid_t uid;
+    int numThreads;
+
+    // starttime (clock ticks after boot) tells a reused PID apart
+    uint64_t startTime;
+    uint64_t cpuTicks;      // utime + stime
+    double cpuPercent;      // Of one CPU, over the last refresh interval
+
+    uint64_t rssBytes;
+    uint64_t sharedBytes;
+    uint64_t virtualBytes;
+
+    // Cumulative counters from /proc/<pid>/stat
+    uint64_t minorFaults;
+    uint64_t majorFaults;
+    uint64_t blkioDelayTicks;   // Time blocked on block I/O, needs delay accounting
+};
+
+class ProcessInfoCollector {
+public:
+    // readBackend selects how per-process files are read; io_uring is
+    // opt-in because procfs reads are punted to io-wq workers (see bench/)
+    explicit ProcessInfoCollector(ProcFileReader::Backend readBackend = ProcFileReader::Backend::SYNC);
+    ~ProcessInfoCollector();
+
+    ProcessInfoCollector(const ProcessInfoCollector&) = delete;
+    ProcessInfoCollector& operator=(const ProcessInfoCollector&) = delete;
+
+    // Processes of the last refresh, sorted by PID
+    const std::vector<ProcessInfo>& getProcesses() const;
+
+    // Wall time spent in the last refresh()
+    double getLastScanDurationMs() const;
+
+    // True when per-process files are read through io_uring batches
+    bool usesIoUring() const;
+
+    // True when the PID set is tracked through proc connector events
+    bool isEventDriven() const;
+
+    // Per-second rates between the last two refreshes (event-driven only)
+    double getForkRate() const;
+    double getExecRate() const;
+    double getExitRate() const;
+
+    // Rescan /proc and compute CPU usage from the previous scan
+    void refresh();
+
+    // Print process information
+    void printAllInfo() const;
+
+private:
+    int procFd;
+    std::vector<char> direntBuffer;
+
+    // Per-process files are read in batches of PIDs; the buffers and the
+    // "<pid>/<file>" path arena are sized for one batch and reused
+    ProcFileReader fileReader;
+    std::vector<ProcReadRequest> requests;
+    std::vector<char> pathArena;
+    std::vector<char> statBuffers;
+    std::vector<char> statmBuffers;
+    std::vector<char> statusBuffers;
+    std::vector<ProcessInfo> batch;
+    std::vector<size_t> statusIndex;
+
+    std::vector<ProcessInfo> processes;
+    std::vector<ProcessInfo> previousProcesses;
+    std::chrono::steady_clock::time_point lastScanTime;
+    bool hasPreviousScan;
+    double lastScanDurationMs;
+    long ticksPerSecond;
+    long pageSize;
+
+    // PID set, sorted; rebuilt by scanPidList() or patched from events
+    std::vector<int> livePids;
+    ProcEventListener procEvents;
+    std::vector<ProcEvent> pendingEvents;
+    int ticksSinceFullScan;
+
+    uint64_t lastForkCount;
+    uint64_t lastExecCount;
+    uint64_t lastExitCount;
+    double forkRate;
+    double execRate;
+    double exitRate;
+
+    // Helper methods
+    void scanPidList();
+    void applyEvents();
+    void updateEventRates(std::chrono::steady_clock::time_point now);
+    void readBatch(size_t first, size_t count, double elapsedTicks, size_t& previousCursor);
+    const char* pathFor(size_t slot, int kind, int pid);
+    bool parseStat(const char* data, ssize_t length, ProcessInfo& info);
+    bool parseStatm(const char* data, ssize_t length, ProcessInfo& info);
+    bool parseStatusUid(const char* data, ssize_t length, ProcessInfo& info);
+    const ProcessInfo* findPrevious(int pid, size_t& cursor) const;
+};
+
+#endif // PROCESS_INFO_H
@@ -0,0 +1,111 @@
+#ifndef PROCESS_IO_H
+#define PROCESS_IO_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include "process_info.h"
+#include "proc_file_reader.h"
+
+struct ProcessIoInfo {
+    int pid;
+    std::string name;
+
+    // From /proc/<pid>/io, zero unless the file was read this update
+    bool ioSampled;
+    double readBytesPerSec;     // read_bytes: fetched from storage
+    double writeBytesPerSec;    // write_bytes: sent (or dirtied) towards storage
+    double readCallsPerSec;     // syscr
+    double writeCallsPerSec;    // syscw
+
+    // From /proc/<pid>/stat, available for every process
+    double majorFaultsPerSec;
+    double minorFaultsPerSec;
+};
+
+// Per-process I/O and page-fault rates on top of ProcessInfoCollector
+// snapshots. Fault counters come with the stat read the snapshot already
+// did; /proc/<pid>/io is costlier (a ptrace access check and a walk over
+// all threads), so it is only read for the top-K candidates ranked by
+// the stat deltas, plus a fixed-size round-robin slice of everything
+// else so quiet processes that start writing are still discovered.
+class ProcessIoCollector {
+public:
+    static const size_t DEFAULT_TOP_K = 64;
+    static const size_t DEFAULT_SWEEP_BUDGET = 256;
+
+    explicit ProcessIoCollector(size_t topK = DEFAULT_TOP_K, size_t sweepBudget = DEFAULT_SWEEP_BUDGET);
+    ~ProcessIoCollector();
+
+    ProcessIoCollector(const ProcessIoCollector&) = delete;
+    ProcessIoCollector& operator=(const ProcessIoCollector&) = delete;
+
+    // Compute rates against the previous snapshot; processes must be
+    // sorted by PID as returned by ProcessInfoCollector::getProcesses()
+    void update(const std::vector<ProcessInfo>& processes);
+
+    // Processes with any I/O or fault activity in the last update,
+    // busiest (read + write bytes, then major faults) first
+    const std::vector<ProcessIoInfo>& getActiveProcesses() const;
+
+    // /proc/<pid>/io files read in the last update, and the total process count
+    size_t getLastIoReadCount() const;
+    size_t getProcessCount() const;
+    double getLastUpdateDurationMs() const;
+
+private:
+    struct Entry {
+        int pid;
+        uint64_t startTime;
+        uint64_t cpuTicks;
+        uint64_t minorFaults;
+        uint64_t majorFaults;
+        uint64_t blkioDelayTicks;
+        double score;               // Activity from the stat deltas of this update
+        double majorFaultsPerSec;
+        double minorFaultsPerSec;
+
+        bool hasIo;
+        bool ioDenied;              // Not ours to read; never retried
+        bool ioActive;              // Non-zero I/O on the last read
+        uint64_t readBytes;
+        uint64_t writeBytes;
+        uint64_t readCalls;
+        uint64_t writeCalls;
+        std::chrono::steady_clock::time_point ioTime;
+        uint64_t selectedGeneration;
+
+        bool ioSampled;             // Read in this update
+        double readBytesPerSec;
+        double writeBytesPerSec;
+        double readCallsPerSec;
+        double writeCallsPerSec;
+    };
+
+    size_t topK;
+    size_t sweepBudget;
+    int procFd;
+    ProcFileReader fileReader;
+    std::vector<ProcReadRequest> requests;
+    std::vector<char> pathArena;
+    std::vector<char> ioBuffers;
+
+    std::vector<Entry> entries;         // Sorted by PID
+    std::vector<Entry> previousEntries;
+    std::vector<size_t> selected;       // Indices into entries read this update
+    std::vector<ProcessIoInfo> active;
+    std::chrono::steady_clock::time_point lastUpdateTime;
+    bool hasPreviousUpdate;
+    uint64_t generation;
+    int sweepPid;
+    double lastUpdateDurationMs;
+
+    // Helper methods
+    void selectCandidates();
+    void readIo(std::chrono::steady_clock::time_point now);
+    bool parseIo(const char* data, ssize_t length, uint64_t counters[4]) const;
+};
+
+#endif // PROCESS_IO_H
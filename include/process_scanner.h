@@ -0,0 +1,73 @@
+#ifndef PROCESS_SCANNER_H
+#define PROCESS_SCANNER_H
+
+#include <QObject>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include "process_info.h"
+
+// One process table scan and what the collector knew about it
+struct ProcessSnapshot {
+    std::vector<ProcessInfo> processes;     // Sorted by PID
+    int64_t sampledNs;                      // SampleClock time the scan finished
+    double scanDurationMs;
+    bool usesIoUring;
+    bool eventDriven;
+    double forkRate;
+    double execRate;
+    double exitRate;
+};
+
+// Runs ProcessInfoCollector on a thread of its own and hands immutable
+// snapshots to every page that shows processes. A scan of /proc costs about
+// 1.1 s per 100k processes (see bench/README.md), far too long for the GUI
+// thread, and one scan can serve all pages. Pages ask for scans at their
+// own interval while they are shown; the scanner runs at the shortest
+// interval asked for and sleeps when nobody asks. The collector itself is
+// only built by the first scan.
+class ProcessScanner : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ProcessScanner(ProcFileReader::Backend readBackend = ProcFileReader::Backend::SYNC,
+                            QObject *parent = nullptr);
+    ~ProcessScanner();
+
+    // Scan every intervalMs on behalf of client until it is removed; if the
+    // last scan started longer ago than that, the next one starts at once
+    void addClient(const void *client, int intervalMs);
+    void removeClient(const void *client);
+
+    // Scan as soon as the thread is free, e.g. for a Refresh button
+    void requestScan();
+
+    // The latest snapshot, nullptr before the first scan has finished
+    std::shared_ptr<const ProcessSnapshot> getSnapshot() const;
+
+signals:
+    // Emitted from the scanner thread; connections to widgets are queued
+    void snapshotReady();
+
+private:
+    void run();
+    int64_t intervalNsLocked() const;      // Shortest asked for, 0 if none
+
+    ProcFileReader::Backend readBackend;
+    std::unique_ptr<ProcessInfoCollector> collector;    // Scanner thread only
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeup;
+    std::map<const void*, int64_t> clientIntervalsNs;
+    std::shared_ptr<const ProcessSnapshot> snapshot;
+    int64_t lastScanStartNs;
+    bool scanRequested;
+    bool stopping;
+    std::thread thread;
+};
+
+#endif // PROCESS_SCANNER_H
@@ -0,0 +1,57 @@
+#ifndef PROCESS_TABLE_MODEL_H
+#define PROCESS_TABLE_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QString>
+#include <vector>
+#include "process_info.h"
+
+// Table model over a process snapshot. Views only ask for visible rows, so
+// the cost per refresh is the sort/filter of row indices, not item creation.
+class ProcessTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column {
+        PidColumn,
+        NameColumn,
+        UserColumn,
+        StateColumn,
+        CpuColumn,
+        MemoryColumn,
+        ThreadsColumn,
+        ParentColumn,
+        ColumnCount
+    };
+
+    explicit ProcessTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    void setProcesses(const std::vector<ProcessInfo> &snapshot);
+    void setFilter(const QString &text);
+
+    // PID shown at a row, or -1
+    int pidAt(int row) const;
+    int rowOfPid(int pid) const;
+
+    static QString formatSize(uint64_t bytes);
+
+private:
+    void rebuildRows();
+    QString userName(uid_t uid) const;
+
+    std::vector<ProcessInfo> processes;
+    std::vector<int> rows;      // Indices into processes, filtered and sorted
+    QString filter;
+    int sortColumn;
+    Qt::SortOrder sortOrder;
+    mutable QHash<uid_t, QString> userNames;
+};
+
+#endif // PROCESS_TABLE_MODEL_H
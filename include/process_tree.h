@@ -0,0 +1,79 @@
+#ifndef PROCESS_TREE_H
+#define PROCESS_TREE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "process_info.h"
+
+struct ProcessTreeNode {
+    int pid;
+    int ppid;               // As reported by the kernel
+    int parent;             // Node this one hangs under; -1 while detached
+    std::string name;
+    uint64_t startTime;
+
+    // CPU is kept in thousandths of a percent so sums stay exact when
+    // deltas are added to and subtracted from ancestors
+    int64_t selfCpuMilli;
+    uint64_t selfRssBytes;
+    int64_t selfThreads;
+
+    // Aggregates over this node and all of its descendants
+    int64_t totalCpuMilli;
+    uint64_t totalRssBytes;
+    int64_t totalThreads;
+    int64_t totalProcesses;
+
+    std::vector<int> children;  // Unordered
+    size_t indexInParent;
+
+    uint64_t seenGeneration;
+    uint64_t changedGeneration;
+    uint64_t restructuredGeneration;
+};
+
+// Parent/child forest built from the ppid field of process snapshots, with
+// per-subtree CPU, RSS and thread totals. update() diffs a snapshot against
+// the current tree: a process whose values changed only walks its own
+// ancestor chain, and exits/reparenting only touch the affected chains.
+// All top-level processes hang under a virtual root with ROOT_PID.
+class ProcessTree {
+public:
+    static constexpr int ROOT_PID = 0;
+
+    ProcessTree();
+
+    // Apply a new snapshot, touching only the nodes it changes
+    void update(const std::vector<ProcessInfo>& snapshot);
+
+    const ProcessTreeNode* find(int pid) const;
+    size_t size() const;
+
+    // Nodes whose own or aggregated values changed in the last update()
+    const std::vector<int>& getChangedPids() const;
+
+    // Nodes whose set of children changed in the last update()
+    const std::vector<int>& getRestructuredPids() const;
+
+    // Ancestor steps taken by the last update(), to show how local it was
+    uint64_t getLastPropagationSteps() const;
+
+private:
+    std::unordered_map<int, ProcessTreeNode> nodes;
+    uint64_t generation;
+    std::vector<int> changedPids;
+    std::vector<int> restructuredPids;
+    std::vector<int> pendingAttach;
+    std::vector<int> removedPids;
+    uint64_t propagationSteps;
+
+    void propagate(int pid, int64_t cpuMilli, int64_t rssBytes, int64_t threads, int64_t processes);
+    void attach(ProcessTreeNode& node);
+    void detach(ProcessTreeNode& node);
+    void markChanged(ProcessTreeNode& node);
+    void markRestructured(ProcessTreeNode& node);
+};
+
+#endif // PROCESS_TREE_H
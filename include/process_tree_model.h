@@ -0,0 +1,65 @@
+#ifndef PROCESS_TREE_MODEL_H
+#define PROCESS_TREE_MODEL_H
+
+#include <QAbstractItemModel>
+#include <unordered_map>
+#include <vector>
+#include "process_tree.h"
+
+// Tree model over ProcessTree. Children are fetched when a node is first
+// expanded, and only the fetched part of the tree is mirrored here, so a
+// refresh costs rows inserts/removes and dataChanged for visible nodes
+// whose subtree actually changed.
+class ProcessTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn,
+        PidColumn,
+        CpuColumn,
+        MemoryColumn,
+        ThreadsColumn,
+        ProcessesColumn,
+        OwnCpuColumn,
+        ColumnCount
+    };
+
+    explicit ProcessTreeModel(QObject *parent = nullptr);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setProcesses(const std::vector<ProcessInfo> &snapshot);
+
+    const ProcessTree &getTree() const;
+
+    // PID of an index, or -1
+    int pidOf(const QModelIndex &index) const;
+
+private:
+    struct VisibleNode {
+        int parent;
+        uint64_t startTime;
+        bool fetched;
+        std::vector<int> children;  // Sorted by PID
+    };
+
+    ProcessTree tree;
+    std::unordered_map<int, VisibleNode> visible;
+
+    QModelIndex indexOfPid(int pid, int column = 0) const;
+    std::vector<int> sortedChildren(int pid) const;
+    void removeStaleChildren(int pid);
+    void insertNewChildren(int pid);
+    void forgetSubtree(int pid);
+};
+
+#endif // PROCESS_TREE_MODEL_H
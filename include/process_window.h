@@ -0,0 +1,59 @@
+#ifndef PROCESS_WINDOW_H
+#define PROCESS_WINDOW_H
+
+#include <QWidget>
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTableView>
+#include <QTreeView>
+#include <QTabWidget>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <QPointer>
+#include <memory>
+#include "process_scanner.h"
+#include "process_table_model.h"
+#include "process_tree_model.h"
+
+class ProcessWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    // Scans come from the shared scanner and are only asked for while
+    // this page is shown
+    explicit ProcessWindow(ProcessScanner *scanner, QWidget *parent = nullptr);
+    ~ProcessWindow();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void refreshData();
+    void snapshotReady();
+    void filterProcesses(const QString& text);
+    void viewChanged(int index);
+
+private:
+    void setupUI();
+    void updateTable();
+    void updateTree();
+    void updateScanRequest();
+
+    QPointer<ProcessScanner> scanner;    // May go first when the main window is torn down
+    std::shared_ptr<const ProcessSnapshot> snapshot;
+    bool autoRefreshEnabled;
+    ProcessTableModel *processModel;
+    QTableView *processView;
+    ProcessTreeModel *treeModel;
+    QTreeView *treeView;
+    QTabWidget *tabWidget;
+    QLineEdit *filterEdit;
+    QPushButton *refreshButton;
+    QLabel *summaryLabel;
+    QLabel *lastUpdateLabel;
+};
+
+#endif // PROCESS_WINDOW_H
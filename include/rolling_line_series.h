@@ -0,0 +1,48 @@
+#ifndef ROLLING_LINE_SERIES_H
+#define ROLLING_LINE_SERIES_H
+
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QDateTimeAxis>
+#include <vector>
+
+QT_CHARTS_USE_NAMESPACE
+
+// A fixed-length window over line series that share one time axis. Each
+// tick appends one point per series and drops the oldest one instead of
+// clearing and re-appending the whole history point by point, which grew
+// with the square of the length. The cost still grows linearly, because
+// Qt Charts rebuilds the geometry of the whole line after every change
+// (a single replace() per tick costs the same), so the capacity is what
+// bounds it: about 25 ms at MemoryWindow's 1,500 points, see
+// bench/README.md.
+class RollingLineSeries {
+public:
+    explicit RollingLineSeries(int capacity);
+
+    // Series are updated in the order they are added
+    void addSeries(QLineSeries *series);
+    void setTimeAxis(QDateTimeAxis *axis);
+
+    // Also drop points older than this much before the newest one and keep
+    // the time axis at exactly that span; 0 trims by count only
+    void setWindowMsecs(qint64 msecs);
+
+    // Append one value per series at the given time and move the time axis
+    void append(qint64 msecsSinceEpoch, const std::vector<double> &values);
+
+    // Replace all points at once, e.g. to restore a saved history
+    void replace(const QVector<qint64> &times, const std::vector<QVector<double>> &values);
+
+    int size() const;
+    int capacity() const;
+
+private:
+    void updateTimeAxis();
+
+    int maxPoints;
+    qint64 windowMsecs;
+    std::vector<QLineSeries*> series;
+    QDateTimeAxis *timeAxis;
+};
+
+#endif // ROLLING_LINE_SERIES_H
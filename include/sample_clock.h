@@ -0,0 +1,28 @@
+#ifndef SAMPLE_CLOCK_H
+#define SAMPLE_CLOCK_H
+
+#include <cstdint>
+
+// Timestamps for samples. Samples are stamped with CLOCK_BOOTTIME, which
+// never jumps when NTP steps the wall clock or the timezone changes, and
+// unlike CLOCK_MONOTONIC keeps counting through suspend, so an offset maps
+// it to wall-clock time. Only drawing and the saved history need wall-clock
+// times, and they convert at that point.
+//
+// The offset is checked on every conversion but only taken over when the
+// wall clock has moved more than a second against boot time, as when NTP
+// steps it after a boot without a battery-backed clock. Slewing and read
+// jitter leave it alone, so times converted during a run stay consistent.
+// After a step, samples of the same boot convert to the corrected time,
+// and saved history gets correct times from then on. Samples saved before
+// the step keep their old times; after a backward step, TimeSeries drops
+// new points until the wall clock passes the last saved one.
+class SampleClock {
+public:
+    static int64_t nowNs();
+
+    static double toSeconds(int64_t ns);
+    static int64_t toWallMsecs(int64_t ns);
+};
+
+#endif // SAMPLE_CLOCK_H
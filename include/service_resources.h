@@ -0,0 +1,76 @@
+#ifndef SERVICE_RESOURCES_H
+#define SERVICE_RESOURCES_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include "sysfs_file.h"
+
+struct ServiceResources {
+    bool available;             // False until sampled, or when the unit has no cgroup
+    double cpuPercent;          // Of one CPU, between the last two samples
+    uint64_t memoryBytes;       // memory.current
+    uint64_t tasks;             // pids.current
+    double ioReadBytesPerSec;   // Summed over all devices in io.stat
+    double ioWriteBytesPerSec;
+};
+
+// Per-unit resource accounting for running services, read from each unit's
+// cgroup under system.slice. Like CgroupInfoCollector, the accounting files
+// are opened relative to a directory descriptor on every sample rather than
+// held open, so only system.slice itself keeps a descriptor however many
+// units run. Units that are not running cost nothing.
+class ServiceResourceCollector {
+public:
+    ServiceResourceCollector();
+    ~ServiceResourceCollector();
+
+    ServiceResourceCollector(const ServiceResourceCollector&) = delete;
+    ServiceResourceCollector& operator=(const ServiceResourceCollector&) = delete;
+
+    // False when no cgroup2 hierarchy with a system.slice is mounted
+    bool isAvailable() const;
+
+    // Track exactly these units: the cgroups of new units are looked up,
+    // units that are no longer listed are dropped
+    void setRunningUnits(const std::vector<std::string>& units);
+
+    // Re-read the accounting files of all tracked units
+    void sample();
+
+    // Resources of a tracked unit, nullptr if the unit is not tracked
+    const ServiceResources* find(const std::string& unit) const;
+
+    const std::vector<std::string>& getTrackedUnits() const;
+    double getLastSampleDurationMs() const;
+
+private:
+    struct Unit {
+        std::string relativePath;   // Below system.slice
+        bool resolved;              // The unit's cgroup was found
+        ServiceResources resources;
+
+        // Previous cumulative values for rates
+        bool hasPrevious;
+        uint64_t lastCpuUsageUsec;
+        uint64_t lastIoReadBytes;
+        uint64_t lastIoWriteBytes;
+    };
+
+    int sliceFd;
+    std::unordered_map<std::string, Unit> units;
+    std::vector<std::string> trackedUnits;
+    std::vector<char> readBuffer;
+    std::chrono::steady_clock::time_point lastSampleTime;
+    bool hasPreviousSample;
+    double lastSampleDurationMs;
+
+    // Helper methods
+    bool resolveUnit(const std::string& name, Unit& unit) const;
+    SysfsFile openFile(const Unit& unit, const char* name) const;
+    void readUnit(Unit& unit, double elapsedSeconds);
+};
+
+#endif // SERVICE_RESOURCES_H
@@ -12,7 +12,10 @@
 #include <QTimer>
 #include <QComboBox>
 #include <QTextEdit>
+#include <QHash>
 #include "service_info.h"
+#include "service_resources.h"
+#include "deadline_timer.h"
 
 class ServiceWindow : public QWidget {
     Q_OBJECT
@@ -23,6 +26,7 @@ public:
 
 private slots:
     void refreshData();
+    void updateResources();
     void filterServices(const QString& text);
     void serviceSelected(int row, int column);
     void startSelectedService();
@@ -32,12 +36,29 @@ private slots:
     void disableSelectedService();
 
 private:
+    enum Column {
+        NameColumn,
+        DescriptionColumn,
+        StatusColumn,
+        SubStateColumn,
+        CpuColumn,
+        MemoryColumn,
+        TasksColumn,
+        IoReadColumn,
+        IoWriteColumn,
+        ColumnCount
+    };
+
     void setupUI();
     void updateTable();
+    void updateTrackedUnits();
+    void setResourceCells(int row, const ServiceResources *resources);
+    QString formatSize(uint64_t bytes) const;
     void updateServiceDetails(const ServiceInfo& service);
     void showMessage(const QString& message, bool isError = false);
 
     ServiceInfoCollector serviceInfo;
+    ServiceResourceCollector serviceResources;
     QTableWidget *serviceTable;
     QLineEdit *filterEdit;
     QPushButton *refreshButton;
@@ -49,8 +70,10 @@ private:
     QLabel *statusLabel;
     QLabel *lastUpdateLabel;
     QTimer *autoRefreshTimer;
+    DeadlineTimer *resourceTimer;
     QTextEdit *detailsTextEdit;
 
+    QHash<QString, QTableWidgetItem*> nameItems;   // By unit name, rows move on sort
     std::string selectedService;
 };
 
@@ -0,0 +1,86 @@
+#ifndef SMAPS_SAMPLER_H
+#define SMAPS_SAMPLER_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include "process_info.h"
+
+struct SmapsRollupInfo {
+    int pid;
+    std::string name;
+    uint64_t rssBytes;          // From the latest process scan
+    uint64_t pssBytes;          // Shared pages split between their users
+    uint64_t ussBytes;          // Private_Clean + Private_Dirty
+    uint64_t swapBytes;
+    uint64_t swapPssBytes;
+    double ageSeconds;          // Since smaps_rollup was last read
+};
+
+// PSS, USS and swap per process from /proc/<pid>/smaps_rollup. Each read
+// makes the kernel walk the page tables of the whole process, so only as
+// many processes are read per update as fit in a time budget; everything
+// else keeps its cached values. Processes are picked by RSS times the age
+// of their cached values, so large processes come round more often but
+// every process is reached eventually, and unsampled ones go first.
+class SmapsSampler {
+public:
+    static constexpr double DEFAULT_BUDGET_MS = 25.0;
+
+    explicit SmapsSampler(double budgetMs = DEFAULT_BUDGET_MS);
+    ~SmapsSampler();
+
+    SmapsSampler(const SmapsSampler&) = delete;
+    SmapsSampler& operator=(const SmapsSampler&) = delete;
+
+    void setBudgetMs(double budgetMs);
+    double getBudgetMs() const;
+
+    // Spend up to the budget, bookkeeping included, re-reading processes of
+    // this snapshot, which must be sorted by PID as returned by
+    // ProcessInfoCollector
+    void update(const std::vector<ProcessInfo>& processes);
+
+    // Sampled processes with the largest PSS, largest first
+    std::vector<SmapsRollupInfo> getTopConsumers(size_t count) const;
+
+    // Statistics of the last update
+    size_t getLastSampleCount() const;
+    double getLastSampleDurationMs() const;
+    size_t getSampledCount() const;     // Processes with cached values
+    size_t getProcessCount() const;
+
+private:
+    struct Entry {
+        int pid;
+        uint64_t startTime;
+        uint64_t rssBytes;
+        std::string name;
+
+        bool sampled;
+        bool denied;            // Not ours to read; never retried
+        uint64_t pssBytes;
+        uint64_t ussBytes;
+        uint64_t swapBytes;
+        uint64_t swapPssBytes;
+        std::chrono::steady_clock::time_point sampledAt;
+    };
+
+    double budgetMs;
+    int procFd;
+    std::vector<char> readBuffer;
+    std::vector<Entry> entries;         // Sorted by PID
+    std::vector<Entry> previousEntries;
+    std::vector<std::pair<double, size_t>> candidates;
+    double averageReadMs;               // Running average cost of one read
+    size_t lastSampleCount;
+    double lastSampleDurationMs;
+    size_t sampledCount;
+
+    // Helper methods
+    bool readRollup(Entry& entry);
+};
+
+#endif // SMAPS_SAMPLER_H
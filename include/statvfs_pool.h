@@ -0,0 +1,110 @@
+#ifndef STATVFS_POOL_H
+#define STATVFS_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Latest statvfs() answer for one mount, and the state of the call after it
+struct StatvfsResult {
+    bool valid;                 // At least one answer has arrived
+    int error;                  // errno of the latest answer, 0 on success
+    uint64_t totalSize;
+    uint64_t freeSpace;
+    uint64_t availableSpace;
+    int64_t sampledNs;          // SampleClock time of the latest answer
+    bool pending;               // A call is queued or running
+    int64_t queuedNs;           // When the pending call was queued
+    int64_t startedNs;          // When a worker began the pending call, 0 while queued
+};
+
+// Runs statvfs() on a few worker threads so that a hung NFS or CIFS server
+// cannot block the caller. A call into a dead server sleeps in the kernel
+// until the server comes back and cannot be cancelled, so a mount never has
+// more than one call pending: it keeps its worker, further requests for it
+// are ignored, and its answer, whenever it arrives, is how recovery shows.
+// Mount IDs are reused as soon as they are freed, so an entry also records
+// its path, and a request under a known ID for another path starts over.
+// Workers are added while none is idle, up to a limit, so a few hung mounts
+// do not hold up the others. A worker whose call has run longer than
+// stuckAfterNs no longer counts against that limit, so dead servers cannot
+// use it all up; such workers have a larger limit of their own, since each
+// is a thread that may never return.
+class StatvfsPool {
+public:
+    explicit StatvfsPool(size_t maxWorkers = 8, size_t maxStuckWorkers = 32,
+                         int64_t stuckAfterNs = 1000000000LL);
+    ~StatvfsPool();
+
+    StatvfsPool(const StatvfsPool&) = delete;
+    StatvfsPool& operator=(const StatvfsPool&) = delete;
+
+    // Queues a call unless one for this mount and path is still pending
+    void request(int mountId, const std::string& path);
+
+    // Blocks until every call queued since the last wait has answered or
+    // deadlineNs (SampleClock time) has passed
+    void wait(int64_t deadlineNs);
+
+    // False if the mount was never requested
+    bool getResult(int mountId, StatvfsResult& result) const;
+
+    // Drops the results of mounts that are gone; a call still running for
+    // one of them is discarded when it returns
+    void retain(const std::unordered_set<int>& mountIds);
+
+    size_t getWorkerCount() const;
+    size_t getStuckWorkerCount() const;
+
+private:
+    struct Entry {
+        StatvfsResult result;
+        std::string path;
+        uint64_t ticket;            // Identifies the pending call, mount IDs are reused
+    };
+
+    struct Job {
+        int mountId;
+        uint64_t ticket;
+        uint64_t batch;
+        std::string path;
+    };
+
+    // Shared with the workers, which are detached: one stuck in a hung
+    // mount cannot be joined, and must not keep the caller from exiting
+    struct State {
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable batchDone;
+        std::unordered_map<int, Entry> entries;
+        std::deque<Job> queue;
+        uint64_t nextTicket = 1;
+        uint64_t batch = 0;
+        size_t batchRemaining = 0;
+        size_t workers = 0;
+        size_t idleWorkers = 0;
+        size_t maxWorkers = 0;                          // Not counting stuck ones
+        size_t maxStuckWorkers = 0;
+        int64_t stuckAfterNs = 0;
+        std::unordered_map<uint64_t, int64_t> running;  // Start time by ticket
+        bool stopping = false;
+    };
+
+    // Called with the mutex held
+    static void work(std::shared_ptr<State> state);
+    static void finishJob(State& state, const Job& job);
+    static void startWorkers(const std::shared_ptr<State>& state);
+    static size_t stuckWorkers(const State& state, int64_t now);
+
+    std::shared_ptr<State> state;
+};
+
+#endif // STATVFS_POOL_H
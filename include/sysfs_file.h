@@ -0,0 +1,39 @@
+#ifndef SYSFS_FILE_H
+#define SYSFS_FILE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+
+// Keeps a sysfs/procfs attribute open so that repeated samples cost a single
+// pread() from offset 0 instead of an open/read/close round trip.
+class SysfsFile {
+public:
+    SysfsFile() = default;
+    explicit SysfsFile(const std::string& path);
+    SysfsFile(int dirFd, const char* name);
+    ~SysfsFile();
+
+    SysfsFile(SysfsFile&& other) noexcept;
+    SysfsFile& operator=(SysfsFile&& other) noexcept;
+    SysfsFile(const SysfsFile&) = delete;
+    SysfsFile& operator=(const SysfsFile&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+    int descriptor() const { return fd; }
+    void close();
+
+    // Read the whole attribute into buffer (NUL terminated), returns length or -1
+    ssize_t read(char* buffer, size_t size) const;
+
+    // Convenience readers for single-value attributes
+    bool readUInt64(uint64_t& value) const;
+    bool readInt64(int64_t& value) const;
+    std::string readString() const;
+
+private:
+    int fd = -1;
+};
+
+#endif // SYSFS_FILE_H
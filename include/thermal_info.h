@@ -0,0 +1,84 @@
+#ifndef THERMAL_INFO_H
+#define THERMAL_INFO_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <cstdint>
+#include "sysfs_file.h"
+
+struct TemperatureSensor {
+    std::string chip;      // hwmon "name" or thermal zone "type"
+    std::string label;     // tempN_label, or the zone directory name
+    std::string source;    // "hwmon" or "thermal"
+    double temperatureC;
+    double criticalC;      // 0 when the sensor exposes no critical trip
+    bool valid;
+};
+
+struct ThrottleInfo {
+    int cpu;
+    int packageId;
+    uint64_t coreThrottleCount;
+    uint64_t packageThrottleCount;
+};
+
+struct ThrottleRateSample {
+    std::chrono::steady_clock::time_point timestamp;
+    double coreEventsPerSec;
+    double packageEventsPerSec;
+};
+
+class ThermalInfoCollector {
+public:
+    ThermalInfoCollector();
+
+    // Get the latest readings
+    std::vector<TemperatureSensor> getSensors() const;
+    std::vector<ThrottleInfo> getThrottleInfo() const;
+    const std::deque<ThrottleRateSample>& getThrottleHistory() const;
+    bool hasThrottleCounters() const;
+
+    // Totals across all CPUs (package counters counted once per package)
+    uint64_t getTotalCoreThrottleCount() const;
+    uint64_t getTotalPackageThrottleCount() const;
+
+    // Re-read all sensors through the descriptors opened at discovery
+    void refresh();
+
+    // Print thermal information
+    void printAllInfo() const;
+
+private:
+    struct SensorHandle {
+        TemperatureSensor info;
+        SysfsFile input;
+    };
+
+    struct ThrottleHandle {
+        ThrottleInfo info;
+        SysfsFile coreCount;
+        SysfsFile packageCount;
+        bool firstInPackage;
+    };
+
+    std::vector<SensorHandle> sensors;
+    std::vector<ThrottleHandle> throttles;
+    std::deque<ThrottleRateSample> throttleHistory;
+
+    uint64_t lastCoreTotal;
+    uint64_t lastPackageTotal;
+    std::chrono::steady_clock::time_point lastSampleTime;
+    bool hasPreviousSample;
+
+    static const size_t MAX_HISTORY_SIZE = 150;
+
+    // Discovery runs once; refresh() only reads already-open descriptors
+    void discoverHwmonSensors();
+    void discoverThermalZones();
+    void discoverThrottleCounters();
+    std::string readFileContent(const std::string& filePath) const;
+};
+
+#endif // THERMAL_INFO_H
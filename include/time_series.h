@@ -0,0 +1,140 @@
+#ifndef TIME_SERIES_H
+#define TIME_SERIES_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+enum class TimeSeriesTier {
+    RAW,
+    MINUTE,
+    HOUR
+};
+
+// One raw sample, or the aggregate of all samples in a bucket
+struct TimeSeriesPoint {
+    int64_t timeMs;     // Sample time, or bucket start
+    double min;
+    double max;
+    double avg;
+    double last;
+    uint32_t count;     // Samples aggregated (1 for raw)
+};
+
+// Round-robin archive for one metric: raw samples for a short window,
+// downsampled into 1-minute and 1-hour min/max/avg/last buckets for
+// longer ones. All three tiers are fixed-size rings allocated up front,
+// so memory per series does not grow with uptime; with the defaults it is
+// under 300 KB for 30 days.
+//
+// The rings live in one block laid out like the file written by
+// attachFile(), so a series can be moved onto a memory-mapped file and
+// reopened later without parsing anything.
+class TimeSeries {
+public:
+    struct Config {
+        size_t rawCapacity = 3600;      // 10 hours at 10 s, 1 hour at 1 s
+        size_t minuteCapacity = 1440;   // 1 day
+        size_t hourCapacity = 720;      // 30 days
+    };
+
+    static const int64_t MINUTE_MS = 60 * 1000;
+    static const int64_t HOUR_MS = 60 * MINUTE_MS;
+
+    TimeSeries();
+    explicit TimeSeries(const Config& config);
+    ~TimeSeries();
+
+    TimeSeries(const TimeSeries&) = delete;
+    TimeSeries& operator=(const TimeSeries&) = delete;
+
+    // Continue the history kept in a ring file, creating it if needed. The
+    // file is mapped shared, so samples reach it without write() calls and
+    // survive a crash of the process; nothing is fsynced. A file with other
+    // capacities or a damaged header is started afresh. If another process
+    // holds the file, its history is shown and continued in memory only,
+    // through a private mapping. Returns false
+    // and keeps the in-memory history if the file cannot be used.
+    bool attachFile(const std::string& path);
+    bool isPersistent() const;
+
+    // Samples must arrive in time order; older ones are dropped
+    void append(int64_t timeMs, double value);
+
+    bool isEmpty() const;
+    int64_t getLastTime() const;
+    double getLastValue() const;
+
+    // Oldest time still held by a tier
+    int64_t getOldestTime(TimeSeriesTier tier) const;
+
+    // Finest tier that still covers fromMs and returns at most maxPoints
+    // points for [fromMs, toMs]; the coarsest tier if none qualifies
+    TimeSeriesTier tierFor(int64_t fromMs, int64_t toMs, size_t maxPoints) const;
+
+    // Points of a tier in [fromMs, toMs], oldest first. Coarser tiers end
+    // with the bucket that is still filling.
+    std::vector<TimeSeriesPoint> range(TimeSeriesTier tier, int64_t fromMs, int64_t toMs) const;
+
+    // Completed buckets so far; changes when a coarse tier gains a point
+    uint64_t getBucketCount(TimeSeriesTier tier) const;
+
+    size_t memoryBytes() const;
+
+private:
+    static const int TIER_COUNT = 3;
+
+    struct Ring {
+        uint64_t head;          // Index of the oldest point
+        uint64_t count;
+    };
+
+    struct Bucket {
+        uint64_t open;
+        TimeSeriesPoint point;
+        double sum;
+        uint64_t completed;
+    };
+
+    // Everything an append changes besides the point slots. The block
+    // holds two copies; each append writes the older one, so a crash
+    // mid-update leaves the other intact. Each ring has one slot more than
+    // its capacity, and a push only writes the slot outside the published
+    // state, so the points that state covers are intact as well
+    struct State {
+        uint64_t sequence;
+        Ring rings[TIER_COUNT];
+        Bucket buckets[TIER_COUNT - 1];     // MINUTE and HOUR
+        uint64_t checksum;
+    };
+
+    struct Header;
+
+    size_t capacities[TIER_COUNT];
+    State state;                        // Working copy of the newest state
+    Header* header;
+    TimeSeriesPoint* tiers[TIER_COUNT];
+    std::vector<char> memory;           // Backing block unless mapped
+    void* mapping;
+    int mappingFd;                      // Holds the writer lock
+    bool writable;
+
+    // Helper methods
+    size_t blockSize() const;
+    size_t slotsOf(int index) const;        // Capacity plus the spare slot
+    void initializeBlock(char* block);
+    void useBlock(char* block);
+    bool loadState();
+    void publishState();
+    void releaseMapping();
+
+    void push(TimeSeriesTier tier, const TimeSeriesPoint& point);
+    const TimeSeriesPoint& at(TimeSeriesTier tier, size_t index) const;
+    size_t lowerBound(TimeSeriesTier tier, int64_t timeMs) const;
+    void addToBucket(TimeSeriesTier tier, int64_t intervalMs, int64_t timeMs, double value);
+    const Bucket* bucketOf(TimeSeriesTier tier) const;
+    size_t sizeOf(TimeSeriesTier tier) const;
+};
+
+#endif // TIME_SERIES_H
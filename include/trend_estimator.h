@@ -0,0 +1,63 @@
+#ifndef TREND_ESTIMATOR_H
+#define TREND_ESTIMATOR_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Least squares line over the samples in the window, extrapolated to a limit
+struct TrendForecast {
+    bool valid;                 // Enough samples for a fit
+    bool approaching;           // Slope significantly towards the limit
+    double slope;               // Units per second
+    double rSquared;            // How well the line explains the window
+
+    // From the latest sample, with the slope at its estimate and at the
+    // edges of its ~95% interval; infinity when not approaching
+    double secondsToLimit;
+    double earliestSeconds;
+    double latestSeconds;
+};
+
+// Sliding-window linear regression of value over time. The window keeps the
+// last capacity samples in a ring and running sums of t, v, t*t, t*v and v*v,
+// so adding a sample or asking for a forecast is O(1) however long the window
+// is. Sums are kept relative to an origin inside the window and recomputed
+// from the ring each time it has turned over once, so rounding error from
+// subtracting evicted samples cannot build up; amortized, that is still a
+// constant cost per sample.
+class TrendEstimator {
+public:
+    explicit TrendEstimator(size_t capacity);
+
+    void add(double seconds, double value);
+    void clear();
+    size_t size() const;
+
+    // When the fitted line reaches limit, from above or below
+    TrendForecast forecast(double limit) const;
+
+    // "40 s", "45 min", "3.2 h", "4.5 d"
+    static std::string formatDuration(double seconds);
+
+private:
+    std::vector<double> times;
+    std::vector<double> values;
+    size_t head;                // Next slot to write
+    size_t count;
+    size_t addsSinceResum;
+
+    double timeOrigin;
+    double valueOrigin;
+    double sumT;
+    double sumV;
+    double sumTT;
+    double sumTV;
+    double sumVV;
+
+    // Helper methods
+    void accumulate(double seconds, double value, double sign);
+    void resum();
+};
+
+#endif // TREND_ESTIMATOR_H
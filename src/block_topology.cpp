@@ -0,0 +1,394 @@
+#include "block_topology.h"
+#include "sysfs_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+
+namespace {
+
+const char* const CLASS_BLOCK_PATH = "/sys/class/block";
+
+// Uevent messages are a few hundred bytes; a hot-plugged disk sends dozens
+const size_t RECEIVE_BUFFER_SIZE = 8 * 1024;
+const int SOCKET_BUFFER_SIZE = 1024 * 1024;
+
+// Kernel uevents, as opposed to the ones udev re-broadcasts on group 2
+const unsigned int KERNEL_UEVENT_GROUP = 1;
+
+// Matched with its terminating NUL, so "SUBSYSTEM=block_foo" does not count
+const char BLOCK_SUBSYSTEM[] = "SUBSYSTEM=block";
+
+// Below these, on the devices they apply to, throughput usually suffers
+const int64_t MIN_ROTATIONAL_READ_AHEAD_KB = 128;
+const int64_t MIN_MAX_SECTORS_KB = 512;
+const int64_t MIN_NR_REQUESTS = 32;
+
+uint64_t deviceNumber(unsigned int major, unsigned int minor) {
+    return static_cast<uint64_t>(major) << 32 | minor;
+}
+
+bool startsWith(const std::string& text, const char* prefix) {
+    return text.compare(0, strlen(prefix), prefix) == 0;
+}
+
+// Entry names of a subdirectory such as holders/ or slaves/
+std::vector<std::string> listDirectory(int parentFd, const char* name) {
+    std::vector<std::string> names;
+    int fd = openat(parentFd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return names;
+    }
+    DIR* dir = fdopendir(fd);
+    if (!dir) {
+        close(fd);
+        return names;
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+int64_t readNumber(int dirFd, const char* name) {
+    int64_t value = -1;
+    SysfsFile file(dirFd, name);
+    return file.readInt64(value) ? value : -1;
+}
+
+} // namespace
+
+BlockTopologyCollector::BlockTopologyCollector()
+    : ueventFd(-1),
+      stale(true),
+      receiveBuffer(RECEIVE_BUFFER_SIZE),
+      rebuildCount(0) {
+
+    // Without uevents every refresh rebuilds
+    ueventFd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (ueventFd < 0) {
+        return;
+    }
+
+    int bufferSize = SOCKET_BUFFER_SIZE;
+    setsockopt(ueventFd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    sockaddr_nl address;
+    std::memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = KERNEL_UEVENT_GROUP;
+    address.nl_pid = 0;     // Let the kernel assign a port id
+
+    if (bind(ueventFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(ueventFd);
+        ueventFd = -1;
+    }
+}
+
+BlockTopologyCollector::~BlockTopologyCollector() {
+    if (ueventFd >= 0) {
+        close(ueventFd);
+    }
+}
+
+bool BlockTopologyCollector::isWatching() const {
+    return ueventFd >= 0;
+}
+
+const std::vector<BlockDevice>& BlockTopologyCollector::getDevices() const {
+    return devices;
+}
+
+const BlockDevice* BlockTopologyCollector::findByName(const std::string& name) const {
+    auto it = indexByName.find(name);
+    return it != indexByName.end() ? &devices[it->second] : nullptr;
+}
+
+const BlockDevice* BlockTopologyCollector::findByNumber(unsigned int major, unsigned int minor) const {
+    auto it = indexByNumber.find(deviceNumber(major, minor));
+    return it != indexByNumber.end() ? &devices[it->second] : nullptr;
+}
+
+std::vector<const BlockDevice*> BlockTopologyCollector::getLowerDevices(const BlockDevice& device) const {
+    std::vector<const BlockDevice*> lower;
+    for (const std::string& name : device.slaves) {
+        if (const BlockDevice* slave = findByName(name)) {
+            lower.push_back(slave);
+        }
+    }
+    if (!device.parent.empty()) {
+        if (const BlockDevice* disk = findByName(device.parent)) {
+            lower.push_back(disk);
+        }
+    }
+    return lower;
+}
+
+size_t BlockTopologyCollector::getIssueCount() const {
+    size_t count = 0;
+    for (const BlockDevice& device : devices) {
+        count += device.issues.size();
+    }
+    return count;
+}
+
+uint64_t BlockTopologyCollector::getRebuildCount() const {
+    return rebuildCount;
+}
+
+bool BlockTopologyCollector::refresh() {
+    if (drainUevents() || stale || ueventFd < 0) {
+        rebuild();
+        stale = false;
+        return true;
+    }
+    return false;
+}
+
+bool BlockTopologyCollector::drainUevents() {
+    if (ueventFd < 0) {
+        return false;
+    }
+
+    // "add@/devices/.../block/sdb\0ACTION=add\0DEVPATH=...\0SUBSYSTEM=block\0..."
+    bool blockEvent = false;
+    for (;;) {
+        ssize_t length = recv(ueventFd, receiveBuffer.data(), receiveBuffer.size(), 0);
+        if (length < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Events were lost, so anything may have changed
+            if (errno == ENOBUFS) {
+                blockEvent = true;
+                continue;
+            }
+            break;
+        }
+
+        const char* end = receiveBuffer.data() + length;
+        for (const char* field = receiveBuffer.data(); field < end; field += strnlen(field, end - field) + 1) {
+            if (static_cast<size_t>(end - field) >= sizeof(BLOCK_SUBSYSTEM) &&
+                memcmp(field, BLOCK_SUBSYSTEM, sizeof(BLOCK_SUBSYSTEM)) == 0) {
+                blockEvent = true;
+                break;
+            }
+        }
+    }
+    return blockEvent;
+}
+
+void BlockTopologyCollector::rebuild() {
+    devices.clear();
+    indexByName.clear();
+    indexByNumber.clear();
+    rebuildCount++;
+
+    DIR* dir = opendir(CLASS_BLOCK_PATH);
+    if (!dir) {
+        return;
+    }
+    int classFd = dirfd(dir);
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        BlockDevice device{};
+        readDevice(classFd, entry->d_name, device);
+        devices.push_back(std::move(device));
+    }
+    closedir(dir);
+
+    std::sort(devices.begin(), devices.end(),
+              [](const BlockDevice& a, const BlockDevice& b) { return a.name < b.name; });
+    for (size_t i = 0; i < devices.size(); ++i) {
+        indexByName[devices[i].name] = i;
+        indexByNumber[deviceNumber(devices[i].major, devices[i].minor)] = i;
+    }
+
+    // Stacked devices are compared with the devices below them, so every
+    // queue must be read first
+    for (BlockDevice& device : devices) {
+        audit(device);
+    }
+}
+
+void BlockTopologyCollector::refreshQueueSettings() {
+    int classFd = open(CLASS_BLOCK_PATH, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (classFd < 0) {
+        return;
+    }
+    for (BlockDevice& device : devices) {
+        if (!device.queue.available) {
+            continue;
+        }
+        int deviceFd = openat(classFd, device.name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (deviceFd >= 0) {
+            readQueue(deviceFd, device.queue);
+            close(deviceFd);
+        }
+    }
+    close(classFd);
+
+    for (BlockDevice& device : devices) {
+        audit(device);
+    }
+}
+
+void BlockTopologyCollector::readDevice(int classFd, const char* name, BlockDevice& device) {
+    device.name = name;
+    device.queue.available = false;
+
+    int deviceFd = openat(classFd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (deviceFd < 0) {
+        return;
+    }
+
+    std::string number = SysfsFile(deviceFd, "dev").readString();
+    sscanf(number.c_str(), "%u:%u", &device.major, &device.minor);
+    int64_t sectors = readNumber(deviceFd, "size");
+    device.sizeBytes = sectors > 0 ? static_cast<uint64_t>(sectors) * 512 : 0;
+
+    device.slaves = listDirectory(deviceFd, "slaves");
+    device.holders = listDirectory(deviceFd, "holders");
+
+    // ".../block/sda/sda1": the disk is the directory above the partition
+    if (faccessat(deviceFd, "partition", F_OK, 0) == 0) {
+        device.kind = "partition";
+        char link[4096];
+        ssize_t length = readlinkat(classFd, name, link, sizeof(link) - 1);
+        if (length > 0) {
+            std::string path(link, length);
+            size_t last = path.rfind('/');
+            size_t previous = last != std::string::npos && last > 0 ? path.rfind('/', last - 1) : std::string::npos;
+            if (previous != std::string::npos) {
+                device.parent = path.substr(previous + 1, last - previous - 1);
+            }
+        }
+        close(deviceFd);
+        return;
+    }
+
+    std::string dmUuid = SysfsFile(deviceFd, "dm/uuid").readString();
+    std::string mdLevel = SysfsFile(deviceFd, "md/level").readString();
+    if (faccessat(deviceFd, "dm", F_OK, 0) == 0) {
+        device.label = SysfsFile(deviceFd, "dm/name").readString();
+        if (startsWith(dmUuid, "CRYPT-")) {
+            device.kind = "crypt";
+        } else if (startsWith(dmUuid, "LVM-")) {
+            device.kind = "lvm";
+        } else if (startsWith(dmUuid, "mpath-")) {
+            device.kind = "multipath";
+        } else {
+            device.kind = "dm";
+        }
+    } else if (!mdLevel.empty()) {
+        device.kind = mdLevel;
+    } else if (startsWith(device.name, "loop")) {
+        device.kind = "loop";
+    } else {
+        device.kind = "disk";
+    }
+
+    readQueue(deviceFd, device.queue);
+    close(deviceFd);
+}
+
+void BlockTopologyCollector::readQueue(int deviceFd, BlockQueueSettings& queue) {
+    int queueFd = openat(deviceFd, "queue", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (queueFd < 0) {
+        queue.available = false;
+        return;
+    }
+
+    // "mq-deadline kyber [bfq] none"; stacked devices only offer "none"
+    queue.available = true;
+    queue.schedulers = SysfsFile(queueFd, "scheduler").readString();
+    size_t selected = queue.schedulers.find('[');
+    size_t selectedEnd = queue.schedulers.find(']', selected);
+    queue.scheduler = selected != std::string::npos && selectedEnd != std::string::npos
+        ? queue.schedulers.substr(selected + 1, selectedEnd - selected - 1)
+        : queue.schedulers;
+
+    queue.nrRequests = readNumber(queueFd, "nr_requests");
+    queue.readAheadKb = readNumber(queueFd, "read_ahead_kb");
+    queue.maxSectorsKb = readNumber(queueFd, "max_sectors_kb");
+    queue.maxHwSectorsKb = readNumber(queueFd, "max_hw_sectors_kb");
+    queue.rotational = static_cast<int>(readNumber(queueFd, "rotational"));
+    queue.writeCache = SysfsFile(queueFd, "write_cache").readString();
+    close(queueFd);
+}
+
+const BlockQueueSettings* BlockTopologyCollector::effectiveQueue(const BlockDevice& device) const {
+    if (device.queue.available) {
+        return &device.queue;
+    }
+    const BlockDevice* disk = device.parent.empty() ? nullptr : findByName(device.parent);
+    return disk && disk->queue.available ? &disk->queue : nullptr;
+}
+
+void BlockTopologyCollector::audit(BlockDevice& device) {
+    device.issues.clear();
+    const BlockQueueSettings& queue = device.queue;
+    if (!queue.available) {
+        return;
+    }
+
+    // Stacked devices pass requests on and have no scheduler of their own
+    bool stacked = !device.slaves.empty();
+    char text[256];
+
+    if (!stacked && queue.rotational == 0 && (queue.scheduler == "bfq" || queue.scheduler == "cfq")) {
+        snprintf(text, sizeof(text), "%s costs CPU time on every request of a non-rotational device; "
+                 "none or mq-deadline keep up better", queue.scheduler.c_str());
+        device.issues.push_back(text);
+    }
+    if (!stacked && queue.rotational == 1 && queue.scheduler == "none") {
+        device.issues.push_back("No scheduler on a rotational disk, so requests are neither merged nor "
+                                "sorted; mq-deadline or bfq avoid extra seeks");
+    }
+    if (queue.rotational == 1 && queue.readAheadKb >= 0 && queue.readAheadKb < MIN_ROTATIONAL_READ_AHEAD_KB) {
+        snprintf(text, sizeof(text), "read_ahead_kb %lld is low for a rotational device; sequential reads "
+                 "take more seeks", static_cast<long long>(queue.readAheadKb));
+        device.issues.push_back(text);
+    }
+    if (queue.maxSectorsKb > 0 && queue.maxSectorsKb < queue.maxHwSectorsKb &&
+        queue.maxSectorsKb < MIN_MAX_SECTORS_KB) {
+        snprintf(text, sizeof(text), "max_sectors_kb %lld is below the hardware limit of %lld; large I/O is "
+                 "split into more requests", static_cast<long long>(queue.maxSectorsKb),
+                 static_cast<long long>(queue.maxHwSectorsKb));
+        device.issues.push_back(text);
+    }
+    if (!stacked && queue.scheduler != "none" && queue.nrRequests > 0 && queue.nrRequests < MIN_NR_REQUESTS) {
+        snprintf(text, sizeof(text), "nr_requests %lld leaves the scheduler little to merge and reorder",
+                 static_cast<long long>(queue.nrRequests));
+        device.issues.push_back(text);
+    }
+    if (!stacked && queue.rotational == 1 && queue.writeCache == "write through") {
+        device.issues.push_back("Write cache is off, so every write waits for the media");
+    }
+
+    // A stacked device reads ahead by its own setting, not by its members'
+    int64_t lowerReadAheadKb = -1;
+    for (const BlockDevice* lower : getLowerDevices(device)) {
+        const BlockQueueSettings* lowerQueue = effectiveQueue(*lower);
+        if (lowerQueue) {
+            lowerReadAheadKb = std::max(lowerReadAheadKb, lowerQueue->readAheadKb);
+        }
+    }
+    if (stacked && queue.readAheadKb >= 0 && queue.readAheadKb < lowerReadAheadKb) {
+        snprintf(text, sizeof(text), "read_ahead_kb %lld is below the %lld of the devices below; reads "
+                 "through this device get the smaller value", static_cast<long long>(queue.readAheadKb),
+                 static_cast<long long>(lowerReadAheadKb));
+        device.issues.push_back(text);
+    }
+}
@@ -0,0 +1,225 @@
+#include "burst_sampler.h"
+#include "sample_clock.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <cerrno>
+
+namespace {
+
+// /proc/net/dev grows by about 130 bytes per interface
+const size_t READ_BUFFER_SIZE = 16 * 1024;
+
+// The aggregate "cpu" line and MemAvailable are both near the top, and a
+// short read still gets the whole line
+const size_t STAT_READ_SIZE = 256;
+const size_t MEMINFO_READ_SIZE = 256;
+
+const int64_t NSEC_PER_SEC = 1000000000;
+
+int64_t clockNs(clockid_t clock) {
+    timespec now;
+    clock_gettime(clock, &now);
+    return static_cast<int64_t>(now.tv_sec) * NSEC_PER_SEC + now.tv_nsec;
+}
+
+// "cpu  user nice system idle iowait irq softirq steal guest guest_nice"
+bool parseCpuLine(const char* text, uint64_t& busy, uint64_t& total) {
+    if (strncmp(text, "cpu ", 4) != 0) {
+        return false;
+    }
+    const char* p = text + 4;
+    uint64_t fields[8] = {};
+    for (int i = 0; i < 8; ++i) {
+        char* end = nullptr;
+        fields[i] = strtoull(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        p = end;
+    }
+
+    // Guest time is already part of user and nice
+    total = 0;
+    for (uint64_t field : fields) {
+        total += field;
+    }
+    busy = total - fields[3] - fields[4];
+    return true;
+}
+
+// Sum of receive and transmit bytes over all interfaces but lo
+void parseNetDev(const char* text, uint64_t& rx, uint64_t& tx) {
+    rx = 0;
+    tx = 0;
+
+    // "  eth0: rxbytes packets errs drop fifo frame compressed multicast txbytes ..."
+    for (const char* line = text; *line; ) {
+        const char* colon = strchr(line, ':');
+        const char* next = strchr(line, '\n');
+        if (colon && (!next || colon < next)) {
+            const char* name = line;
+            while (*name == ' ') {
+                ++name;
+            }
+            if (!(colon - name == 2 && strncmp(name, "lo", 2) == 0)) {
+                char* end = nullptr;
+                rx += strtoull(colon + 1, &end, 10);
+                for (int i = 0; i < 7; ++i) {
+                    strtoull(end, &end, 10);
+                }
+                tx += strtoull(end, &end, 10);
+            }
+        }
+        if (!next) {
+            break;
+        }
+        line = next + 1;
+    }
+}
+
+} // namespace
+
+BurstSampler::BurstSampler(size_t ringCapacity)
+    : statFile("/proc/stat"),
+      meminfoFile("/proc/meminfo"),
+      netDevFile("/proc/net/dev"),
+      buffer(READ_BUFFER_SIZE),
+      hasPrevious(false),
+      previousBusy(0),
+      previousTotal(0),
+      previousRx(0),
+      previousTx(0),
+      previousTimeNs(0),
+      ring(ringCapacity),
+      running(false),
+      samples(0),
+      dropped(0),
+      missedDeadlines(0),
+      threadCpuNs(0) {
+}
+
+BurstSampler::~BurstSampler() {
+    stop();
+}
+
+bool BurstSampler::start(int64_t intervalNs) {
+    stop();
+    if (intervalNs <= 0 || !statFile.isOpen()) {
+        return false;
+    }
+
+    // The thread is stopped, so this side may reset everything
+    ring.clear();
+    hasPrevious = false;
+    samples = 0;
+    dropped = 0;
+    missedDeadlines = 0;
+    threadCpuNs = 0;
+
+    running = true;
+    thread = std::thread(&BurstSampler::run, this, intervalNs);
+    return true;
+}
+
+void BurstSampler::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool BurstSampler::isRunning() const {
+    return running;
+}
+
+size_t BurstSampler::drain(std::vector<BurstSample>& out) {
+    size_t count = 0;
+    BurstSample sample;
+    while (ring.pop(sample)) {
+        out.push_back(sample);
+        count++;
+    }
+    return count;
+}
+
+BurstSampler::Stats BurstSampler::getStats() const {
+    return Stats{samples.load(), dropped.load(), missedDeadlines.load(), threadCpuNs.load()};
+}
+
+void BurstSampler::run(int64_t intervalNs) {
+    int64_t deadline = clockNs(CLOCK_MONOTONIC);
+    while (running.load(std::memory_order_relaxed)) {
+        BurstSample sample;
+        if (collect(sample)) {
+            if (ring.push(sample)) {
+                samples.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        threadCpuNs.store(clockNs(CLOCK_THREAD_CPUTIME_ID), std::memory_order_relaxed);
+
+        // Next deadline on the original grid, skipping any already passed
+        deadline += intervalNs;
+        int64_t now = clockNs(CLOCK_MONOTONIC);
+        if (now >= deadline) {
+            int64_t missed = (now - deadline) / intervalNs + 1;
+            missedDeadlines.fetch_add(missed, std::memory_order_relaxed);
+            deadline += missed * intervalNs;
+        }
+
+        timespec wake;
+        wake.tv_sec = deadline / NSEC_PER_SEC;
+        wake.tv_nsec = deadline % NSEC_PER_SEC;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr) == EINTR) {
+        }
+    }
+}
+
+bool BurstSampler::collect(BurstSample& sample) {
+    int64_t start = SampleClock::nowNs();
+
+    uint64_t busy = 0;
+    uint64_t total = 0;
+    if (statFile.read(buffer.data(), STAT_READ_SIZE) <= 0 || !parseCpuLine(buffer.data(), busy, total)) {
+        return false;
+    }
+
+    uint64_t available = 0;
+    if (meminfoFile.read(buffer.data(), MEMINFO_READ_SIZE) > 0) {
+        const char* line = strstr(buffer.data(), "MemAvailable:");
+        available = line ? strtoull(line + 13, nullptr, 10) * 1024 : 0;
+    }
+
+    uint64_t rx = 0;
+    uint64_t tx = 0;
+    if (netDevFile.read(buffer.data(), buffer.size()) > 0) {
+        parseNetDev(buffer.data(), rx, tx);
+    }
+
+    int64_t end = SampleClock::nowNs();
+
+    // Rates need a previous sample; the first one only sets the baseline
+    bool ready = hasPrevious && start > previousTimeNs;
+    if (ready) {
+        double elapsed = static_cast<double>(start - previousTimeNs) / NSEC_PER_SEC;
+        uint64_t totalDelta = total > previousTotal ? total - previousTotal : 0;
+        uint64_t busyDelta = busy > previousBusy ? busy - previousBusy : 0;
+        sample.timeNs = start;
+        sample.collectNs = static_cast<uint32_t>(end - start);
+        sample.cpuBusyPercent = totalDelta > 0 ? 100.0f * std::min(busyDelta, totalDelta) / totalDelta : 0.0f;
+        sample.availableBytes = available;
+        sample.rxBytesPerSecond = rx >= previousRx ? (rx - previousRx) / elapsed : 0.0;
+        sample.txBytesPerSecond = tx >= previousTx ? (tx - previousTx) / elapsed : 0.0;
+    }
+
+    previousBusy = busy;
+    previousTotal = total;
+    previousRx = rx;
+    previousTx = tx;
+    previousTimeNs = start;
+    hasPrevious = true;
+    return ready;
+}
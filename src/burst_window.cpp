@@ -0,0 +1,257 @@
+#include "burst_window.h"
+#include <QHBoxLayout>
+#include <QGroupBox>
+#include <algorithm>
+
+namespace {
+
+// Sampling intervals offered; /proc/stat counts CPU time in 10 ms ticks, so
+// below that the CPU figure of a single sample is mostly 0 or 100%
+struct SamplingInterval {
+    const char *label;
+    int64_t nanoseconds;
+};
+
+const SamplingInterval SAMPLING_INTERVALS[] = {
+    {"100 ms", 100000000},
+    {"50 ms", 50000000},
+    {"20 ms", 20000000},
+    {"10 ms", 10000000},
+};
+
+// One frame per 33 ms over a 30 s window, with room to spare
+const int ENVELOPE_POINTS = 1000;
+
+const double MB = 1024.0 * 1024.0;
+
+qint64 clockMsecs() {
+    return SampleClock::nowNs() / 1000000;
+}
+
+} // namespace
+
+BurstWindow::BurstWindow(QWidget *parent)
+    : QWidget(parent),
+      statusMsecs(0),
+      statusStats{}
+#ifdef USE_QT_CHARTS
+      ,
+      cpuEnvelope(ENVELOPE_POINTS),
+      memoryEnvelope(ENVELOPE_POINTS),
+      networkEnvelope(ENVELOPE_POINTS),
+      memoryAxisMin(-1.0),
+      memoryAxisMax(-1.0),
+      networkAxisMax(1.0)
+#endif
+{
+    setupUI();
+
+    // Runs only while sampling
+    frameTimer = new QTimer(this);
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(frameTimer, &QTimer::timeout, this, &BurstWindow::renderFrame);
+}
+
+void BurstWindow::setupUI() {
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    QFont titleFont = font();
+    titleFont.setPointSize(12);
+    titleFont.setBold(true);
+
+    QLabel *titleLabel = new QLabel("High-Frequency Sampling", this);
+    titleLabel->setFont(titleFont);
+    mainLayout->addWidget(titleLabel);
+
+    // Interval and start/stop
+    QHBoxLayout *controlsLayout = new QHBoxLayout();
+    controlsLayout->addWidget(new QLabel("Sample every:", this));
+    intervalCombo = new QComboBox(this);
+    for (const SamplingInterval &interval : SAMPLING_INTERVALS) {
+        intervalCombo->addItem(interval.label, QVariant::fromValue<qlonglong>(interval.nanoseconds));
+    }
+    intervalCombo->setToolTip("CPU time is counted in 10 ms ticks, so at short intervals single samples "
+                              "are coarse; the envelope still shows the bursts");
+    controlsLayout->addWidget(intervalCombo);
+
+    startButton = new QPushButton("Start", this);
+    connect(startButton, &QPushButton::clicked, this, &BurstWindow::toggleSampling);
+    controlsLayout->addWidget(startButton);
+
+    statusLabel = new QLabel("Stopped", this);
+    controlsLayout->addWidget(statusLabel);
+    controlsLayout->addStretch();
+    mainLayout->addLayout(controlsLayout);
+
+    // Min and max over the samples of the last frame
+    QGroupBox *valuesGroup = new QGroupBox("Last Frame (min - max)", this);
+    QHBoxLayout *valuesLayout = new QHBoxLayout(valuesGroup);
+    cpuValueLabel = new QLabel("CPU: -", this);
+    memoryValueLabel = new QLabel("Available: -", this);
+    networkValueLabel = new QLabel("Network: -", this);
+    valuesLayout->addWidget(cpuValueLabel);
+    valuesLayout->addWidget(memoryValueLabel);
+    valuesLayout->addWidget(networkValueLabel);
+    mainLayout->addWidget(valuesGroup);
+
+#ifdef USE_QT_CHARTS
+    // One chart per metric, each area spanning the min and max of a frame
+    auto createChart = [this](const QString &title, const QString &valueTitle, RollingLineSeries &envelope,
+                              const QStringList &names, QChart *&chart, QChartView *&view) {
+        chart = new QChart();
+        chart->setTitle(title);
+        chart->legend()->setVisible(names.size() > 1);
+        chart->legend()->setAlignment(Qt::AlignBottom);
+
+        QDateTimeAxis *timeAxis = new QDateTimeAxis;
+        timeAxis->setFormat("hh:mm:ss");
+        chart->addAxis(timeAxis, Qt::AlignBottom);
+
+        QValueAxis *valueAxis = new QValueAxis;
+        valueAxis->setTitleText(valueTitle);
+        valueAxis->setLabelFormat("%.1f");
+        chart->addAxis(valueAxis, Qt::AlignLeft);
+
+        for (const QString &name : names) {
+            QLineSeries *upper = new QLineSeries(chart);
+            QLineSeries *lower = new QLineSeries(chart);
+            QAreaSeries *area = new QAreaSeries(upper, lower);
+            area->setName(name);
+            chart->addSeries(area);
+            area->attachAxis(timeAxis);
+            area->attachAxis(valueAxis);
+            envelope.addSeries(upper);
+            envelope.addSeries(lower);
+        }
+        envelope.setTimeAxis(timeAxis);
+        envelope.setWindowMsecs(WINDOW_MSECS);
+
+        view = new QChartView(chart, this);
+        view->setRenderHint(QPainter::Antialiasing);
+        view->setMinimumHeight(200);
+        return valueAxis;
+    };
+
+    QValueAxis *cpuAxis = createChart("CPU Busy", "Percent", cpuEnvelope, {"CPU"}, cpuChart, cpuChartView);
+    cpuAxis->setRange(0, 100);
+    createChart("Available Memory", "Memory (MB)", memoryEnvelope, {"Available"}, memoryChart, memoryChartView);
+    createChart("Network Throughput", "MB/s", networkEnvelope, {"Receive", "Transmit"}, networkChart, networkChartView);
+
+    mainLayout->addWidget(cpuChartView);
+    mainLayout->addWidget(memoryChartView);
+    mainLayout->addWidget(networkChartView);
+#else
+    mainLayout->addStretch();
+#endif
+}
+
+void BurstWindow::toggleSampling() {
+    if (sampler.isRunning()) {
+        sampler.stop();
+        frameTimer->stop();
+        startButton->setText("Start");
+        intervalCombo->setEnabled(true);
+        statusLabel->setText("Stopped");
+        return;
+    }
+
+    int64_t intervalNs = intervalCombo->currentData().toLongLong();
+    if (!sampler.start(intervalNs)) {
+        statusLabel->setText("Cannot read /proc/stat");
+        return;
+    }
+
+    statusMsecs = clockMsecs();
+    statusStats = sampler.getStats();
+    pending.clear();
+
+    startButton->setText("Stop");
+    intervalCombo->setEnabled(false);
+    frameTimer->start(FRAME_INTERVAL_MS);
+}
+
+void BurstWindow::renderFrame() {
+    pending.clear();
+    sampler.drain(pending);
+    updateStatus(clockMsecs());
+    if (pending.empty() || !isVisible()) {
+        return;
+    }
+
+    Envelope cpu{pending.front().cpuBusyPercent, pending.front().cpuBusyPercent};
+    Envelope memory{static_cast<double>(pending.front().availableBytes),
+                    static_cast<double>(pending.front().availableBytes)};
+    Envelope rx{pending.front().rxBytesPerSecond, pending.front().rxBytesPerSecond};
+    Envelope tx{pending.front().txBytesPerSecond, pending.front().txBytesPerSecond};
+    for (const BurstSample &sample : pending) {
+        cpu.min = std::min<double>(cpu.min, sample.cpuBusyPercent);
+        cpu.max = std::max<double>(cpu.max, sample.cpuBusyPercent);
+        memory.min = std::min<double>(memory.min, sample.availableBytes);
+        memory.max = std::max<double>(memory.max, sample.availableBytes);
+        rx.min = std::min(rx.min, sample.rxBytesPerSecond);
+        rx.max = std::max(rx.max, sample.rxBytesPerSecond);
+        tx.min = std::min(tx.min, sample.txBytesPerSecond);
+        tx.max = std::max(tx.max, sample.txBytesPerSecond);
+    }
+
+    cpuValueLabel->setText(QString("CPU: %1 - %2%").arg(cpu.min, 0, 'f', 0).arg(cpu.max, 0, 'f', 0));
+    memoryValueLabel->setText(QString("Available: %1 - %2").arg(formatSize(memory.min)).arg(formatSize(memory.max)));
+    networkValueLabel->setText(QString("Network: rx %1/s - %2/s, tx %3/s - %4/s")
+                                   .arg(formatSize(rx.min)).arg(formatSize(rx.max))
+                                   .arg(formatSize(tx.min)).arg(formatSize(tx.max)));
+
+#ifdef USE_QT_CHARTS
+    // The frame is drawn at the time of its last sample
+    qint64 frameMsecs = SampleClock::toWallMsecs(pending.back().timeNs);
+    cpuEnvelope.append(frameMsecs, {cpu.max, cpu.min});
+    memoryEnvelope.append(frameMsecs, {memory.max / MB, memory.min / MB});
+    networkEnvelope.append(frameMsecs, {rx.max / MB, rx.min / MB, tx.max / MB, tx.min / MB});
+
+    // Memory moves little, so its axis hugs the values seen; network grows
+    if (memoryAxisMin < 0 || memory.min / MB < memoryAxisMin || memory.max / MB > memoryAxisMax) {
+        memoryAxisMin = memoryAxisMin < 0 ? memory.min / MB : std::min(memoryAxisMin, memory.min / MB);
+        memoryAxisMax = std::max(memoryAxisMax, memory.max / MB);
+        double margin = std::max(1.0, (memoryAxisMax - memoryAxisMin) * 0.1);
+        qobject_cast<QValueAxis*>(memoryChart->axes(Qt::Vertical).first())
+            ->setRange(std::max(0.0, memoryAxisMin - margin), memoryAxisMax + margin);
+    }
+    double networkMax = std::max(rx.max, tx.max) / MB;
+    if (networkMax > networkAxisMax) {
+        networkAxisMax = networkMax * 1.2;
+        qobject_cast<QValueAxis*>(networkChart->axes(Qt::Vertical).first())->setRange(0, networkAxisMax);
+    }
+#endif
+}
+
+void BurstWindow::updateStatus(qint64 nowMsecs) {
+    if (nowMsecs - statusMsecs < 1000) {
+        return;
+    }
+
+    BurstSampler::Stats stats = sampler.getStats();
+    double seconds = (nowMsecs - statusMsecs) / 1000.0;
+    double rate = (stats.samples - statusStats.samples) / seconds;
+    double cpuPercent = 100.0 * (stats.threadCpuNs - statusStats.threadCpuNs) / 1e9 / seconds;
+
+    statusLabel->setText(QString("%1 samples/s, sampler CPU %2%, %3 late, %4 dropped")
+                             .arg(rate, 0, 'f', 0)
+                             .arg(cpuPercent, 0, 'f', 2)
+                             .arg(stats.missedDeadlines)
+                             .arg(stats.dropped));
+
+    statusMsecs = nowMsecs;
+    statusStats = stats;
+}
+
+QString BurstWindow::formatSize(double bytes) const {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unitIndex = 0;
+    double size = bytes;
+
+    while (size >= 1024.0 && unitIndex < 4) {
+        size /= 1024.0;
+        unitIndex++;
+    }
+
+    return QString("%1 %2").arg(size, 0, 'f', 2).arg(units[unitIndex]);
+}
@@ -0,0 +1,561 @@
+#include "cgroup_info.h"
+#include "sysfs_file.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/inotify.h>
+
+namespace {
+
+const size_t READ_BUFFER_SIZE = 64 * 1024;     // io.stat grows with the device count
+const size_t EVENT_BUFFER_SIZE = 64 * 1024;
+const char* const DEFAULT_MOUNT_POINT = "/sys/fs/cgroup";
+
+std::string joinPath(const std::string& parent, const char* name) {
+    return parent.empty() ? std::string(name) : parent + "/" + name;
+}
+
+double ratePercent(uint64_t current, uint64_t previous, double elapsedUsec) {
+    return current >= previous ? (current - previous) * 100.0 / elapsedUsec : 0.0;
+}
+
+} // namespace
+
+CgroupInfoCollector::CgroupInfoCollector()
+    : rootFd(-1),
+      inotifyFd(-1),
+      readBuffer(READ_BUFFER_SIZE),
+      eventBuffer(EVENT_BUFFER_SIZE),
+      hasPreviousRefresh(false),
+      rescanCount(0) {
+
+    mountPoint = findMountPoint();
+    rootFd = open(mountPoint.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (rootFd < 0) {
+        return;
+    }
+
+    // Without inotify every refresh falls back to walking the hierarchy
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    rescan();
+    refresh();
+}
+
+CgroupInfoCollector::~CgroupInfoCollector() {
+    for (auto& [path, group] : groups) {
+        if (group.dirFd >= 0) {
+            close(group.dirFd);
+        }
+    }
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+    }
+    if (rootFd >= 0) {
+        close(rootFd);
+    }
+}
+
+bool CgroupInfoCollector::isAvailable() const {
+    return rootFd >= 0;
+}
+
+const std::string& CgroupInfoCollector::getMountPoint() const {
+    return mountPoint;
+}
+
+bool CgroupInfoCollector::isWatching() const {
+    return inotifyFd >= 0;
+}
+
+const std::vector<CgroupInfo>& CgroupInfoCollector::getGroups() const {
+    return snapshot;
+}
+
+const std::deque<CgroupOomEvent>& CgroupInfoCollector::getOomEvents() const {
+    return oomEvents;
+}
+
+uint64_t CgroupInfoCollector::getRescanCount() const {
+    return rescanCount;
+}
+
+std::string CgroupInfoCollector::findMountPoint() {
+    // Hybrid systems mount the unified hierarchy below /sys/fs/cgroup
+    std::ifstream mountInfo("/proc/self/mountinfo");
+    std::string line;
+    while (std::getline(mountInfo, line)) {
+        size_t separator = line.find(" - ");
+        if (separator == std::string::npos || line.compare(separator + 3, 8, "cgroup2 ") != 0) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string id, parentId, device, root, mountPath;
+        fields >> id >> parentId >> device >> root >> mountPath;
+        if (!mountPath.empty()) {
+            return mountPath;
+        }
+    }
+    return DEFAULT_MOUNT_POINT;
+}
+
+bool CgroupInfoCollector::parseKeyValue(const char* text, const char* key, uint64_t& value) {
+    size_t keyLength = strlen(key);
+    const char* line = text;
+    while (line && *line) {
+        if (strncmp(line, key, keyLength) == 0 && line[keyLength] == ' ') {
+            value = strtoull(line + keyLength + 1, nullptr, 10);
+            return true;
+        }
+        line = strchr(line, '\n');
+        if (line) {
+            ++line;
+        }
+    }
+    return false;
+}
+
+uint64_t CgroupInfoCollector::sumKeyTokens(const char* text, const char* key) {
+    size_t keyLength = strlen(key);
+    uint64_t total = 0;
+    for (const char* p = strstr(text, key); p; p = strstr(p + keyLength, key)) {
+        if (p == text || p[-1] == ' ' || p[-1] == '\n') {
+            total += strtoull(p + keyLength, nullptr, 10);
+        }
+    }
+    return total;
+}
+
+void CgroupInfoCollector::refresh() {
+    if (rootFd < 0) {
+        return;
+    }
+
+    if (inotifyFd >= 0) {
+        drainInotify();
+    } else {
+        rescan();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double elapsedSeconds = 0.0;
+    if (hasPreviousRefresh) {
+        elapsedSeconds = std::chrono::duration<double>(now - lastRefreshTime).count();
+    }
+
+    snapshot.clear();
+    snapshot.reserve(groups.size());
+    for (auto& [path, group] : groups) {
+        readGroup(group, elapsedSeconds);
+        snapshot.push_back(group.info);
+    }
+
+    lastRefreshTime = now;
+    hasPreviousRefresh = true;
+}
+
+void CgroupInfoCollector::rescan() {
+    rescanCount++;
+
+    // Add what is new, then drop groups the walk did not see
+    std::vector<std::string> stale;
+    for (const auto& [path, group] : groups) {
+        if (!path.empty() && faccessat(rootFd, path.c_str(), F_OK, 0) != 0) {
+            stale.push_back(path);
+        }
+    }
+    for (const auto& path : stale) {
+        removeGroupTree(path);
+    }
+
+    addGroupTree("");
+}
+
+void CgroupInfoCollector::addGroup(const std::string& path) {
+    if (groups.count(path)) {
+        return;
+    }
+
+    Group group{};
+    group.dirFd = openat(rootFd, path.empty() ? "." : path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (group.dirFd < 0 && errno != EMFILE && errno != ENFILE) {
+        return;     // Removed before we got to it
+    }
+    group.directoryWatch = -1;
+    group.cgroupEventsWatch = -1;
+    group.memoryEventsWatch = -1;
+
+    group.info.path = path;
+    size_t slash = path.rfind('/');
+    group.info.name = path.empty() ? "/" : path.substr(slash == std::string::npos ? 0 : slash + 1);
+    group.info.depth = path.empty() ? 0 : static_cast<int>(std::count(path.begin(), path.end(), '/')) + 1;
+
+    if (inotifyFd >= 0) {
+        std::string fullPath = path.empty() ? mountPoint : mountPoint + "/" + path;
+        group.directoryWatch = inotify_add_watch(inotifyFd, fullPath.c_str(), IN_CREATE | IN_DELETE | IN_ONLYDIR);
+        group.cgroupEventsWatch = inotify_add_watch(inotifyFd, (fullPath + "/cgroup.events").c_str(), IN_MODIFY);
+        group.memoryEventsWatch = inotify_add_watch(inotifyFd, (fullPath + "/memory.events").c_str(), IN_MODIFY);
+
+        if (group.directoryWatch >= 0) {
+            watches[group.directoryWatch] = {path, WatchKind::DIRECTORY};
+        }
+        if (group.cgroupEventsWatch >= 0) {
+            watches[group.cgroupEventsWatch] = {path, WatchKind::CGROUP_EVENTS};
+        }
+        if (group.memoryEventsWatch >= 0) {
+            watches[group.memoryEventsWatch] = {path, WatchKind::MEMORY_EVENTS};
+        }
+    }
+
+    Group& added = groups.emplace(path, std::move(group)).first->second;
+    readPopulated(added);
+
+    // Baseline only: OOM kills from before we started are not events
+    uint64_t kills = 0;
+    if (readFile(added, "memory.events.local") > 0 || readFile(added, "memory.events") > 0) {
+        parseKeyValue(readBuffer.data(), "oom_kill", kills);
+    }
+    added.oomKillsLocal = kills;
+}
+
+void CgroupInfoCollector::addGroupTree(const std::string& path) {
+    // Watch first, list second: a child created in between is either in the
+    // listing or reported by the watch, and addGroup() ignores duplicates
+    addGroup(path);
+
+    auto it = groups.find(path);
+    if (it == groups.end()) {
+        return;
+    }
+
+    int listFd = it->second.dirFd >= 0
+        ? dup(it->second.dirFd)
+        : openat(rootFd, path.empty() ? "." : path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (listFd < 0) {
+        return;
+    }
+    DIR* dir = fdopendir(listFd);
+    if (!dir) {
+        close(listFd);
+        return;
+    }
+
+    // Directory offsets are shared with the dup'ed fd; start at the top
+    rewinddir(dir);
+
+    std::vector<std::string> children;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_type == DT_DIR && strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+            children.push_back(joinPath(path, entry->d_name));
+        }
+    }
+    closedir(dir);
+
+    for (const auto& child : children) {
+        addGroupTree(child);
+    }
+}
+
+void CgroupInfoCollector::removeGroupTree(const std::string& path) {
+    // Descendants first; "a/..." is not contiguous with "a" in the map
+    // ("a-b" sorts in between), so look the prefix up separately
+    std::string prefix = path + "/";
+    std::vector<std::string> doomed;
+    for (auto it = groups.lower_bound(prefix); it != groups.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        doomed.push_back(it->first);
+    }
+    doomed.push_back(path);
+
+    for (const auto& doomedPath : doomed) {
+        auto it = groups.find(doomedPath);
+        if (it == groups.end()) {
+            continue;
+        }
+        Group& group = it->second;
+        removeWatch(group.directoryWatch);
+        removeWatch(group.cgroupEventsWatch);
+        removeWatch(group.memoryEventsWatch);
+        if (group.dirFd >= 0) {
+            close(group.dirFd);
+        }
+        groups.erase(it);
+    }
+}
+
+void CgroupInfoCollector::removeWatch(int& watch) {
+    if (watch < 0) {
+        return;
+    }
+    // Fails harmlessly when the kernel already dropped it with the directory
+    inotify_rm_watch(inotifyFd, watch);
+    watches.erase(watch);
+    watch = -1;
+}
+
+void CgroupInfoCollector::drainInotify() {
+    bool overflow = false;
+
+    while (true) {
+        ssize_t length = read(inotifyFd, eventBuffer.data(), eventBuffer.size());
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length <= 0) {
+            break;  // EAGAIN: nothing pending
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(eventBuffer.data() + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+
+            auto watchIt = watches.find(event->wd);
+            if (watchIt == watches.end()) {
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                watches.erase(watchIt);
+                continue;
+            }
+
+            // Copy: adding or removing groups below changes the watch table
+            Watch watch = watchIt->second;
+            switch (watch.kind) {
+                case WatchKind::DIRECTORY:
+                    if ((event->mask & IN_ISDIR) && event->len > 0) {
+                        std::string childPath = joinPath(watch.path, event->name);
+                        if (event->mask & IN_CREATE) {
+                            addGroupTree(childPath);
+                        } else if (event->mask & IN_DELETE) {
+                            removeGroupTree(childPath);
+                        }
+                    }
+                    break;
+                case WatchKind::CGROUP_EVENTS: {
+                    auto groupIt = groups.find(watch.path);
+                    if (groupIt != groups.end()) {
+                        readPopulated(groupIt->second);
+                    }
+                    break;
+                }
+                case WatchKind::MEMORY_EVENTS: {
+                    auto groupIt = groups.find(watch.path);
+                    if (groupIt != groups.end()) {
+                        checkOomKills(groupIt->second);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // Events were lost; reconcile with a walk
+    if (overflow) {
+        rescan();
+    }
+}
+
+ssize_t CgroupInfoCollector::readFile(const Group& group, const char* name) {
+    SysfsFile file;
+    if (group.dirFd >= 0) {
+        file = SysfsFile(group.dirFd, name);
+    } else {
+        // Out of descriptors for this group; resolve from the mount point
+        file = SysfsFile(rootFd, joinPath(group.info.path, name).c_str());
+    }
+    return file.read(readBuffer.data(), readBuffer.size());
+}
+
+bool CgroupInfoCollector::readPressure(const Group& group, const char* name, PressureTotals& totals) {
+    totals = {0, 0};
+    if (readFile(group, name) <= 0) {
+        return false;
+    }
+
+    // some avg10=0.00 avg60=0.00 avg300=0.00 total=12345
+    // full avg10=0.00 avg60=0.00 avg300=0.00 total=6789
+    const char* some = strstr(readBuffer.data(), "some ");
+    const char* full = strstr(readBuffer.data(), "full ");
+    if (some) {
+        const char* total = strstr(some, "total=");
+        totals.some = total ? strtoull(total + 6, nullptr, 10) : 0;
+    }
+    if (full) {
+        const char* total = strstr(full, "total=");
+        totals.full = total ? strtoull(total + 6, nullptr, 10) : 0;
+    }
+    return true;
+}
+
+bool CgroupInfoCollector::readPopulated(Group& group) {
+    uint64_t populated = 0;
+    bool ok = readFile(group, "cgroup.events") > 0 && parseKeyValue(readBuffer.data(), "populated", populated);
+    // The root has no cgroup.events and is always populated
+    group.info.populated = ok ? populated != 0 : group.info.path.empty();
+    return ok;
+}
+
+void CgroupInfoCollector::checkOomKills(Group& group) {
+    // memory.events is hierarchical; the .local variant tells which group
+    // the kill actually happened in
+    uint64_t kills = 0;
+    if (readFile(group, "memory.events.local") <= 0 || !parseKeyValue(readBuffer.data(), "oom_kill", kills)) {
+        if (readFile(group, "memory.events") <= 0 || !parseKeyValue(readBuffer.data(), "oom_kill", kills)) {
+            return;
+        }
+        if (!group.info.path.empty()) {
+            // Without .local, only report the deepest group; the parents'
+            // hierarchical counters rise along with it
+            std::string prefix = group.info.path + "/";
+            auto next = groups.upper_bound(group.info.path);
+            for (; next != groups.end() && next->first.compare(0, prefix.size(), prefix) == 0; ++next) {
+                if (next->second.memoryEventsWatch >= 0) {
+                    group.oomKillsLocal = kills;
+                    return;
+                }
+            }
+        }
+    }
+
+    if (kills > group.oomKillsLocal) {
+        oomEvents.push_back({group.info.path, kills - group.oomKillsLocal, std::chrono::system_clock::now()});
+        while (oomEvents.size() > MAX_OOM_EVENTS) {
+            oomEvents.pop_front();
+        }
+    }
+    group.oomKillsLocal = kills;
+}
+
+void CgroupInfoCollector::readGroup(Group& group, double elapsedSeconds) {
+    CgroupInfo& info = group.info;
+
+    uint64_t value = 0;
+    info.cpuUsageUsec = 0;
+    info.cpuThrottledUsec = 0;
+    info.nrThrottled = 0;
+    if (readFile(group, "cpu.stat") > 0) {
+        const char* text = readBuffer.data();
+        if (parseKeyValue(text, "usage_usec", value)) info.cpuUsageUsec = value;
+        if (parseKeyValue(text, "throttled_usec", value)) info.cpuThrottledUsec = value;
+        if (parseKeyValue(text, "nr_throttled", value)) info.nrThrottled = value;
+    }
+
+    info.memoryAnon = 0;
+    info.memoryFile = 0;
+    if (readFile(group, "memory.stat") > 0) {
+        const char* text = readBuffer.data();
+        if (parseKeyValue(text, "anon", value)) info.memoryAnon = value;
+        if (parseKeyValue(text, "file", value)) info.memoryFile = value;
+    }
+
+    // The root has no memory.current; approximate it from memory.stat
+    if (readFile(group, "memory.current") > 0) {
+        info.memoryCurrent = strtoull(readBuffer.data(), nullptr, 10);
+    } else {
+        info.memoryCurrent = info.memoryAnon + info.memoryFile;
+    }
+
+    info.ioReadBytes = 0;
+    info.ioWriteBytes = 0;
+    if (readFile(group, "io.stat") > 0) {
+        info.ioReadBytes = sumKeyTokens(readBuffer.data(), "rbytes=");
+        info.ioWriteBytes = sumKeyTokens(readBuffer.data(), "wbytes=");
+    }
+
+    info.pidsCurrent = 0;
+    if (readFile(group, "pids.current") > 0) {
+        info.pidsCurrent = strtoull(readBuffer.data(), nullptr, 10);
+    }
+
+    info.oomKills = 0;
+    if (readFile(group, "memory.events") > 0 && parseKeyValue(readBuffer.data(), "oom_kill", value)) {
+        info.oomKills = value;
+    }
+
+    PressureTotals cpuPressure;
+    PressureTotals memoryPressure;
+    PressureTotals ioPressure;
+    readPressure(group, "cpu.pressure", cpuPressure);
+    readPressure(group, "memory.pressure", memoryPressure);
+    readPressure(group, "io.pressure", ioPressure);
+
+    info.cpuPercent = 0.0;
+    info.cpuThrottledPercent = 0.0;
+    info.ioReadBytesPerSec = 0.0;
+    info.ioWriteBytesPerSec = 0.0;
+    info.cpuPressureSome = 0.0;
+    info.memoryPressureSome = 0.0;
+    info.memoryPressureFull = 0.0;
+    info.ioPressureSome = 0.0;
+    info.ioPressureFull = 0.0;
+
+    if (group.hasPrevious && elapsedSeconds > 0.0) {
+        double elapsedUsec = elapsedSeconds * 1e6;
+        info.cpuPercent = ratePercent(info.cpuUsageUsec, group.lastCpuUsageUsec, elapsedUsec);
+        info.cpuThrottledPercent = ratePercent(info.cpuThrottledUsec, group.lastCpuThrottledUsec, elapsedUsec);
+        if (info.ioReadBytes >= group.lastIoReadBytes) {
+            info.ioReadBytesPerSec = (info.ioReadBytes - group.lastIoReadBytes) / elapsedSeconds;
+        }
+        if (info.ioWriteBytes >= group.lastIoWriteBytes) {
+            info.ioWriteBytesPerSec = (info.ioWriteBytes - group.lastIoWriteBytes) / elapsedSeconds;
+        }
+        info.cpuPressureSome = ratePercent(cpuPressure.some, group.lastCpuPressure.some, elapsedUsec);
+        info.memoryPressureSome = ratePercent(memoryPressure.some, group.lastMemoryPressure.some, elapsedUsec);
+        info.memoryPressureFull = ratePercent(memoryPressure.full, group.lastMemoryPressure.full, elapsedUsec);
+        info.ioPressureSome = ratePercent(ioPressure.some, group.lastIoPressure.some, elapsedUsec);
+        info.ioPressureFull = ratePercent(ioPressure.full, group.lastIoPressure.full, elapsedUsec);
+    }
+
+    group.lastCpuUsageUsec = info.cpuUsageUsec;
+    group.lastCpuThrottledUsec = info.cpuThrottledUsec;
+    group.lastIoReadBytes = info.ioReadBytes;
+    group.lastIoWriteBytes = info.ioWriteBytes;
+    group.lastCpuPressure = cpuPressure;
+    group.lastMemoryPressure = memoryPressure;
+    group.lastIoPressure = ioPressure;
+    group.hasPrevious = true;
+}
+
+void CgroupInfoCollector::printAllInfo() const {
+    std::cout << "Control Groups:" << std::endl;
+    std::cout << "---------------" << std::endl;
+    if (rootFd < 0) {
+        std::cout << "No cgroup v2 hierarchy mounted" << std::endl;
+        return;
+    }
+    std::cout << "Mount point: " << mountPoint << ", " << snapshot.size() << " groups"
+              << (inotifyFd >= 0 ? " (inotify)" : " (polling)") << std::endl;
+
+    // Top 10 by CPU
+    std::vector<const CgroupInfo*> sorted;
+    for (const auto& info : snapshot) {
+        sorted.push_back(&info);
+    }
+    size_t count = std::min<size_t>(10, sorted.size());
+    std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end(),
+                      [](const CgroupInfo* a, const CgroupInfo* b) { return a->cpuPercent > b->cpuPercent; });
+
+    for (size_t i = 0; i < count; ++i) {
+        const CgroupInfo* info = sorted[i];
+        std::cout << std::setw(40) << std::left << (info->path.empty() ? "/" : info->path) << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(8) << info->cpuPercent << "%  "
+                  << std::setw(10) << (info->memoryCurrent / 1024) << " KB  "
+                  << info->pidsCurrent << " tasks" << std::endl;
+    }
+
+    for (const auto& event : oomEvents) {
+        std::cout << "OOM kill in " << event.path << " (" << event.kills << ")" << std::endl;
+    }
+}
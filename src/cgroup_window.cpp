@@ -0,0 +1,278 @@
+#include "cgroup_window.h"
+#include <QHeaderView>
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QCheckBox>
+#include <QSet>
+#include <algorithm>
+
+namespace {
+
+// Sorts on the raw value stored in Qt::UserRole instead of the display text
+class CgroupTreeItem : public QTreeWidgetItem {
+public:
+    using QTreeWidgetItem::QTreeWidgetItem;
+
+    bool operator<(const QTreeWidgetItem &other) const override {
+        int column = treeWidget() ? treeWidget()->sortColumn() : 0;
+        QVariant left = data(column, Qt::UserRole);
+        QVariant right = other.data(column, Qt::UserRole);
+        if (left.isValid() && right.isValid()) {
+            return left.toDouble() < right.toDouble();
+        }
+        return QTreeWidgetItem::operator<(other);
+    }
+};
+
+QString parentPath(const QString &path) {
+    int slash = path.lastIndexOf('/');
+    return slash < 0 ? QString() : path.left(slash);
+}
+
+} // namespace
+
+CgroupWindow::CgroupWindow(QWidget *parent)
+    : QWidget(parent),
+      autoRefreshEnabled(true) {
+    // Set up auto-refresh timer (every 2 seconds), started by showEvent
+    autoRefreshTimer = new DeadlineTimer(this);
+    connect(autoRefreshTimer, &DeadlineTimer::timeout, this, &CgroupWindow::refreshData);
+
+    setupUI();
+    updateTree();
+}
+
+void CgroupWindow::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+
+    // Catch up on what changed while hidden, then resume the timer
+    if (autoRefreshEnabled) {
+        refreshData();
+        autoRefreshTimer->start(2000);
+    }
+}
+
+void CgroupWindow::hideEvent(QHideEvent *event) {
+    QWidget::hideEvent(event);
+    autoRefreshTimer->stop();
+}
+
+void CgroupWindow::setupUI() {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    QFont titleFont = font();
+    titleFont.setPointSize(12);
+    titleFont.setBold(true);
+
+    // Create header
+    QLabel *headerLabel = new QLabel("Control Groups", this);
+    headerLabel->setFont(titleFont);
+    layout->addWidget(headerLabel);
+
+    cgroupTree = new QTreeWidget(this);
+    cgroupTree->setObjectName("cgroupTree");
+    cgroupTree->setColumnCount(ColumnCount);
+    cgroupTree->setHeaderLabels({"Group", "CPU %", "Memory", "Read/s", "Write/s", "Tasks",
+                                 "CPU Pressure", "Memory Pressure", "I/O Pressure", "OOM Kills"});
+    cgroupTree->setUniformRowHeights(true);
+    cgroupTree->setAlternatingRowColors(true);
+    cgroupTree->setSelectionMode(QAbstractItemView::SingleSelection);
+    cgroupTree->header()->setSectionResizeMode(QHeaderView::Interactive);
+    cgroupTree->header()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+    cgroupTree->header()->setStretchLastSection(false);
+
+    // Children are sorted within their parent, so the hierarchy stays intact
+    cgroupTree->setSortingEnabled(true);
+    cgroupTree->sortByColumn(CpuColumn, Qt::DescendingOrder);
+
+    cgroupTree->headerItem()->setToolTip(CpuPressureColumn, "Share of time some tasks were waiting for CPU");
+    cgroupTree->headerItem()->setToolTip(MemoryPressureColumn, "Share of time some tasks were stalled on memory");
+    cgroupTree->headerItem()->setToolTip(IoPressureColumn, "Share of time some tasks were stalled on I/O");
+    layout->addWidget(cgroupTree, 1);
+
+    // Recent OOM kills, reported by memory.events as they happen
+    QLabel *oomLabel = new QLabel("Recent OOM kills:", this);
+    layout->addWidget(oomLabel);
+
+    oomList = new QListWidget(this);
+    oomList->setMaximumHeight(fontMetrics().height() * 6);
+    layout->addWidget(oomList);
+
+    // Create controls at the bottom
+    QHBoxLayout *controlLayout = new QHBoxLayout();
+
+    // Auto-refresh checkbox
+    QCheckBox *autoRefreshCheckbox = new QCheckBox("Auto-refresh (2s)", this);
+    autoRefreshCheckbox->setChecked(true);
+    connect(autoRefreshCheckbox, &QCheckBox::toggled, [this](bool checked) {
+        autoRefreshEnabled = checked;
+        if (checked && isVisible()) {
+            autoRefreshTimer->start(2000);
+        } else {
+            autoRefreshTimer->stop();
+        }
+    });
+    controlLayout->addWidget(autoRefreshCheckbox);
+
+    controlLayout->addStretch();
+
+    statusLabel = new QLabel(this);
+    controlLayout->addWidget(statusLabel);
+
+    // Last update label
+    lastUpdateLabel = new QLabel(this);
+    controlLayout->addWidget(lastUpdateLabel);
+
+    // Refresh button
+    refreshButton = new QPushButton("Refresh", this);
+    connect(refreshButton, &QPushButton::clicked, this, &CgroupWindow::refreshData);
+    controlLayout->addWidget(refreshButton);
+
+    layout->addLayout(controlLayout);
+}
+
+void CgroupWindow::setCell(QTreeWidgetItem *item, int column, const QString &text, double value) {
+    if (item->text(column) != text) {
+        item->setText(column, text);
+    }
+    item->setData(column, Qt::UserRole, value);
+}
+
+void CgroupWindow::updateTree() {
+    if (!cgroupInfo.isAvailable()) {
+        statusLabel->setText("No cgroup v2 hierarchy mounted");
+        return;
+    }
+
+    // Re-sort once after all values are in, not on every setData()
+    cgroupTree->setSortingEnabled(false);
+
+    const std::vector<CgroupInfo> &groups = cgroupInfo.getGroups();
+    QSet<QString> seen;
+    seen.reserve(static_cast<int>(groups.size()));
+
+    // Groups come parents first, so a new group's parent item already exists
+    for (const auto &group : groups) {
+        QString path = QString::fromStdString(group.path);
+        seen.insert(path);
+
+        QTreeWidgetItem *item = items.value(path);
+        if (!item) {
+            if (group.path.empty()) {
+                item = new CgroupTreeItem(cgroupTree);
+            } else {
+                QTreeWidgetItem *parentItem = items.value(parentPath(path));
+                item = parentItem ? new CgroupTreeItem(parentItem) : new CgroupTreeItem(cgroupTree);
+            }
+            item->setText(NameColumn, QString::fromStdString(group.name));
+            item->setToolTip(NameColumn, "/" + path);
+            for (int column = CpuColumn; column < ColumnCount; ++column) {
+                item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+            }
+            if (group.depth < 2) {
+                item->setExpanded(true);
+            }
+            items.insert(path, item);
+        }
+
+        setCell(item, CpuColumn, QString::number(group.cpuPercent, 'f', 1), group.cpuPercent);
+        setCell(item, MemoryColumn, formatSize(group.memoryCurrent), static_cast<double>(group.memoryCurrent));
+        setCell(item, IoReadColumn, formatSize(static_cast<uint64_t>(group.ioReadBytesPerSec)) + "/s", group.ioReadBytesPerSec);
+        setCell(item, IoWriteColumn, formatSize(static_cast<uint64_t>(group.ioWriteBytesPerSec)) + "/s", group.ioWriteBytesPerSec);
+        setCell(item, TasksColumn, QString::number(group.pidsCurrent), static_cast<double>(group.pidsCurrent));
+        setCell(item, CpuPressureColumn, QString::number(group.cpuPressureSome, 'f', 1) + "%", group.cpuPressureSome);
+        setCell(item, MemoryPressureColumn, QString::number(group.memoryPressureSome, 'f', 1) + "%", group.memoryPressureSome);
+        setCell(item, IoPressureColumn, QString::number(group.ioPressureSome, 'f', 1) + "%", group.ioPressureSome);
+        setCell(item, OomColumn, QString::number(group.oomKills), static_cast<double>(group.oomKills));
+
+        item->setToolTip(MemoryPressureColumn, QString("some %1%, full %2%")
+                             .arg(group.memoryPressureSome, 0, 'f', 1)
+                             .arg(group.memoryPressureFull, 0, 'f', 1));
+        item->setToolTip(IoPressureColumn, QString("some %1%, full %2%")
+                             .arg(group.ioPressureSome, 0, 'f', 1)
+                             .arg(group.ioPressureFull, 0, 'f', 1));
+        item->setToolTip(CpuColumn, group.cpuThrottledPercent > 0.0
+            ? QString("Throttled %1% of the time").arg(group.cpuThrottledPercent, 0, 'f', 1)
+            : QString());
+
+        // Grey out groups with no processes left in them
+        QBrush foreground = group.populated ? cgroupTree->palette().text() : cgroupTree->palette().mid();
+        if (item->foreground(NameColumn) != foreground) {
+            for (int column = 0; column < ColumnCount; ++column) {
+                item->setForeground(column, foreground);
+            }
+        }
+    }
+
+    // Delete removed groups deepest first so no item is freed with its parent
+    QStringList stale;
+    for (auto it = items.constBegin(); it != items.constEnd(); ++it) {
+        if (!seen.contains(it.key())) {
+            stale.append(it.key());
+        }
+    }
+    std::sort(stale.begin(), stale.end(), [](const QString &a, const QString &b) {
+        return a.count('/') > b.count('/');
+    });
+    for (const QString &path : stale) {
+        delete items.take(path);
+    }
+
+    cgroupTree->setSortingEnabled(true);
+
+    updateOomList();
+
+    statusLabel->setText(QString("%1 groups at %2 (%3)")
+                             .arg(groups.size())
+                             .arg(QString::fromStdString(cgroupInfo.getMountPoint()))
+                             .arg(cgroupInfo.isWatching() ? "inotify" : "polling"));
+
+    // Update last refresh time
+    QDateTime now = QDateTime::currentDateTime();
+    lastUpdateLabel->setText("Last updated: " + now.toString("hh:mm:ss"));
+}
+
+void CgroupWindow::updateOomList() {
+    const std::deque<CgroupOomEvent> &events = cgroupInfo.getOomEvents();
+    if (oomList->count() == static_cast<int>(events.size()) && oomList->count() > 0 &&
+        oomList->item(0)->data(Qt::UserRole).toLongLong() ==
+            std::chrono::duration_cast<std::chrono::milliseconds>(events.back().time.time_since_epoch()).count()) {
+        return;
+    }
+
+    oomList->clear();
+    if (events.empty()) {
+        oomList->addItem("None since startup");
+        return;
+    }
+
+    // Newest first
+    for (auto it = events.rbegin(); it != events.rend(); ++it) {
+        qint64 milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(it->time.time_since_epoch()).count();
+        QString when = QDateTime::fromMSecsSinceEpoch(milliseconds).toString("hh:mm:ss");
+        QListWidgetItem *item = new QListWidgetItem(QString("%1  /%2  (%3 killed)")
+                                                        .arg(when)
+                                                        .arg(QString::fromStdString(it->path))
+                                                        .arg(it->kills));
+        item->setData(Qt::UserRole, milliseconds);
+        oomList->addItem(item);
+    }
+}
+
+void CgroupWindow::refreshData() {
+    cgroupInfo.refresh();
+    updateTree();
+}
+
+QString CgroupWindow::formatSize(uint64_t bytes) const {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unitIndex = 0;
+    double size = static_cast<double>(bytes);
+
+    while (size >= 1024.0 && unitIndex < 4) {
+        size /= 1024.0;
+        unitIndex++;
+    }
+
+    return QString::number(size, 'f', unitIndex == 0 ? 0 : 1) + " " + units[unitIndex];
+}
@@ -8,9 +8,22 @@
 #include <QLineEdit>
 #include <QFont>
 #include <QDateTime>
+#include <QGroupBox>
+#include <algorithm>
 
 CPUInfoWidget::CPUInfoWidget(QWidget *parent) : QWidget(parent) {
     setupUI();
+    refreshThermalInfo();
+
+    // Sensors are cheap to read through the cached descriptors (every 2 seconds)
+    thermalTimer = new DeadlineTimer(this);
+    connect(thermalTimer, &DeadlineTimer::timeout, this, &CPUInfoWidget::refreshThermalInfo);
+    thermalTimer->start(2000);
+
+    // Counter groups keep running between reads; sample the deltas every second
+    perfTimer = new DeadlineTimer(this);
+    connect(perfTimer, &DeadlineTimer::timeout, this, &CPUInfoWidget::refreshPerfCounters);
+    perfTimer->start(1000);
 }
 
 void CPUInfoWidget::setupUI() {
@@ -23,8 +36,10 @@ void CPUInfoWidget::setupUI() {
     // Add tabs for different CPU sections
     tabWidget->addTab(createBasicInfoSection(), "Basic Info");
     tabWidget->addTab(createFrequencySection(), "Frequency");
+    tabWidget->addTab(createThermalSection(), "Thermal");
     tabWidget->addTab(createCacheSection(), "Cache");
     tabWidget->addTab(createFlagsSection(), "CPU Flags");
+    tabWidget->addTab(createPerfCountersSection(), "Performance Counters");
 }
 
 QWidget* CPUInfoWidget::createBasicInfoSection() {
@@ -149,6 +164,128 @@ QWidget* CPUInfoWidget::createFrequencySection() {
     return widget;
 }
 
+QWidget* CPUInfoWidget::createThermalSection() {
+    QWidget *widget = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(widget);
+
+    QFont titleFont = widget->font();
+    titleFont.setPointSize(12);
+    titleFont.setBold(true);
+
+    QFont valueFont = widget->font();
+    valueFont.setPointSize(10);
+
+    // Temperature sensors from hwmon and thermal zones
+    QGroupBox *sensorGroup = new QGroupBox("Temperature Sensors", widget);
+    QVBoxLayout *sensorLayout = new QVBoxLayout(sensorGroup);
+
+    std::vector<TemperatureSensor> sensors = thermalInfo.getSensors();
+
+    sensorTable = new QTableWidget(static_cast<int>(sensors.size()), 4, sensorGroup);
+    sensorTable->setHorizontalHeaderLabels(QStringList() << "Sensor" << "Source" << "Temperature" << "Critical");
+    sensorTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    sensorTable->verticalHeader()->setVisible(false);
+    sensorTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    sensorTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    sensorTable->setAlternatingRowColors(true);
+
+    // The sensor set is fixed after discovery, so rows are created once and
+    // only the temperature cells change on refresh
+    for (size_t i = 0; i < sensors.size(); ++i) {
+        const TemperatureSensor &sensor = sensors[i];
+        QString name = QString::fromStdString(sensor.chip) + " / " + QString::fromStdString(sensor.label);
+        QString critical = sensor.criticalC > 0
+            ? QString::number(sensor.criticalC, 'f', 1) + " \u00B0C"
+            : "-";
+
+        sensorTable->setItem(i, 0, new QTableWidgetItem(name));
+        sensorTable->setItem(i, 1, new QTableWidgetItem(QString::fromStdString(sensor.source)));
+        sensorTable->setItem(i, 2, new QTableWidgetItem("-"));
+        sensorTable->setItem(i, 3, new QTableWidgetItem(critical));
+    }
+
+    if (sensors.empty()) {
+        QLabel *noSensorsLabel = new QLabel("No temperature sensors found", sensorGroup);
+        noSensorsLabel->setFont(valueFont);
+        sensorLayout->addWidget(noSensorsLabel);
+        sensorTable->setVisible(false);
+    }
+
+    sensorLayout->addWidget(sensorTable);
+    layout->addWidget(sensorGroup);
+
+    // Thermal throttling counters
+    QGroupBox *throttleGroup = new QGroupBox("Thermal Throttling", widget);
+    QVBoxLayout *throttleLayout = new QVBoxLayout(throttleGroup);
+
+    QGridLayout *gridLayout = new QGridLayout();
+    throttleLayout->addLayout(gridLayout);
+
+    QLabel *coreThrottleLabel = new QLabel("Core Throttle Events:", throttleGroup);
+    coreThrottleLabel->setFont(titleFont);
+    gridLayout->addWidget(coreThrottleLabel, 0, 0);
+
+    coreThrottleValue = new QLabel("Not available", throttleGroup);
+    coreThrottleValue->setFont(valueFont);
+    gridLayout->addWidget(coreThrottleValue, 0, 1);
+
+    QLabel *packageThrottleLabel = new QLabel("Package Throttle Events:", throttleGroup);
+    packageThrottleLabel->setFont(titleFont);
+    gridLayout->addWidget(packageThrottleLabel, 1, 0);
+
+    packageThrottleValue = new QLabel("Not available", throttleGroup);
+    packageThrottleValue->setFont(valueFont);
+    gridLayout->addWidget(packageThrottleValue, 1, 1);
+
+    gridLayout->setColumnStretch(1, 1);
+
+#ifdef USE_QT_CHARTS
+    // Throttle event rate history
+    throttleChart = new QChart();
+    throttleChart->setTitle("Throttle Events per Second");
+    throttleChart->legend()->setVisible(true);
+    throttleChart->legend()->setAlignment(Qt::AlignBottom);
+
+    coreThrottleSeries = new QLineSeries();
+    coreThrottleSeries->setName("Core");
+
+    packageThrottleSeries = new QLineSeries();
+    packageThrottleSeries->setName("Package");
+
+    throttleChart->addSeries(coreThrottleSeries);
+    throttleChart->addSeries(packageThrottleSeries);
+
+    QDateTimeAxis *timeAxis = new QDateTimeAxis;
+    timeAxis->setFormat("hh:mm:ss");
+    timeAxis->setTitleText("Time");
+    throttleChart->addAxis(timeAxis, Qt::AlignBottom);
+
+    QValueAxis *rateAxis = new QValueAxis;
+    rateAxis->setTitleText("Events/s");
+    rateAxis->setLabelFormat("%.1f");
+    rateAxis->setRange(0, 1);
+    throttleChart->addAxis(rateAxis, Qt::AlignLeft);
+
+    coreThrottleSeries->attachAxis(timeAxis);
+    coreThrottleSeries->attachAxis(rateAxis);
+    packageThrottleSeries->attachAxis(timeAxis);
+    packageThrottleSeries->attachAxis(rateAxis);
+
+    QChartView *throttleChartView = new QChartView(throttleChart, throttleGroup);
+    throttleChartView->setRenderHint(QPainter::Antialiasing);
+    throttleChartView->setMinimumHeight(200);
+    throttleLayout->addWidget(throttleChartView);
+#endif
+
+    if (!thermalInfo.hasThrottleCounters()) {
+        throttleGroup->setEnabled(false);
+    }
+
+    layout->addWidget(throttleGroup);
+
+    return widget;
+}
+
 QWidget* CPUInfoWidget::createCacheSection() {
     QWidget *widget = new QWidget(this);
     QVBoxLayout *layout = new QVBoxLayout(widget);
@@ -238,6 +375,81 @@ QWidget* CPUInfoWidget::createFlagsSection() {
     return widget;
 }
 
+QWidget* CPUInfoWidget::createPerfCountersSection() {
+    QWidget *widget = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(widget);
+
+    perfStatusLabel = new QLabel(QString::fromStdString(perfCounters.getStatusMessage()), widget);
+    perfStatusLabel->setWordWrap(true);
+    layout->addWidget(perfStatusLabel);
+
+    QStringList metrics;
+    metrics << "Instructions per Cycle (IPC)"
+            << "Instructions/s"
+            << "Cycles/s"
+            << "Cache Misses/s"
+            << "Branch Misses/s"
+            << "Context Switches/s"
+            << "CPU Migrations/s"
+            << "Page Faults/s";
+
+    perfTable = new QTableWidget(metrics.size(), 2, widget);
+    perfTable->setHorizontalHeaderLabels(QStringList() << "Metric" << "System-wide Rate");
+    perfTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    perfTable->verticalHeader()->setVisible(false);
+    perfTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    perfTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    perfTable->setAlternatingRowColors(true);
+
+    for (int row = 0; row < metrics.size(); ++row) {
+        perfTable->setItem(row, 0, new QTableWidgetItem(metrics[row]));
+        perfTable->setItem(row, 1, new QTableWidgetItem("-"));
+    }
+
+    layout->addWidget(perfTable);
+
+    if (perfCounters.getMode() == PerfCounterMode::UNAVAILABLE) {
+        perfTable->setEnabled(false);
+    }
+
+    return widget;
+}
+
+void CPUInfoWidget::refreshPerfCounters() {
+    if (perfCounters.getMode() == PerfCounterMode::UNAVAILABLE) {
+        return;
+    }
+
+    perfCounters.refresh();
+    PerfCounterRates rates = perfCounters.getRates();
+    if (!rates.valid) {
+        return;
+    }
+
+    // Human readable rate with K/M/G suffix
+    auto formatRate = [](double value) -> QString {
+        const char* suffixes[] = {"", "K", "M", "G", "T"};
+        int suffixIndex = 0;
+        while (value >= 1000.0 && suffixIndex < 4) {
+            value /= 1000.0;
+            suffixIndex++;
+        }
+        return QString("%1 %2").arg(value, 0, 'f', 2).arg(suffixes[suffixIndex]).trimmed();
+    };
+
+    bool hardware = perfCounters.getMode() == PerfCounterMode::HARDWARE;
+    QString notAvailable = "Not available";
+
+    perfTable->item(0, 1)->setText(hardware ? QString::number(rates.instructionsPerCycle, 'f', 2) : notAvailable);
+    perfTable->item(1, 1)->setText(hardware ? formatRate(rates.instructionsPerSec) : notAvailable);
+    perfTable->item(2, 1)->setText(hardware ? formatRate(rates.cyclesPerSec) : notAvailable);
+    perfTable->item(3, 1)->setText(hardware ? formatRate(rates.cacheMissesPerSec) : notAvailable);
+    perfTable->item(4, 1)->setText(hardware ? formatRate(rates.branchMissesPerSec) : notAvailable);
+    perfTable->item(5, 1)->setText(formatRate(rates.contextSwitchesPerSec));
+    perfTable->item(6, 1)->setText(formatRate(rates.cpuMigrationsPerSec));
+    perfTable->item(7, 1)->setText(formatRate(rates.pageFaultsPerSec));
+}
+
 void CPUInfoWidget::refreshData() {
     // Update CPU information
     cpuInfo.refresh();
@@ -252,6 +464,84 @@ void CPUInfoWidget::refreshData() {
     lastUpdateLabel->setText("Last updated: " + now.toString("yyyy-MM-dd hh:mm:ss"));
 }
 
+void CPUInfoWidget::refreshThermalInfo() {
+    thermalInfo.refresh();
+
+    // Update temperatures in place
+    std::vector<TemperatureSensor> sensors = thermalInfo.getSensors();
+    for (size_t i = 0; i < sensors.size() && static_cast<int>(i) < sensorTable->rowCount(); ++i) {
+        const TemperatureSensor &sensor = sensors[i];
+        QTableWidgetItem *tempItem = sensorTable->item(i, 2);
+        if (!tempItem) {
+            continue;
+        }
+
+        if (!sensor.valid) {
+            tempItem->setText("Not available");
+            continue;
+        }
+
+        tempItem->setText(QString::number(sensor.temperatureC, 'f', 1) + " \u00B0C");
+
+        // Highlight sensors approaching their critical trip point
+        if (sensor.criticalC > 0 && sensor.temperatureC >= sensor.criticalC - 10.0) {
+            tempItem->setForeground(Qt::red);
+        } else {
+            tempItem->setForeground(palette().text());
+        }
+    }
+
+    if (!thermalInfo.hasThrottleCounters()) {
+        return;
+    }
+
+    const std::deque<ThrottleRateSample> &history = thermalInfo.getThrottleHistory();
+    double coreRate = history.empty() ? 0.0 : history.back().coreEventsPerSec;
+    double packageRate = history.empty() ? 0.0 : history.back().packageEventsPerSec;
+
+    coreThrottleValue->setText(QString("%1 total (%2/s)")
+                               .arg(thermalInfo.getTotalCoreThrottleCount())
+                               .arg(coreRate, 0, 'f', 2));
+    packageThrottleValue->setText(QString("%1 total (%2/s)")
+                                  .arg(thermalInfo.getTotalPackageThrottleCount())
+                                  .arg(packageRate, 0, 'f', 2));
+
+#ifdef USE_QT_CHARTS
+    if (history.empty()) {
+        return;
+    }
+
+    // Map steady-clock sample times onto wall-clock time for the axis
+    auto steadyNow = std::chrono::steady_clock::now();
+    qint64 wallNow = QDateTime::currentMSecsSinceEpoch();
+
+    QVector<QPointF> corePoints;
+    QVector<QPointF> packagePoints;
+    corePoints.reserve(history.size());
+    packagePoints.reserve(history.size());
+
+    double maxRate = 1.0;
+    for (const auto &sample : history) {
+        qint64 ageMs = std::chrono::duration_cast<std::chrono::milliseconds>(steadyNow - sample.timestamp).count();
+        qreal x = wallNow - ageMs;
+        corePoints.append(QPointF(x, sample.coreEventsPerSec));
+        packagePoints.append(QPointF(x, sample.packageEventsPerSec));
+        maxRate = std::max(maxRate, std::max(sample.coreEventsPerSec, sample.packageEventsPerSec));
+    }
+
+    // One replace() per series instead of a signal per appended point
+    coreThrottleSeries->replace(corePoints);
+    packageThrottleSeries->replace(packagePoints);
+
+    QDateTimeAxis *timeAxis = qobject_cast<QDateTimeAxis*>(throttleChart->axes(Qt::Horizontal).first());
+    timeAxis->setRange(QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(corePoints.first().x())),
+                       QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(corePoints.last().x())));
+
+    QValueAxis *rateAxis = qobject_cast<QValueAxis*>(throttleChart->axes(Qt::Vertical).first());
+    rateAxis->setRange(0, maxRate * 1.1);
+#endif
+}
+
 void CPUInfoWidget::updateCPUInfo() {
     // Update basic CPU information in the UI
     QWidget* basicInfoTab = tabWidget->widget(0); // Get the Basic Info tab
@@ -0,0 +1,89 @@
+#include "deadline_timer.h"
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <ctime>
+
+DeadlineTimer::DeadlineTimer(QObject *parent)
+    : QObject(parent),
+      fd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)),
+      notifier(nullptr),
+      fallbackTimer(nullptr),
+      intervalMs(0),
+      active(false),
+      missedTicks(0) {
+
+    if (fd >= 0) {
+        notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        notifier->setEnabled(false);
+        // activated() is overloaded from Qt 5.15 on; the string form works with every 5.x
+        connect(notifier, SIGNAL(activated(int)), this, SLOT(expired()));
+    } else {
+        fallbackTimer = new QTimer(this);
+        fallbackTimer->setTimerType(Qt::PreciseTimer);
+        connect(fallbackTimer, &QTimer::timeout, this, &DeadlineTimer::timeout);
+    }
+}
+
+DeadlineTimer::~DeadlineTimer() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+void DeadlineTimer::start(int msec) {
+    intervalMs = msec;
+    active = true;
+    if (fallbackTimer) {
+        fallbackTimer->start(msec);
+        return;
+    }
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    itimerspec spec;
+    spec.it_interval.tv_sec = msec / 1000;
+    spec.it_interval.tv_nsec = (msec % 1000) * 1000000L;
+    spec.it_value.tv_sec = now.tv_sec + spec.it_interval.tv_sec;
+    spec.it_value.tv_nsec = now.tv_nsec + spec.it_interval.tv_nsec;
+    if (spec.it_value.tv_nsec >= 1000000000L) {
+        spec.it_value.tv_sec++;
+        spec.it_value.tv_nsec -= 1000000000L;
+    }
+    timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+    notifier->setEnabled(true);
+}
+
+void DeadlineTimer::stop() {
+    active = false;
+    if (fallbackTimer) {
+        fallbackTimer->stop();
+        return;
+    }
+
+    itimerspec spec{};
+    timerfd_settime(fd, 0, &spec, nullptr);
+    notifier->setEnabled(false);
+}
+
+bool DeadlineTimer::isActive() const {
+    return active;
+}
+
+int DeadlineTimer::interval() const {
+    return intervalMs;
+}
+
+uint64_t DeadlineTimer::getMissedTicks() const {
+    return missedTicks;
+}
+
+void DeadlineTimer::expired() {
+    // Number of deadlines since the last read; nothing if stop() won the race
+    uint64_t expirations = 0;
+    if (::read(fd, &expirations, sizeof(expirations)) != sizeof(expirations) || expirations == 0) {
+        return;
+    }
+    missedTicks += expirations - 1;
+    emit timeout();
+}
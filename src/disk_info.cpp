@@ -1,13 +1,37 @@
 #include "disk_info.h"
-#include <sys/statvfs.h>
-#include <mntent.h>
-#include <fstream>
-#include <sstream>
+#include "sample_clock.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <utility>
+#include <unordered_set>
 #include <QDebug>
 
-DiskInfoCollector::DiskInfoCollector() {
+namespace {
+
+const char* const MOUNT_INFO_PATH = "/proc/self/mountinfo";
+
+// Grown as needed; a Kubernetes node with thousands of mounts needs a few MB
+const size_t INITIAL_READ_BUFFER_SIZE = 64 * 1024;
+
+} // namespace
+
+DiskInfoCollector::DiskInfoCollector()
+    : readBuffer(INITIAL_READ_BUFFER_SIZE),
+      mountInfoFd(-1),
+      mountTableReads(0),
+      statvfsPool(8, 32, STATVFS_TIMEOUT_NS) {
     qDebug() << "Initializing DiskInfoCollector...";
     try {
+        // Opening sets the change baseline, so poll() stays quiet until the
+        // table actually changes after the first read
+        mountInfoFd = open(MOUNT_INFO_PATH, O_RDONLY | O_CLOEXEC);
+        if (mountInfoFd < 0) {
+            qWarning() << "Cannot open" << MOUNT_INFO_PATH << ":" << strerror(errno);
+        }
         refresh();
         qDebug() << "DiskInfoCollector initialized successfully.";
     } catch (const std::exception& e) {
@@ -17,6 +41,12 @@ DiskInfoCollector::DiskInfoCollector() {
     }
 }
 
+DiskInfoCollector::~DiskInfoCollector() {
+    if (mountInfoFd >= 0) {
+        close(mountInfoFd);
+    }
+}
+
 void DiskInfoCollector::refresh() {
     disks.clear();
     collectDiskInfo();
@@ -29,41 +59,182 @@ std::vector<DiskInfo> DiskInfoCollector::getDisks() const {
     return disks;
 }
 
+uint64_t DiskInfoCollector::getMountTableReads() const {
+    return mountTableReads;
+}
+
 void DiskInfoCollector::collectDiskInfo() {
-    FILE* mtab = setmntent("/etc/mtab", "r");
-    if (mtab == nullptr) {
-        return;
+    if (mountTableReads == 0 || mountTableChanged()) {
+        if (readMountTable()) {
+            std::unordered_set<int> mountIds;
+            for (const MountEntry& mount : mounts) {
+                mountIds.insert(mount.mountId);
+            }
+            statvfsPool.retain(mountIds);
+        }
     }
 
-    struct mntent* entry;
-    while ((entry = getmntent(mtab)) != nullptr) {
-        // Skip pseudo filesystems
-        std::string fsType = entry->mnt_type;
-        if (fsType == "proc" || fsType == "sysfs" || fsType == "devpts" ||
-            fsType == "tmpfs" || fsType == "devtmpfs" || fsType == "debugfs" ||
-            fsType == "securityfs" || fsType == "cgroup" || fsType == "pstore" ||
-            fsType == "autofs" || fsType == "mqueue" || fsType == "hugetlbfs" ||
-            fsType == "fusectl" || fsType == "fuse.gvfsd-fuse" || fsType == "binfmt_misc") {
+    // Mounts still busy with an earlier call are not asked again; the rest
+    // get until the deadline to answer
+    int64_t start = SampleClock::nowNs();
+    for (const MountEntry& mount : mounts) {
+        statvfsPool.request(mount.mountId, mount.mountPoint);
+    }
+    statvfsPool.wait(start + STATVFS_TIMEOUT_NS);
+    int64_t now = SampleClock::nowNs();
+
+    disks.reserve(mounts.size());
+    for (const MountEntry& mount : mounts) {
+        StatvfsResult result;
+        if (!statvfsPool.getResult(mount.mountId, result)) {
             continue;
         }
 
-        struct statvfs stat;
-        if (statvfs(entry->mnt_dir, &stat) != 0) {
+        // A call that started long ago is stuck in the filesystem. One still
+        // queued behind busy workers is not the mount's fault, but its sizes
+        // are just as stale, so it is shown rather than dropped
+        bool stuck = result.pending && result.startedNs > 0 && now - result.startedNs > STATVFS_TIMEOUT_NS;
+        bool queued = result.pending && result.startedNs == 0 && now - result.queuedNs > STATVFS_TIMEOUT_NS;
+        bool unresponsive = stuck || queued;
+        if (!unresponsive && (!result.valid || result.error != 0)) {
             continue;
         }
 
         DiskInfo disk;
-        disk.device = entry->mnt_fsname;
-        disk.mountPoint = entry->mnt_dir;
-        disk.fsType = entry->mnt_type;
-        disk.totalSize = stat.f_blocks * stat.f_frsize;
-        disk.freeSpace = stat.f_bfree * stat.f_frsize;
-        disk.availableSpace = stat.f_bavail * stat.f_frsize;
+        disk.mountId = mount.mountId;
+        disk.major = mount.major;
+        disk.minor = mount.minor;
+        disk.device = mount.device;
+        disk.mountPoint = mount.mountPoint;
+        disk.fsType = mount.fsType;
+        disk.totalSize = result.valid ? result.totalSize : 0;
+        disk.freeSpace = result.valid ? result.freeSpace : 0;
+        disk.availableSpace = result.valid ? result.availableSpace : 0;
+        disk.sampledNs = result.valid ? result.sampledNs : 0;
+        disk.unresponsive = unresponsive;
+        disk.queued = queued;
+        disk.stalledNs = stuck ? now - result.startedNs : queued ? now - result.queuedNs : 0;
 
         disks.push_back(disk);
     }
+}
+
+bool DiskInfoCollector::mountTableChanged() const {
+    if (mountInfoFd < 0) {
+        return false;
+    }
+
+    // Reporting the event also acknowledges it, so a mount that happens
+    // while the table is being read shows up on the next poll
+    pollfd pfd = {mountInfoFd, POLLPRI, 0};
+    int ready;
+    do {
+        ready = poll(&pfd, 1, 0);
+    } while (ready < 0 && errno == EINTR);
+    return ready > 0 && (pfd.revents & (POLLPRI | POLLERR));
+}
+
+bool DiskInfoCollector::readMountTable() {
+    if (mountInfoFd < 0) {
+        return false;
+    }
+
+    // seq_file reads are cheapest sequentially from the start
+    if (lseek(mountInfoFd, 0, SEEK_SET) < 0) {
+        return false;
+    }
+    size_t length = 0;
+    for (;;) {
+        if (length + 1 >= readBuffer.size()) {
+            readBuffer.resize(readBuffer.size() * 2);
+        }
+        ssize_t n = read(mountInfoFd, readBuffer.data() + length, readBuffer.size() - 1 - length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        length += n;
+    }
+    readBuffer[length] = '\0';
+
+    // "36 35 98:0 /mnt1 /mnt2 rw,noatime master:1 - ext3 /dev/root rw,errors=continue"
+    mounts.clear();
+    for (const char* line = readBuffer.data(); *line; ) {
+        const char* lineEnd = strchr(line, '\n');
+        if (!lineEnd) {
+            lineEnd = line + strlen(line);
+        }
+
+        // Five fixed fields, optional ones up to a lone "-", then the
+        // filesystem type and source
+        const char* fields[7];
+        const char* fieldEnds[7];
+        int count = 0;
+        bool afterSeparator = false;
+        for (const char* p = line; p < lineEnd && count < 7; ) {
+            const char* end = static_cast<const char*>(memchr(p, ' ', lineEnd - p));
+            if (!end) {
+                end = lineEnd;
+            }
+            if (count < 5 || afterSeparator) {
+                fields[count] = p;
+                fieldEnds[count] = end;
+                count++;
+            } else if (end - p == 1 && *p == '-') {
+                afterSeparator = true;
+            }
+            p = end + 1;
+        }
+
+        if (count == 7) {
+            std::string fsType(fields[5], fieldEnds[5]);
+            if (!isPseudoFilesystem(fsType)) {
+                MountEntry mount;
+                mount.mountId = atoi(fields[0]);
+                char* minor = nullptr;
+                mount.major = static_cast<unsigned int>(strtoul(fields[2], &minor, 10));
+                mount.minor = *minor == ':' ? static_cast<unsigned int>(strtoul(minor + 1, nullptr, 10)) : 0;
+                mount.mountPoint = unescapeField(fields[4], fieldEnds[4]);
+                mount.fsType = std::move(fsType);
+                mount.device = unescapeField(fields[6], fieldEnds[6]);
+                mounts.push_back(std::move(mount));
+            }
+        }
 
-    endmntent(mtab);
+        line = *lineEnd ? lineEnd + 1 : lineEnd;
+    }
+
+    mountTableReads++;
+    return true;
+}
+
+bool DiskInfoCollector::isPseudoFilesystem(const std::string& fsType) {
+    return fsType == "proc" || fsType == "sysfs" || fsType == "devpts" ||
+           fsType == "tmpfs" || fsType == "devtmpfs" || fsType == "debugfs" ||
+           fsType == "securityfs" || fsType == "cgroup" || fsType == "pstore" ||
+           fsType == "autofs" || fsType == "mqueue" || fsType == "hugetlbfs" ||
+           fsType == "fusectl" || fsType == "fuse.gvfsd-fuse" || fsType == "binfmt_misc";
+}
+
+// Spaces, tabs, newlines and backslashes in paths are written as \ooo
+std::string DiskInfoCollector::unescapeField(const char* begin, const char* end) {
+    std::string field;
+    field.reserve(end - begin);
+    for (const char* p = begin; p < end; ++p) {
+        if (*p == '\\' && end - p >= 4 &&
+            p[1] >= '0' && p[1] <= '3' && p[2] >= '0' && p[2] <= '7' && p[3] >= '0' && p[3] <= '7') {
+            field += static_cast<char>((p[1] - '0') * 64 + (p[2] - '0') * 8 + (p[3] - '0'));
+            p += 3;
+        } else {
+            field += *p;
+        }
+    }
+    return field;
 }
 
 std::string DiskInfoCollector::formatSize(uint64_t size) const {
@@ -90,6 +261,14 @@ void DiskInfoCollector::printAllInfo() const {
         std::cout << "Mount Point: " << disk.mountPoint << std::endl;
         std::cout << "File System: " << disk.fsType << std::endl;
 
+        if (disk.unresponsive) {
+            std::cout << "Status: not responding for " << disk.stalledNs / 1000000000 << " s" << std::endl;
+            if (disk.sampledNs == 0) {
+                std::cout << std::endl;
+                continue;
+            }
+        }
+
         std::cout << "Total Size: " << formatSize(disk.totalSize) << std::endl;
         std::cout << "Free Space: " << formatSize(disk.freeSpace) << std::endl;
         std::cout << "Available Space: " << formatSize(disk.availableSpace) << std::endl;
@@ -0,0 +1,225 @@
+#include "disk_stats.h"
+#include "sample_clock.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+namespace {
+
+// About 150 bytes per device; grown when a read fills it
+const size_t INITIAL_BUFFER_SIZE = 64 * 1024;
+
+// /proc/diskstats always counts 512-byte sectors
+const double SECTOR_SIZE = 512.0;
+
+// Field positions after the device name
+enum {
+    READS, READS_MERGED, SECTORS_READ, READ_MS,
+    WRITES, WRITES_MERGED, SECTORS_WRITTEN, WRITE_MS,
+    IN_FLIGHT, IO_MS, WEIGHTED_IO_MS,
+    DISCARDS, DISCARDS_MERGED, SECTORS_DISCARDED, DISCARD_MS,
+    FLUSHES, FLUSH_MS
+};
+
+// Counters are unsigned long in the kernel and may be 32 bits wide, and
+// a device that is removed and re-added starts from zero
+uint64_t delta(uint64_t current, uint64_t previous) {
+    return current >= previous ? current - previous : 0;
+}
+
+double perRequest(uint64_t ms, uint64_t requests) {
+    return requests > 0 ? static_cast<double>(ms) / requests : 0.0;
+}
+
+uint64_t deviceKey(unsigned int major, unsigned int minor) {
+    return static_cast<uint64_t>(major) << 32 | minor;
+}
+
+} // namespace
+
+DiskStatsCollector::DiskStatsCollector(size_t historySamples)
+    : statsFile("/proc/diskstats"),
+      buffer(INITIAL_BUFFER_SIZE),
+      historySamples(historySamples),
+      generation(0),
+      previousNs(0),
+      fieldCount(0),
+      lastParseUs(0.0) {
+    refresh();
+}
+
+bool DiskStatsCollector::isAvailable() const {
+    return statsFile.isOpen();
+}
+
+const std::vector<BlockDeviceStats>& DiskStatsCollector::getDevices() const {
+    return devices;
+}
+
+const std::deque<BlockDeviceSample>* DiskStatsCollector::getHistory(const std::string& name) const {
+    auto key = keysByName.find(name);
+    if (key == keysByName.end()) {
+        return nullptr;
+    }
+    auto slot = slots.find(key->second);
+    return slot != slots.end() && slot->second.stats.everActive ? &slot->second.history : nullptr;
+}
+
+bool DiskStatsCollector::hasDiscardStats() const {
+    return fieldCount > DISCARD_MS;
+}
+
+bool DiskStatsCollector::hasFlushStats() const {
+    return fieldCount > FLUSH_MS;
+}
+
+double DiskStatsCollector::getLastParseUs() const {
+    return lastParseUs;
+}
+
+bool DiskStatsCollector::readFile() {
+    for (;;) {
+        ssize_t length = statsFile.read(buffer.data(), buffer.size());
+        if (length < 0) {
+            return false;
+        }
+        // A full buffer may have cut the file short
+        if (static_cast<size_t>(length) < buffer.size() - 1) {
+            return true;
+        }
+        buffer.resize(buffer.size() * 2);
+    }
+}
+
+void DiskStatsCollector::refresh() {
+    if (!statsFile.isOpen() || !readFile()) {
+        return;
+    }
+
+    int64_t now = SampleClock::nowNs();
+    double elapsedMs = previousNs > 0 ? (now - previousNs) / 1e6 : 0.0;
+    previousNs = now;
+    generation++;
+    devices.clear();
+
+    // "   8       0 sda 2136 465 159818 1044 ... " one device per line
+    for (const char* line = buffer.data(); *line; ) {
+        char* p = nullptr;
+        unsigned int major = static_cast<unsigned int>(strtoul(line, &p, 10));
+        unsigned int minor = static_cast<unsigned int>(strtoul(p, &p, 10));
+        while (*p == ' ') {
+            ++p;
+        }
+        const char* name = p;
+        while (*p && *p != ' ' && *p != '\n') {
+            ++p;
+        }
+        size_t nameLength = p - name;
+
+        uint64_t counters[FIELD_COUNT] = {};
+        int count = 0;
+        while (count < FIELD_COUNT && *p && *p != '\n') {
+            char* end = nullptr;
+            uint64_t value = strtoull(p, &end, 10);
+            if (end == p) {
+                break;
+            }
+            counters[count++] = value;
+            p = end;
+        }
+
+        if (nameLength > 0 && count > IO_MS) {
+            fieldCount = std::max(fieldCount, count);
+            uint64_t key = deviceKey(major, minor);
+            auto inserted = slots.try_emplace(key);
+            Slot& slot = inserted.first->second;
+            if (inserted.second || slot.stats.name.compare(0, std::string::npos, name, nameLength) != 0) {
+                // New device, or a device number reused under another name
+                if (!inserted.second) {
+                    keysByName.erase(slot.stats.name);
+                }
+                slot = Slot{};
+                slot.stats.name.assign(name, nameLength);
+                slot.stats.major = major;
+                slot.stats.minor = minor;
+                keysByName[slot.stats.name] = key;
+                updateSlot(slot, counters, count, 0.0, now);
+            } else {
+                updateSlot(slot, counters, count, elapsedMs, now);
+            }
+            slot.seenGeneration = generation;
+            devices.push_back(slot.stats);
+        }
+
+        const char* next = strchr(p, '\n');
+        if (!next) {
+            break;
+        }
+        line = next + 1;
+    }
+
+    // Devices that went away
+    for (auto it = slots.begin(); it != slots.end(); ) {
+        if (it->second.seenGeneration == generation) {
+            ++it;
+            continue;
+        }
+        keysByName.erase(it->second.stats.name);
+        it = slots.erase(it);
+    }
+
+    lastParseUs = (SampleClock::nowNs() - now) / 1e3;
+}
+
+void DiskStatsCollector::updateSlot(Slot& slot, const uint64_t* counters, int count, double elapsedMs,
+                                    int64_t now) {
+    BlockDeviceStats& stats = slot.stats;
+    const uint64_t* previous = slot.counters;
+    stats.inFlight = counters[IN_FLIGHT];
+    stats.everActive = counters[READS] + counters[WRITES] + counters[DISCARDS] > 0;
+    stats.sampled = elapsedMs > 0.0;
+
+    if (stats.sampled) {
+        double seconds = elapsedMs / 1000.0;
+        uint64_t reads = delta(counters[READS], previous[READS]);
+        uint64_t writes = delta(counters[WRITES], previous[WRITES]);
+        uint64_t discards = delta(counters[DISCARDS], previous[DISCARDS]);
+        uint64_t flushes = delta(counters[FLUSHES], previous[FLUSHES]);
+
+        stats.readIops = reads / seconds;
+        stats.writeIops = writes / seconds;
+        stats.discardIops = discards / seconds;
+        stats.flushIops = flushes / seconds;
+        stats.readBytesPerSec = delta(counters[SECTORS_READ], previous[SECTORS_READ]) * SECTOR_SIZE / seconds;
+        stats.writeBytesPerSec = delta(counters[SECTORS_WRITTEN], previous[SECTORS_WRITTEN]) * SECTOR_SIZE / seconds;
+        stats.discardBytesPerSec =
+            delta(counters[SECTORS_DISCARDED], previous[SECTORS_DISCARDED]) * SECTOR_SIZE / seconds;
+
+        stats.readAwaitMs = perRequest(delta(counters[READ_MS], previous[READ_MS]), reads);
+        stats.writeAwaitMs = perRequest(delta(counters[WRITE_MS], previous[WRITE_MS]), writes);
+        stats.discardAwaitMs = perRequest(delta(counters[DISCARD_MS], previous[DISCARD_MS]), discards);
+        stats.flushAwaitMs = perRequest(delta(counters[FLUSH_MS], previous[FLUSH_MS]), flushes);
+
+        stats.queueDepth = delta(counters[WEIGHTED_IO_MS], previous[WEIGHTED_IO_MS]) / elapsedMs;
+        stats.utilization = std::min(100.0, delta(counters[IO_MS], previous[IO_MS]) * 100.0 / elapsedMs);
+
+        // Idle devices that never did I/O, such as unused loop devices,
+        // need no history
+        if (stats.everActive && historySamples > 0) {
+            if (slot.history.size() >= historySamples) {
+                slot.history.pop_front();
+            }
+            slot.history.push_back(BlockDeviceSample{
+                now,
+                static_cast<float>(stats.readBytesPerSec),
+                static_cast<float>(stats.writeBytesPerSec),
+                static_cast<float>(stats.readAwaitMs),
+                static_cast<float>(stats.writeAwaitMs),
+                static_cast<float>(stats.queueDepth),
+                static_cast<float>(stats.utilization)});
+        }
+    }
+
+    std::copy(counters, counters + count, slot.counters);
+    std::fill(slot.counters + count, slot.counters + FIELD_COUNT, 0);
+}
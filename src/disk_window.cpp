@@ -1,12 +1,116 @@
 #include "disk_window.h"
-
-DiskWindow::DiskWindow(QWidget *parent) : QWidget(parent) {
+#include "numeric_table_item.h"
+#include "forecast_label.h"
+#include <QHeaderView>
+#include <QDateTime>
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QSignalBlocker>
+#include <QBrush>
+#include <QColor>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// Rows shown in the Process I/O table, busiest first
+const int MAX_PROCESS_IO_ROWS = 200;
+
+const double MB = 1024.0 * 1024.0;
+
+// Deeper than any real stack; guards against a loop in holders/slaves
+const int MAX_TOPOLOGY_DEPTH = 8;
+
+} // namespace
+
+DiskWindow::DiskWindow(QWidget *parent)
+    : QWidget(parent),
+      lastForecastNs(0),
+#ifdef USE_QT_CHARTS
+      throughputPoints(DiskStatsCollector::HISTORY_SAMPLES),
+      latencyPoints(DiskStatsCollector::HISTORY_SAMPLES),
+      utilizationPoints(DiskStatsCollector::HISTORY_SAMPLES),
+      throughputAxisMax(1.0),
+      latencyAxisMax(1.0),
+#endif
+      topologyMountReads(0),
+      autoRefreshEnabled(true) {
     setupUI();
+
+    // Set up auto-refresh timer (every 2 seconds), running only while the
+    // Process I/O tab is shown
+    autoRefreshTimer = new DeadlineTimer(this);
+    connect(autoRefreshTimer, &DeadlineTimer::timeout, this, &DiskWindow::refreshProcessIo);
+
+    filesystemTimer = new DeadlineTimer(this);
+    connect(filesystemTimer, &DeadlineTimer::timeout, this, &DiskWindow::refreshFilesystems);
+    filesystemTimer->start(FILESYSTEM_INTERVAL_MS);
+    refreshFilesystems();
+
+    // The collector took the baseline sample when it was created
+    blockDeviceTimer = new DeadlineTimer(this);
+    connect(blockDeviceTimer, &DeadlineTimer::timeout, this, &DiskWindow::refreshBlockDevices);
+    blockDeviceTimer->start(BLOCK_DEVICE_INTERVAL_MS);
+
+    // After refreshFilesystems(), so a changed mount table is seen
+    connect(filesystemTimer, &DeadlineTimer::timeout, this, &DiskWindow::refreshTopology);
 }
 
 void DiskWindow::setupUI() {
-    QVBoxLayout *layout = new QVBoxLayout(this);
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    tabWidget = new QTabWidget(this);
+
+    QWidget *filesystemTab = new QWidget(tabWidget);
+    setupFilesystemTab(filesystemTab);
+    tabWidget->addTab(filesystemTab, "Filesystems");
+
+    blockDeviceTab = new QWidget(tabWidget);
+    setupBlockDeviceTab(blockDeviceTab);
+    tabWidget->addTab(blockDeviceTab, "Block Devices");
+
+    topologyTab = new QWidget(tabWidget);
+    setupTopologyTab(topologyTab);
+    tabWidget->addTab(topologyTab, "Topology");
+
+    processIoTab = new QWidget(tabWidget);
+    setupProcessIoTab(processIoTab);
+    tabWidget->addTab(processIoTab, "Process I/O");
+
+    connect(tabWidget, &QTabWidget::currentChanged, this, &DiskWindow::tabChanged);
+    mainLayout->addWidget(tabWidget);
+}
+
+void DiskWindow::setupFilesystemTab(QWidget *tab) {
+    QVBoxLayout *layout = new QVBoxLayout(tab);
+
+    QFont titleFont = font();
+    titleFont.setPointSize(12);
+    titleFont.setBold(true);
+
+    noDisksLabel = new QLabel("No disk information available", tab);
+    noDisksLabel->setFont(titleFont);
+    noDisksLabel->setVisible(false);
+    layout->addWidget(noDisksLabel);
+
+    // Create a scroll area for many disks
+    QScrollArea *scrollArea = new QScrollArea(tab);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setFrameShape(QFrame::NoFrame);
+
+    mountContent = new QWidget(scrollArea);
+    mountLayout = new QVBoxLayout(mountContent);
+
+    // Add stretch to push everything to the top; groups go in before it
+    mountLayout->addStretch();
 
+    // Set the scroll content and add to layout
+    scrollArea->setWidget(mountContent);
+    layout->addWidget(scrollArea);
+}
+
+DiskWindow::MountGroup DiskWindow::createMountGroup(const DiskInfo &disk) {
     QFont titleFont = font();
     titleFont.setPointSize(12);
     titleFont.setBold(true);
@@ -14,144 +118,731 @@ void DiskWindow::setupUI() {
     QFont valueFont = font();
     valueFont.setPointSize(10);
 
-    // Get disk information
+    MountGroup group{};
+    group.major = disk.major;
+    group.minor = disk.minor;
+    group.mountPoint = disk.mountPoint;
+    group.box = new QGroupBox(QString::fromStdString(disk.device), mountContent);
+    QVBoxLayout *diskLayout = new QVBoxLayout(group.box);
+
+    // Create a grid layout for disk details
+    QGridLayout *gridLayout = new QGridLayout();
+    diskLayout->addLayout(gridLayout);
+
+    // Label in the first column, value in the second
+    int row = 0;
+    auto addRow = [&](const char *title) {
+        QLabel *label = new QLabel(title, group.box);
+        label->setFont(titleFont);
+        gridLayout->addWidget(label, row, 0);
+
+        QLabel *value = new QLabel(group.box);
+        value->setFont(valueFont);
+        gridLayout->addWidget(value, row, 1);
+        row++;
+        return value;
+    };
+
+    group.mountValue = addRow("Mount Point:");
+    group.mountValue->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    group.fsValue = addRow("File System:");
+    group.totalValue = addRow("Total Size:");
+    group.freeValue = addRow("Free Space:");
+    group.availValue = addRow("Available Space:");
+    group.usedValue = addRow("Used Space:");
+    group.usageValue = addRow("Usage:");
+
+    // Add a progress bar for visual representation
+    group.usageBar = new QProgressBar(group.box);
+    group.usageBar->setMinimum(0);
+    group.usageBar->setMaximum(100);
+    diskLayout->addWidget(group.usageBar);
+
+    // Where the trend of available space leads
+    group.forecastLabel = new QLabel(group.box);
+    group.forecastLabel->setFont(valueFont);
+    diskLayout->addWidget(group.forecastLabel);
+
+    // A hung network filesystem keeps its last sizes and says so here
+    group.stalledLabel = new QLabel(group.box);
+    group.stalledLabel->setFont(valueFont);
+    group.stalledLabel->setStyleSheet("color: red;");
+    group.stalledLabel->setVisible(false);
+    diskLayout->addWidget(group.stalledLabel);
+
+    // Set column stretch to make the value column expand
+    gridLayout->setColumnStretch(1, 1);
+
+    return group;
+}
+
+bool DiskWindow::isSameMount(const MountGroup &group, const DiskInfo &disk) {
+    return group.major == disk.major && group.minor == disk.minor && group.mountPoint == disk.mountPoint;
+}
+
+void DiskWindow::updateMountGroup(MountGroup &group, const DiskInfo &disk) {
+    auto setText = [](QLabel *label, const QString &text) {
+        if (label->text() != text) {
+            label->setText(text);
+        }
+    };
+
+    uint64_t usedSpace = disk.totalSize - disk.freeSpace;
+    double usagePercent = disk.totalSize > 0 ? static_cast<double>(usedSpace) / disk.totalSize * 100.0 : 0.0;
+
+    QString device = QString::fromStdString(disk.device);
+    if (group.box->title() != device) {
+        group.box->setTitle(device);
+    }
+    setText(group.mountValue, QString::fromStdString(disk.mountPoint));
+    setText(group.fsValue, QString::fromStdString(disk.fsType));
+    setText(group.totalValue, formatSize(disk.totalSize));
+    setText(group.freeValue, formatSize(disk.freeSpace));
+    setText(group.availValue, formatSize(disk.availableSpace));
+    setText(group.usedValue, formatSize(usedSpace));
+    setText(group.usageValue, QString("%1%").arg(usagePercent, 0, 'f', 2));
+    group.usageBar->setValue(static_cast<int>(usagePercent));
+
+    // Set color based on usage; restyling is costly, so only on a change
+    QString styleSheet;
+    if (usagePercent < 70) {
+        styleSheet = "QProgressBar::chunk { background-color: green; }";
+    } else if (usagePercent < 90) {
+        styleSheet = "QProgressBar::chunk { background-color: orange; }";
+    } else {
+        styleSheet = "QProgressBar::chunk { background-color: red; }";
+    }
+    if (group.usageBar->styleSheet() != styleSheet) {
+        group.usageBar->setStyleSheet(styleSheet);
+    }
+
+    if (disk.unresponsive) {
+        // Queued calls wait behind workers stuck in other mounts
+        QString stalled = QString(disk.queued ? "Waiting behind hung mounts for %1" : "Unresponsive for %1")
+                              .arg(QString::fromStdString(TrendEstimator::formatDuration(disk.stalledNs / 1e9)));
+        if (disk.sampledNs > 0) {
+            double age = (SampleClock::nowNs() - disk.sampledNs) / 1e9;
+            setText(group.stalledLabel, QString("%1, sizes are from %2 ago")
+                                            .arg(stalled)
+                                            .arg(QString::fromStdString(TrendEstimator::formatDuration(age))));
+        } else {
+            setText(group.stalledLabel, QString("%1, no sizes yet").arg(stalled));
+        }
+    }
+    if (group.stalledLabel->isHidden() == disk.unresponsive) {
+        group.stalledLabel->setVisible(disk.unresponsive);
+    }
+}
+
+void DiskWindow::refreshFilesystems() {
+    diskInfo.refresh();
     std::vector<DiskInfo> disks = diskInfo.getDisks();
 
-    if (disks.empty()) {
-        QLabel *noDisksLabel = new QLabel("No disk information available", this);
-        noDisksLabel->setFont(titleFont);
-        layout->addWidget(noDisksLabel);
-        layout->addStretch();
-        return;
+    int64_t now = SampleClock::nowNs();
+    bool forecastDue = now - lastForecastNs >= FORECAST_INTERVAL_NS;
+    if (forecastDue) {
+        lastForecastNs = now;
     }
 
-    // Create a scroll area for many disks
-    QScrollArea *scrollArea = new QScrollArea(this);
-    scrollArea->setWidgetResizable(true);
-    scrollArea->setFrameShape(QFrame::NoFrame);
+    // Groups of mounts that went away, or whose ID now names another mount
+    std::unordered_map<int, const DiskInfo *> mounted;
+    for (const DiskInfo &disk : disks) {
+        mounted.emplace(disk.mountId, &disk);
+    }
+    bool structureChanged = false;
+    for (auto it = mountGroups.begin(); it != mountGroups.end(); ) {
+        auto current = mounted.find(it->first);
+        if (current != mounted.end() && isSameMount(it->second, *current->second)) {
+            ++it;
+            continue;
+        }
+        if (!structureChanged) {
+            mountContent->setUpdatesEnabled(false);
+            structureChanged = true;
+        }
+        mountLayout->removeWidget(it->second.box);
+        it->second.box->deleteLater();
+        it = mountGroups.erase(it);
+    }
+
+    // New mounts are inserted where they appear in the mount table
+    int position = 0;
+    for (const DiskInfo &disk : disks) {
+        auto found = mountGroups.find(disk.mountId);
+        if (found == mountGroups.end()) {
+            if (!structureChanged) {
+                mountContent->setUpdatesEnabled(false);
+                structureChanged = true;
+            }
+            found = mountGroups.emplace(disk.mountId, createMountGroup(disk)).first;
+            mountLayout->insertWidget(position, found->second.box);
+        }
+        position++;
+
+        MountGroup &group = found->second;
+        updateMountGroup(group, disk);
+        // Old sizes from a hung mount would flatten the trend
+        if (forecastDue && !disk.unresponsive) {
+            group.trend.add(SampleClock::toSeconds(now), static_cast<double>(disk.availableSpace));
+            setForecastLabel(group.forecastLabel, group.trend.forecast(0.0),
+                             QString::fromStdString(disk.mountPoint), "six hours");
+        }
+    }
+
+    if (structureChanged) {
+        mountContent->setUpdatesEnabled(true);
+    }
+    noDisksLabel->setVisible(mountGroups.empty());
+}
 
-    QWidget *scrollContent = new QWidget(scrollArea);
-    QVBoxLayout *scrollLayout = new QVBoxLayout(scrollContent);
+void DiskWindow::setupBlockDeviceTab(QWidget *tab) {
+    QVBoxLayout *layout = new QVBoxLayout(tab);
+
+    blockDeviceTable = new QTableWidget(tab);
+    blockDeviceTable->setObjectName("blockDeviceTable");
+    blockDeviceTable->setColumnCount(BlockDeviceColumnCount);
+    blockDeviceTable->setHorizontalHeaderLabels({"Device", "r/s", "w/s", "Read/s", "Write/s", "r_await", "w_await",
+                                                 "aqu-sz", "%util", "d/s", "Discard/s", "d_await", "f/s", "f_await"});
+    blockDeviceTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    blockDeviceTable->horizontalHeader()->setSectionResizeMode(DeviceColumn, QHeaderView::Stretch);
+    blockDeviceTable->verticalHeader()->setVisible(false);
+    blockDeviceTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    blockDeviceTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    blockDeviceTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    blockDeviceTable->setAlternatingRowColors(true);
+    blockDeviceTable->setSortingEnabled(true);
+    blockDeviceTable->sortByColumn(UtilizationColumn, Qt::DescendingOrder);
+
+    blockDeviceTable->horizontalHeaderItem(ReadAwaitColumn)->setToolTip("Average time per completed read, queueing included");
+    blockDeviceTable->horizontalHeaderItem(WriteAwaitColumn)->setToolTip("Average time per completed write, queueing included");
+    blockDeviceTable->horizontalHeaderItem(QueueDepthColumn)->setToolTip("Average number of requests queued or in service");
+    blockDeviceTable->horizontalHeaderItem(UtilizationColumn)->setToolTip(
+        "Share of time with at least one request in flight; devices that serve requests in parallel "
+        "(SSDs, RAID, dm) can be at 100% and still have headroom");
+    blockDeviceTable->horizontalHeaderItem(FlushAwaitColumn)->setToolTip("Average time per cache flush");
+
+    // Older kernels lack the discard (4.18) and flush (5.5) fields
+    for (int column = DiscardIopsColumn; column <= DiscardAwaitColumn; ++column) {
+        blockDeviceTable->setColumnHidden(column, !diskStats.hasDiscardStats());
+    }
+    for (int column = FlushIopsColumn; column <= FlushAwaitColumn; ++column) {
+        blockDeviceTable->setColumnHidden(column, !diskStats.hasFlushStats());
+    }
+    connect(blockDeviceTable, &QTableWidget::itemSelectionChanged, this, &DiskWindow::blockDeviceSelectionChanged);
+    layout->addWidget(blockDeviceTable, 1);
+
+#ifdef USE_QT_CHARTS
+    // History of the selected device, one chart per unit
+    auto createChart = [this](const QString &valueTitle, RollingLineSeries &points, const QStringList &names,
+                              QChart *&chart, QChartView *&view) {
+        chart = new QChart();
+        chart->legend()->setVisible(names.size() > 1);
+        chart->legend()->setAlignment(Qt::AlignBottom);
+
+        QDateTimeAxis *timeAxis = new QDateTimeAxis;
+        timeAxis->setFormat("hh:mm:ss");
+        chart->addAxis(timeAxis, Qt::AlignBottom);
+
+        QValueAxis *valueAxis = new QValueAxis;
+        valueAxis->setTitleText(valueTitle);
+        valueAxis->setLabelFormat("%.1f");
+        valueAxis->setRange(0, 1);
+        chart->addAxis(valueAxis, Qt::AlignLeft);
+
+        for (const QString &name : names) {
+            QLineSeries *series = new QLineSeries(chart);
+            series->setName(name);
+            chart->addSeries(series);
+            series->attachAxis(timeAxis);
+            series->attachAxis(valueAxis);
+            points.addSeries(series);
+        }
+        points.setTimeAxis(timeAxis);
+        points.setWindowMsecs(static_cast<qint64>(DiskStatsCollector::HISTORY_SAMPLES) * BLOCK_DEVICE_INTERVAL_MS);
 
-    // Format size helper function
-    auto formatSize = [](uint64_t size) -> QString {
-        const char* units[] = {"B", "KB", "MB", "GB", "TB"};
-        int unitIndex = 0;
-        double formattedSize = static_cast<double>(size);
+        view = new QChartView(chart, this);
+        view->setRenderHint(QPainter::Antialiasing);
+        view->setMinimumHeight(200);
+        return valueAxis;
+    };
+
+    createChart("MB/s", throughputPoints, {"Read", "Write"}, throughputChart, throughputChartView);
+    createChart("ms", latencyPoints, {"Read await", "Write await"}, latencyChart, latencyChartView);
+    QValueAxis *utilizationAxis = createChart("Percent", utilizationPoints, {"%util"}, utilizationChart,
+                                              utilizationChartView);
+    utilizationAxis->setRange(0, 100);
+
+    QHBoxLayout *chartLayout = new QHBoxLayout();
+    chartLayout->addWidget(throughputChartView);
+    chartLayout->addWidget(latencyChartView);
+    chartLayout->addWidget(utilizationChartView);
+    layout->addLayout(chartLayout);
+#endif
+
+    QHBoxLayout *controlLayout = new QHBoxLayout();
+
+    // Unused loop and ram devices would otherwise fill the table
+    showIdleDevicesCheckbox = new QCheckBox("Show devices without I/O", tab);
+    connect(showIdleDevicesCheckbox, &QCheckBox::toggled, this, &DiskWindow::updateBlockDeviceTable);
+    controlLayout->addWidget(showIdleDevicesCheckbox);
+    controlLayout->addStretch();
+
+    blockDeviceSummaryLabel = new QLabel(tab);
+    controlLayout->addWidget(blockDeviceSummaryLabel);
+    layout->addLayout(controlLayout);
+}
 
-        while (formattedSize >= 1024.0 && unitIndex < 4) {
-            formattedSize /= 1024.0;
-            unitIndex++;
+void DiskWindow::refreshBlockDevices() {
+    diskStats.refresh();
+
+#ifdef USE_QT_CHARTS
+    const std::deque<BlockDeviceSample> *history = diskStats.getHistory(selectedDevice);
+    if (history && !history->empty()) {
+        const BlockDeviceSample &sample = history->back();
+        qint64 msecs = SampleClock::toWallMsecs(sample.timeNs);
+        throughputPoints.append(msecs, {sample.readBytesPerSec / MB, sample.writeBytesPerSec / MB});
+        latencyPoints.append(msecs, {sample.readAwaitMs, sample.writeAwaitMs});
+        utilizationPoints.append(msecs, {sample.utilization});
+
+        // Axes only grow between reloads
+        double throughput = std::max(sample.readBytesPerSec, sample.writeBytesPerSec) / MB;
+        if (throughput > throughputAxisMax) {
+            throughputAxisMax = throughput * 1.2;
+            qobject_cast<QValueAxis*>(throughputChart->axes(Qt::Vertical).first())->setRange(0, throughputAxisMax);
         }
+        double latency = std::max(sample.readAwaitMs, sample.writeAwaitMs);
+        if (latency > latencyAxisMax) {
+            latencyAxisMax = latency * 1.2;
+            qobject_cast<QValueAxis*>(latencyChart->axes(Qt::Vertical).first())->setRange(0, latencyAxisMax);
+        }
+    }
+#endif
+
+    if (tabWidget->currentWidget() == blockDeviceTab) {
+        updateBlockDeviceTable();
+    }
+}
 
-        return QString("%1 %2").arg(formattedSize, 0, 'f', 2).arg(units[unitIndex]);
+void DiskWindow::updateBlockDeviceTable() {
+    const std::vector<BlockDeviceStats> &devices = diskStats.getDevices();
+    bool showIdle = showIdleDevicesCheckbox->isChecked();
+    std::vector<const BlockDeviceStats*> shown;
+    shown.reserve(devices.size());
+    for (const BlockDeviceStats &device : devices) {
+        if (showIdle || device.everActive) {
+            shown.push_back(&device);
+        }
+    }
+
+    // Rebuilding the rows must not look like the user picking another device
+    QSignalBlocker blocker(blockDeviceTable);
+    blockDeviceTable->setSortingEnabled(false);
+    blockDeviceTable->clearContents();
+    blockDeviceTable->setRowCount(static_cast<int>(shown.size()));
+
+    auto setCell = [this](int row, int column, const QString &text, double value) {
+        QTableWidgetItem *item = new NumericTableItem();
+        item->setText(text);
+        item->setData(Qt::UserRole, value);
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        blockDeviceTable->setItem(row, column, item);
+        return item;
     };
+    auto setRate = [&](int row, int column, double bytesPerSec) {
+        setCell(row, column, formatSize(static_cast<uint64_t>(bytesPerSec)) + "/s", bytesPerSec);
+    };
+
+    for (int row = 0; row < static_cast<int>(shown.size()); ++row) {
+        const BlockDeviceStats &device = *shown[row];
+        QTableWidgetItem *nameItem = new QTableWidgetItem(QString::fromStdString(device.name));
+        nameItem->setToolTip(QString("%1:%2, %3 in flight").arg(device.major).arg(device.minor).arg(device.inFlight));
+        blockDeviceTable->setItem(row, DeviceColumn, nameItem);
+
+        if (!device.sampled) {
+            for (int column = ReadIopsColumn; column < BlockDeviceColumnCount; ++column) {
+                setCell(row, column, "-", -1.0);
+            }
+            continue;
+        }
+
+        setCell(row, ReadIopsColumn, QString::number(device.readIops, 'f', 1), device.readIops);
+        setCell(row, WriteIopsColumn, QString::number(device.writeIops, 'f', 1), device.writeIops);
+        setRate(row, ReadThroughputColumn, device.readBytesPerSec);
+        setRate(row, WriteThroughputColumn, device.writeBytesPerSec);
+        setCell(row, ReadAwaitColumn, QString::number(device.readAwaitMs, 'f', 2), device.readAwaitMs);
+        setCell(row, WriteAwaitColumn, QString::number(device.writeAwaitMs, 'f', 2), device.writeAwaitMs);
+        setCell(row, QueueDepthColumn, QString::number(device.queueDepth, 'f', 2), device.queueDepth);
+        QTableWidgetItem *utilizationItem =
+            setCell(row, UtilizationColumn, QString::number(device.utilization, 'f', 1), device.utilization);
+        if (device.utilization >= 90.0) {
+            utilizationItem->setForeground(QBrush(QColor("red")));
+        } else if (device.utilization >= 70.0) {
+            utilizationItem->setForeground(QBrush(QColor("orange")));
+        }
+        setCell(row, DiscardIopsColumn, QString::number(device.discardIops, 'f', 1), device.discardIops);
+        setRate(row, DiscardThroughputColumn, device.discardBytesPerSec);
+        setCell(row, DiscardAwaitColumn, QString::number(device.discardAwaitMs, 'f', 2), device.discardAwaitMs);
+        setCell(row, FlushIopsColumn, QString::number(device.flushIops, 'f', 1), device.flushIops);
+        setCell(row, FlushAwaitColumn, QString::number(device.flushAwaitMs, 'f', 2), device.flushAwaitMs);
+    }
+
+    blockDeviceTable->setSortingEnabled(true);
 
-    // Add each disk as a group box
-    for (const auto& disk : disks) {
-        QGroupBox *diskGroup = new QGroupBox(QString::fromStdString(disk.device), scrollContent);
-        QVBoxLayout *diskLayout = new QVBoxLayout(diskGroup);
-
-        // Create a grid layout for disk details
-        QGridLayout *gridLayout = new QGridLayout();
-        diskLayout->addLayout(gridLayout);
-
-        // Mount point
-        QLabel *mountLabel = new QLabel("Mount Point:", diskGroup);
-        mountLabel->setFont(titleFont);
-        gridLayout->addWidget(mountLabel, 0, 0);
-
-        QLabel *mountValue = new QLabel(QString::fromStdString(disk.mountPoint), diskGroup);
-        mountValue->setFont(valueFont);
-        mountValue->setTextInteractionFlags(Qt::TextSelectableByMouse);
-        gridLayout->addWidget(mountValue, 0, 1);
-
-        // File system
-        QLabel *fsLabel = new QLabel("File System:", diskGroup);
-        fsLabel->setFont(titleFont);
-        gridLayout->addWidget(fsLabel, 1, 0);
-
-        QLabel *fsValue = new QLabel(QString::fromStdString(disk.fsType), diskGroup);
-        fsValue->setFont(valueFont);
-        gridLayout->addWidget(fsValue, 1, 1);
-
-        // Total size
-        QLabel *totalLabel = new QLabel("Total Size:", diskGroup);
-        totalLabel->setFont(titleFont);
-        gridLayout->addWidget(totalLabel, 2, 0);
-
-        QLabel *totalValue = new QLabel(formatSize(disk.totalSize), diskGroup);
-        totalValue->setFont(valueFont);
-        gridLayout->addWidget(totalValue, 2, 1);
-
-        // Free space
-        QLabel *freeLabel = new QLabel("Free Space:", diskGroup);
-        freeLabel->setFont(titleFont);
-        gridLayout->addWidget(freeLabel, 3, 0);
-
-        QLabel *freeValue = new QLabel(formatSize(disk.freeSpace), diskGroup);
-        freeValue->setFont(valueFont);
-        gridLayout->addWidget(freeValue, 3, 1);
-
-        // Available space
-        QLabel *availLabel = new QLabel("Available Space:", diskGroup);
-        availLabel->setFont(titleFont);
-        gridLayout->addWidget(availLabel, 4, 0);
-
-        QLabel *availValue = new QLabel(formatSize(disk.availableSpace), diskGroup);
-        availValue->setFont(valueFont);
-        gridLayout->addWidget(availValue, 4, 1);
-
-        // Used space
-        QLabel *usedLabel = new QLabel("Used Space:", diskGroup);
-        usedLabel->setFont(titleFont);
-        gridLayout->addWidget(usedLabel, 5, 0);
-
-        QLabel *usedValue = new QLabel(formatSize(disk.totalSize - disk.freeSpace), diskGroup);
-        usedValue->setFont(valueFont);
-        gridLayout->addWidget(usedValue, 5, 1);
-
-        // Usage percentage
-        double usagePercent = static_cast<double>(disk.totalSize - disk.freeSpace) / disk.totalSize * 100.0;
-
-        QLabel *usageLabel = new QLabel("Usage:", diskGroup);
-        usageLabel->setFont(titleFont);
-        gridLayout->addWidget(usageLabel, 6, 0);
-
-        QLabel *usageValue = new QLabel(QString("%1%").arg(usagePercent, 0, 'f', 2), diskGroup);
-        usageValue->setFont(valueFont);
-        gridLayout->addWidget(usageValue, 6, 1);
-
-        // Add a progress bar for visual representation
-        QProgressBar *usageBar = new QProgressBar(diskGroup);
-        usageBar->setMinimum(0);
-        usageBar->setMaximum(100);
-        usageBar->setValue(static_cast<int>(usagePercent));
-
-        // Set color based on usage
-        QString styleSheet;
-        if (usagePercent < 70) {
-            styleSheet = "QProgressBar::chunk { background-color: green; }";
-        } else if (usagePercent < 90) {
-            styleSheet = "QProgressBar::chunk { background-color: orange; }";
+    // Keep the selected device selected wherever sorting put it; without
+    // one, chart the busiest
+    int selectedRow = -1;
+    QString selectedName = QString::fromStdString(selectedDevice);
+    for (int row = 0; row < blockDeviceTable->rowCount(); ++row) {
+        if (blockDeviceTable->item(row, DeviceColumn)->text() == selectedName) {
+            selectedRow = row;
+            break;
+        }
+    }
+    if (selectedRow < 0 && blockDeviceTable->rowCount() > 0) {
+        selectedRow = 0;
+        selectedDevice = blockDeviceTable->item(0, DeviceColumn)->text().toStdString();
+        reloadBlockDeviceCharts();
+    }
+    if (selectedRow >= 0) {
+        blockDeviceTable->selectRow(selectedRow);
+    }
+
+    blockDeviceSummaryLabel->setText(QString("%1 of %2 devices, /proc/diskstats parsed in %3 us")
+                                         .arg(shown.size())
+                                         .arg(devices.size())
+                                         .arg(diskStats.getLastParseUs(), 0, 'f', 0));
+}
+
+void DiskWindow::blockDeviceSelectionChanged() {
+    QList<QTableWidgetItem*> items = blockDeviceTable->selectedItems();
+    if (items.isEmpty()) {
+        return;
+    }
+    QTableWidgetItem *nameItem = blockDeviceTable->item(items.first()->row(), DeviceColumn);
+    if (!nameItem || nameItem->text().toStdString() == selectedDevice) {
+        return;
+    }
+
+    selectedDevice = nameItem->text().toStdString();
+    reloadBlockDeviceCharts();
+}
+
+void DiskWindow::reloadBlockDeviceCharts() {
+#ifdef USE_QT_CHARTS
+    QVector<qint64> times;
+    std::vector<QVector<double>> throughput(2);
+    std::vector<QVector<double>> latency(2);
+    std::vector<QVector<double>> utilization(1);
+    throughputAxisMax = 1.0;
+    latencyAxisMax = 1.0;
+
+    const std::deque<BlockDeviceSample> *history = diskStats.getHistory(selectedDevice);
+    if (history) {
+        for (const BlockDeviceSample &sample : *history) {
+            times.append(SampleClock::toWallMsecs(sample.timeNs));
+            throughput[0].append(sample.readBytesPerSec / MB);
+            throughput[1].append(sample.writeBytesPerSec / MB);
+            latency[0].append(sample.readAwaitMs);
+            latency[1].append(sample.writeAwaitMs);
+            utilization[0].append(sample.utilization);
+            throughputAxisMax = std::max(throughputAxisMax, std::max(throughput[0].back(), throughput[1].back()) * 1.2);
+            latencyAxisMax = std::max(latencyAxisMax, std::max(latency[0].back(), latency[1].back()) * 1.2);
+        }
+    }
+
+    throughputPoints.replace(times, throughput);
+    latencyPoints.replace(times, latency);
+    utilizationPoints.replace(times, utilization);
+    qobject_cast<QValueAxis*>(throughputChart->axes(Qt::Vertical).first())->setRange(0, throughputAxisMax);
+    qobject_cast<QValueAxis*>(latencyChart->axes(Qt::Vertical).first())->setRange(0, latencyAxisMax);
+
+    QString name = QString::fromStdString(selectedDevice);
+    throughputChart->setTitle(QString("Throughput of %1").arg(name));
+    latencyChart->setTitle(QString("Await of %1").arg(name));
+    utilizationChart->setTitle(QString("Utilization of %1").arg(name));
+#endif
+}
+
+void DiskWindow::setupTopologyTab(QWidget *tab) {
+    QVBoxLayout *layout = new QVBoxLayout(tab);
+
+    topologyTree = new QTreeWidget(tab);
+    topologyTree->setObjectName("topologyTree");
+    topologyTree->setColumnCount(TopologyColumnCount);
+    topologyTree->setHeaderLabels({"Device", "Type", "Size", "Scheduler", "nr_requests", "read_ahead_kb",
+                                   "Rotational", "max_sectors_kb", "Write Cache"});
+    topologyTree->setAlternatingRowColors(true);
+    topologyTree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    topologyTree->headerItem()->setToolTip(MaxSectorsColumn, "Largest request sent to the device, and the hardware limit");
+    layout->addWidget(topologyTree, 1);
+
+    topologySummaryLabel = new QLabel(tab);
+    layout->addWidget(topologySummaryLabel);
+}
+
+void DiskWindow::refreshTopology() {
+    if (tabWidget->currentWidget() != topologyTab) {
+        return;
+    }
+    if (topology.refresh() || diskInfo.getMountTableReads() != topologyMountReads) {
+        updateTopologyTree();
+    }
+}
+
+void DiskWindow::updateTopologyTree() {
+    topologyTree->setUpdatesEnabled(false);
+    topologyTree->clear();
+
+    // Each mount with the stack below it
+    std::unordered_set<std::string> reached;
+    for (const DiskInfo &disk : diskInfo.getDisks()) {
+        const BlockDevice *device = topology.findByNumber(disk.major, disk.minor);
+        if (!device) {
+            continue;
+        }
+        QTreeWidgetItem *mountItem = new QTreeWidgetItem(topologyTree);
+        mountItem->setText(TopologyDeviceColumn, QString::fromStdString(disk.mountPoint));
+        mountItem->setText(TopologyTypeColumn, QString::fromStdString(disk.fsType));
+        addTopologyItem(mountItem, *device, 0, reached);
+    }
+
+    // Stacks nothing is mounted from: their tops first, so a disk with
+    // partitions appears below them rather than again on its own
+    QTreeWidgetItem *unmountedItem = new QTreeWidgetItem();
+    unmountedItem->setText(TopologyDeviceColumn, "Not mounted");
+    for (bool tops : {true, false}) {
+        for (const BlockDevice &device : topology.getDevices()) {
+            bool top = !topology.getLowerDevices(device).empty();
+            if (top == tops && device.holders.empty() && device.sizeBytes > 0 && !reached.count(device.name)) {
+                addTopologyItem(unmountedItem, device, 0, reached);
+            }
+        }
+    }
+    if (unmountedItem->childCount() > 0) {
+        topologyTree->addTopLevelItem(unmountedItem);
+    } else {
+        delete unmountedItem;
+    }
+
+    topologyTree->expandAll();
+    topologyTree->setUpdatesEnabled(true);
+    topologyMountReads = diskInfo.getMountTableReads();
+
+    topologySummaryLabel->setText(QString("%1 block devices, %2 settings flagged; rebuilt %3 times%4")
+                                      .arg(topology.getDevices().size())
+                                      .arg(topology.getIssueCount())
+                                      .arg(topology.getRebuildCount())
+                                      .arg(topology.isWatching() ? " on uevents"
+                                                                 : ", uevents unavailable so on every refresh"));
+}
+
+void DiskWindow::addTopologyItem(QTreeWidgetItem *parent, const BlockDevice &device, int depth,
+                                 std::unordered_set<std::string> &reached) {
+    if (depth > MAX_TOPOLOGY_DEPTH) {
+        return;
+    }
+    reached.insert(device.name);
+
+    QTreeWidgetItem *item = new QTreeWidgetItem(parent);
+    QString name = QString::fromStdString(device.name);
+    item->setText(TopologyDeviceColumn, device.label.empty()
+                                            ? name
+                                            : QString("%1 (%2)").arg(name, QString::fromStdString(device.label)));
+    item->setText(TopologyTypeColumn, QString::fromStdString(device.kind));
+    item->setText(TopologySizeColumn, formatSize(device.sizeBytes));
+
+    const BlockQueueSettings &queue = device.queue;
+    if (queue.available) {
+        auto number = [](int64_t value) { return value >= 0 ? QString::number(value) : QString("-"); };
+        item->setText(SchedulerColumn, queue.scheduler.empty() ? "-" : QString::fromStdString(queue.scheduler));
+        item->setToolTip(SchedulerColumn, QString::fromStdString(queue.schedulers));
+        item->setText(NrRequestsColumn, number(queue.nrRequests));
+        item->setText(ReadAheadColumn, number(queue.readAheadKb));
+        item->setText(RotationalColumn, queue.rotational < 0 ? "-" : queue.rotational ? "yes" : "no");
+        item->setText(MaxSectorsColumn,
+                      QString("%1 / %2").arg(number(queue.maxSectorsKb), number(queue.maxHwSectorsKb)));
+        item->setText(WriteCacheColumn, queue.writeCache.empty() ? "-" : QString::fromStdString(queue.writeCache));
+    }
+
+    // Flagged devices are drawn in red with the findings as tooltip
+    if (!device.issues.empty()) {
+        QStringList issues;
+        for (const std::string &issue : device.issues) {
+            issues << QString::fromStdString(issue);
+        }
+        for (int column = 0; column < TopologyColumnCount; ++column) {
+            item->setForeground(column, QBrush(QColor("red")));
+            if (column != SchedulerColumn) {
+                item->setToolTip(column, issues.join("\n"));
+            }
+        }
+    }
+
+    for (const BlockDevice *lower : topology.getLowerDevices(device)) {
+        addTopologyItem(item, *lower, depth + 1, reached);
+    }
+}
+
+void DiskWindow::setupProcessIoTab(QWidget *tab) {
+    QVBoxLayout *layout = new QVBoxLayout(tab);
+
+    processIoTable = new QTableWidget(tab);
+    processIoTable->setObjectName("processIoTable");
+    processIoTable->setColumnCount(ColumnCount);
+    processIoTable->setHorizontalHeaderLabels({"PID", "Name", "Read/s", "Write/s", "Reads/s", "Writes/s",
+                                               "Major Faults/s", "Minor Faults/s"});
+    processIoTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    processIoTable->horizontalHeader()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+    processIoTable->verticalHeader()->setVisible(false);
+    processIoTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    processIoTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    processIoTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    processIoTable->setAlternatingRowColors(true);
+    processIoTable->setSortingEnabled(true);
+    processIoTable->sortByColumn(WriteColumn, Qt::DescendingOrder);
+
+    processIoTable->horizontalHeaderItem(ReadColumn)->setToolTip("Bytes fetched from storage (read_bytes)");
+    processIoTable->horizontalHeaderItem(WriteColumn)->setToolTip("Bytes dirtied or written towards storage (write_bytes)");
+    processIoTable->horizontalHeaderItem(ReadCallsColumn)->setToolTip("Read system calls (syscr)");
+    processIoTable->horizontalHeaderItem(WriteCallsColumn)->setToolTip("Write system calls (syscw)");
+    processIoTable->horizontalHeaderItem(MajorFaultsColumn)->setToolTip("Page faults that had to read from storage");
+    layout->addWidget(processIoTable, 1);
+
+    // Create controls at the bottom
+    QHBoxLayout *controlLayout = new QHBoxLayout();
+
+    // Auto-refresh checkbox
+    QCheckBox *autoRefreshCheckbox = new QCheckBox("Auto-refresh (2s)", tab);
+    autoRefreshCheckbox->setChecked(true);
+    connect(autoRefreshCheckbox, &QCheckBox::toggled, [this](bool checked) {
+        autoRefreshEnabled = checked;
+        if (checked && tabWidget->currentWidget() == processIoTab) {
+            autoRefreshTimer->start(2000);
         } else {
-            styleSheet = "QProgressBar::chunk { background-color: red; }";
+            autoRefreshTimer->stop();
         }
-        usageBar->setStyleSheet(styleSheet);
+    });
+    controlLayout->addWidget(autoRefreshCheckbox);
 
-        diskLayout->addWidget(usageBar);
+    controlLayout->addStretch();
 
-        // Set column stretch to make the value column expand
-        gridLayout->setColumnStretch(1, 1);
+    processIoSummaryLabel = new QLabel(tab);
+    controlLayout->addWidget(processIoSummaryLabel);
 
-        // Add the disk group to the scroll layout
-        scrollLayout->addWidget(diskGroup);
+    // Last update label
+    lastUpdateLabel = new QLabel(tab);
+    controlLayout->addWidget(lastUpdateLabel);
+
+    // Refresh button
+    refreshButton = new QPushButton("Refresh", tab);
+    connect(refreshButton, &QPushButton::clicked, this, &DiskWindow::refreshProcessIo);
+    controlLayout->addWidget(refreshButton);
+
+    layout->addLayout(controlLayout);
+}
+
+void DiskWindow::tabChanged(int index) {
+    if (tabWidget->widget(index) == blockDeviceTab) {
+        updateBlockDeviceTable();
+    }
+    if (tabWidget->widget(index) == topologyTab) {
+        // Queue settings can be changed through sysfs without a uevent
+        if (!topology.refresh()) {
+            topology.refreshQueueSettings();
+        }
+        updateTopologyTree();
     }
 
-    // Add stretch to push everything to the top
-    scrollLayout->addStretch();
+    bool processIoShown = tabWidget->widget(index) == processIoTab;
+    if (!processIoShown) {
+        autoRefreshTimer->stop();
+        return;
+    }
 
-    // Set the scroll content and add to layout
-    scrollArea->setWidget(scrollContent);
-    layout->addWidget(scrollArea);
+    // Rates need two samples; the first refresh only sets the baseline
+    if (!processInfo) {
+        processInfo = std::make_unique<ProcessInfoCollector>();
+        processIo.update(processInfo->getProcesses());
+    }
+    refreshProcessIo();
+    if (autoRefreshEnabled) {
+        autoRefreshTimer->start(2000);
+    }
+}
+
+void DiskWindow::refreshProcessIo() {
+    if (!processInfo) {
+        return;
+    }
+
+    processInfo->refresh();
+    processIo.update(processInfo->getProcesses());
+    updateProcessIoTable();
+}
+
+void DiskWindow::updateProcessIoTable() {
+    const std::vector<ProcessIoInfo> &processes = processIo.getActiveProcesses();
+    int rows = std::min(static_cast<int>(processes.size()), MAX_PROCESS_IO_ROWS);
+
+    // Temporarily disable sorting while updating the table
+    processIoTable->setSortingEnabled(false);
+    processIoTable->clearContents();
+    processIoTable->setRowCount(rows);
+
+    auto setCell = [this](int row, int column, const QString &text, double value) {
+        QTableWidgetItem *item = new NumericTableItem();
+        item->setText(text);
+        item->setData(Qt::UserRole, value);
+        if (column != NameColumn) {
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        processIoTable->setItem(row, column, item);
+    };
+
+    for (int row = 0; row < rows; ++row) {
+        const ProcessIoInfo &process = processes[row];
+
+        setCell(row, PidColumn, QString::number(process.pid), process.pid);
+        QTableWidgetItem *nameItem = new QTableWidgetItem(QString::fromStdString(process.name));
+        processIoTable->setItem(row, NameColumn, nameItem);
+
+        if (process.ioSampled) {
+            setCell(row, ReadColumn, formatSize(static_cast<uint64_t>(process.readBytesPerSec)) + "/s", process.readBytesPerSec);
+            setCell(row, WriteColumn, formatSize(static_cast<uint64_t>(process.writeBytesPerSec)) + "/s", process.writeBytesPerSec);
+            setCell(row, ReadCallsColumn, QString::number(process.readCallsPerSec, 'f', 0), process.readCallsPerSec);
+            setCell(row, WriteCallsColumn, QString::number(process.writeCallsPerSec, 'f', 0), process.writeCallsPerSec);
+        } else {
+            // Not a candidate this round, or /proc/<pid>/io is not readable
+            for (int column = ReadColumn; column <= WriteCallsColumn; ++column) {
+                setCell(row, column, "-", -1.0);
+            }
+        }
+        setCell(row, MajorFaultsColumn, QString::number(process.majorFaultsPerSec, 'f', 1), process.majorFaultsPerSec);
+        setCell(row, MinorFaultsColumn, QString::number(process.minorFaultsPerSec, 'f', 0), process.minorFaultsPerSec);
+    }
+
+    processIoTable->setSortingEnabled(true);
+
+    processIoSummaryLabel->setText(QString("%1 of %2 processes active, %3 I/O files read (%4 ms)")
+                                       .arg(processes.size())
+                                       .arg(processIo.getProcessCount())
+                                       .arg(processIo.getLastIoReadCount())
+                                       .arg(processIo.getLastUpdateDurationMs(), 0, 'f', 1));
+
+    // Update last refresh time
+    QDateTime now = QDateTime::currentDateTime();
+    lastUpdateLabel->setText("Last updated: " + now.toString("hh:mm:ss"));
+}
+
+QString DiskWindow::formatSize(uint64_t bytes) const {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unitIndex = 0;
+    double size = static_cast<double>(bytes);
+
+    while (size >= 1024.0 && unitIndex < 4) {
+        size /= 1024.0;
+        unitIndex++;
+    }
+
+    return QString::number(size, 'f', unitIndex == 0 ? 0 : 1) + " " + units[unitIndex];
 }
\ No newline at end of file
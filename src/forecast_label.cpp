@@ -0,0 +1,45 @@
+#include "forecast_label.h"
+
+namespace {
+
+QString durationText(double seconds) {
+    return QString::fromStdString(TrendEstimator::formatDuration(seconds));
+}
+
+} // namespace
+
+void setForecastLabel(QLabel *label, const TrendForecast &forecast, const QString &what, const QString &window) {
+    QString text;
+    QString style;
+    if (!forecast.valid) {
+        text = "Collecting trend...";
+    } else if (!forecast.approaching) {
+        text = "No upward trend";
+    } else {
+        text = QString("Full in ~%1").arg(durationText(forecast.secondsToLimit));
+        if (forecast.secondsToLimit < 3600.0) {
+            style = "color: red;";
+        } else if (forecast.secondsToLimit < 24 * 3600.0) {
+            style = "color: orange;";
+        }
+    }
+
+    QString toolTip = forecast.approaching
+        ? QString("%1 at the current rate: 95% range %2 to %3, line fits %4% of the variation in the last %5")
+              .arg(what)
+              .arg(durationText(forecast.earliestSeconds))
+              .arg(durationText(forecast.latestSeconds))
+              .arg(forecast.rSquared * 100.0, 0, 'f', 0)
+              .arg(window)
+        : QString("%1 usage is not rising steadily enough over the last %2 for a forecast").arg(what).arg(window);
+
+    if (label->text() != text) {
+        label->setText(text);
+    }
+    if (label->styleSheet() != style) {
+        label->setStyleSheet(style);
+    }
+    if (label->toolTip() != toolTip) {
+        label->setToolTip(toolTip);
+    }
+}
@@ -0,0 +1,258 @@
+#include "fragmentation_info.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace {
+
+// pagetypeinfo grows with nodes and zones; a few KB per node
+const size_t READ_BUFFER_SIZE = 64 * 1024;
+
+const int DEFAULT_HUGE_ORDER = 9;
+
+const char* skipSpaces(const char* p) {
+    while (*p == ' ' || *p == '\t') {
+        ++p;
+    }
+    return p;
+}
+
+// Parse "Node <n>, zone <name>" at the start of a line. Returns the
+// position after the zone name, or nullptr for any other line
+const char* parseZonePrefix(const char* line, int& node, const char*& name, size_t& nameLength) {
+    if (strncmp(line, "Node", 4) != 0) {
+        return nullptr;
+    }
+    char* end = nullptr;
+    node = static_cast<int>(strtol(line + 4, &end, 10));
+    if (end == line + 4 || *end != ',') {
+        return nullptr;
+    }
+
+    const char* p = skipSpaces(end + 1);
+    if (strncmp(p, "zone", 4) != 0) {
+        return nullptr;
+    }
+    name = skipSpaces(p + 4);
+    p = name;
+    while (*p && *p != ' ' && *p != ',' && *p != '\n') {
+        ++p;
+    }
+    nameLength = p - name;
+    return p;
+}
+
+// Read up to maxCount numbers until the end of the line. pagetypeinfo
+// stops counting at a limit and prints ">100000"; such counts are lower
+// bounds and get their bit set in lowerBounds when it is given
+int parseCounts(const char* p, uint64_t* counts, int maxCount, uint32_t* lowerBounds = nullptr) {
+    int count = 0;
+    for (;;) {
+        p = skipSpaces(p);
+        bool lowerBound = *p == '>';
+        if (lowerBound) {
+            ++p;
+        }
+        if (*p < '0' || *p > '9' || count == maxCount) {
+            return count;
+        }
+        if (lowerBound && lowerBounds) {
+            *lowerBounds |= 1u << count;
+        }
+        char* end = nullptr;
+        counts[count++] = strtoull(p, &end, 10);
+        p = end;
+    }
+}
+
+void copyName(char* target, size_t size, const char* name, size_t length) {
+    length = std::min(length, size - 1);
+    memcpy(target, name, length);
+    target[length] = '\0';
+}
+
+bool nameEquals(const char* stored, const char* name, size_t length) {
+    return strlen(stored) == length && memcmp(stored, name, length) == 0;
+}
+
+} // namespace
+
+FragmentationCollector::FragmentationCollector()
+    : buddyInfo("/proc/buddyinfo"),
+      pageTypeInfo("/proc/pagetypeinfo"),
+      thpEnabledFile("/sys/kernel/mm/transparent_hugepage/enabled"),
+      thpDefragFile("/sys/kernel/mm/transparent_hugepage/defrag"),
+      buffer(READ_BUFFER_SIZE),
+      hugeOrder(DEFAULT_HUGE_ORDER),
+      pageSize(static_cast<uint64_t>(sysconf(_SC_PAGESIZE))),
+      pageTypesRead(false) {
+
+    // The huge page order follows from Hugepagesize and the base page size
+    SysfsFile meminfo("/proc/meminfo");
+    if (meminfo.read(buffer.data(), buffer.size()) > 0) {
+        const char* line = strstr(buffer.data(), "Hugepagesize:");
+        uint64_t hugeBytes = line ? strtoull(line + 13, nullptr, 10) * 1024 : 0;
+        if (hugeBytes > pageSize) {
+            int order = 0;
+            while ((pageSize << (order + 1)) <= hugeBytes) {
+                order++;
+            }
+            hugeOrder = order;
+        }
+    }
+
+    refresh();
+}
+
+const std::vector<ZoneFragmentation>& FragmentationCollector::getZones() const {
+    return zones;
+}
+
+int FragmentationCollector::getHugeOrder() const {
+    return hugeOrder;
+}
+
+uint64_t FragmentationCollector::getPageSize() const {
+    return pageSize;
+}
+
+bool FragmentationCollector::hasPageTypeInfo() const {
+    return pageTypesRead;
+}
+
+const std::string& FragmentationCollector::getThpEnabled() const {
+    return thpEnabled;
+}
+
+const std::string& FragmentationCollector::getThpDefrag() const {
+    return thpDefrag;
+}
+
+void FragmentationCollector::refresh() {
+    parseBuddyInfo();
+    parsePageTypeInfo();
+    readThpSetting(thpEnabledFile, thpEnabled);
+    readThpSetting(thpDefragFile, thpDefrag);
+}
+
+ZoneFragmentation* FragmentationCollector::findZone(int node, const char* name, size_t length, size_t& cursor) {
+    // Zones come in the same order every time
+    if (cursor < zones.size() && zones[cursor].node == node && nameEquals(zones[cursor].zone, name, length)) {
+        return &zones[cursor++];
+    }
+    for (size_t i = 0; i < zones.size(); ++i) {
+        if (zones[i].node == node && nameEquals(zones[i].zone, name, length)) {
+            cursor = i + 1;
+            return &zones[i];
+        }
+    }
+
+    ZoneFragmentation zone{};
+    zone.node = node;
+    copyName(zone.zone, sizeof(zone.zone), name, length);
+    zones.push_back(zone);
+    cursor = zones.size();
+    return &zones.back();
+}
+
+void FragmentationCollector::parseBuddyInfo() {
+    if (buddyInfo.read(buffer.data(), buffer.size()) <= 0) {
+        return;
+    }
+
+    // "Node 0, zone   Normal   2028   1839 ..."
+    size_t cursor = 0;
+    for (const char* line = buffer.data(); *line; ) {
+        int node;
+        const char* name;
+        size_t nameLength;
+        const char* rest = parseZonePrefix(line, node, name, nameLength);
+        if (rest) {
+            ZoneFragmentation* zone = findZone(node, name, nameLength, cursor);
+            zone->orderCount = parseCounts(rest, zone->freeBlocks, ZoneFragmentation::MAX_ORDERS);
+
+            zone->freePages = 0;
+            zone->hugeFreePages = 0;
+            for (int order = 0; order < zone->orderCount; ++order) {
+                uint64_t pages = zone->freeBlocks[order] << order;
+                zone->freePages += pages;
+                if (order >= hugeOrder) {
+                    zone->hugeFreePages += pages;
+                }
+            }
+
+            // The kernel's unusable free space index at the huge page order
+            zone->unusableIndex = zone->freePages > 0
+                ? static_cast<double>(zone->freePages - zone->hugeFreePages) / zone->freePages : 0.0;
+        }
+
+        const char* next = strchr(line, '\n');
+        if (!next) {
+            break;
+        }
+        line = next + 1;
+    }
+}
+
+void FragmentationCollector::parsePageTypeInfo() {
+    if (!pageTypeInfo.isOpen() || pageTypeInfo.read(buffer.data(), buffer.size()) <= 0) {
+        pageTypesRead = false;
+        return;
+    }
+
+    for (auto& zone : zones) {
+        zone.migrateTypeCount = 0;
+    }
+
+    // "Node    0, zone   Normal, type      Movable   2026   1838 ..."; the
+    // block count section further down has no ", type" and is skipped
+    size_t cursor = 0;
+    ZoneFragmentation* zone = nullptr;
+    for (const char* line = buffer.data(); *line; ) {
+        int node;
+        const char* name;
+        size_t nameLength;
+        const char* rest = parseZonePrefix(line, node, name, nameLength);
+        if (rest && strncmp(rest, ", type", 6) == 0) {
+            // One line per migrate type, so mostly the zone of the last line
+            if (!zone || zone->node != node || !nameEquals(zone->zone, name, nameLength)) {
+                zone = findZone(node, name, nameLength, cursor);
+            }
+
+            const char* type = skipSpaces(rest + 6);
+            const char* typeEnd = type;
+            while (*typeEnd && *typeEnd != ' ' && *typeEnd != '\n') {
+                ++typeEnd;
+            }
+
+            if (zone->migrateTypeCount < ZoneFragmentation::MAX_MIGRATE_TYPES) {
+                int index = zone->migrateTypeCount++;
+                copyName(zone->migrateTypes[index], sizeof(zone->migrateTypes[index]), type, typeEnd - type);
+                zone->lowerBoundsByType[index] = 0;
+                parseCounts(typeEnd, zone->freeBlocksByType[index], ZoneFragmentation::MAX_ORDERS,
+                            &zone->lowerBoundsByType[index]);
+            }
+        }
+
+        const char* next = strchr(line, '\n');
+        if (!next) {
+            break;
+        }
+        line = next + 1;
+    }
+    pageTypesRead = true;
+}
+
+void FragmentationCollector::readThpSetting(const SysfsFile& file, std::string& setting) {
+    // "always [madvise] never": the bracketed choice is the active one
+    char text[128];
+    if (file.read(text, sizeof(text)) <= 0) {
+        return;
+    }
+    const char* open = strchr(text, '[');
+    const char* close = open ? strchr(open, ']') : nullptr;
+    if (close && setting.compare(0, std::string::npos, open + 1, close - open - 1) != 0) {
+        setting.assign(open + 1, close - open - 1);
+    }
+}
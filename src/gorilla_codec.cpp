@@ -0,0 +1,325 @@
+#include "gorilla_codec.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Worst case of one sample: a 5-bit prefix and a 64-bit delta of delta,
+// a 2-bit control, 5 bits of leading zeros, 6 bits of length, 64 bits
+const size_t MAX_SAMPLE_BITS = 5 + 64 + 2 + 5 + 6 + 64;
+
+// Delta-of-delta classes: prefix, prefix length, payload bits
+struct DeltaClass {
+    uint64_t prefix;
+    int prefixBits;
+    int payloadBits;
+};
+
+const DeltaClass DELTA_CLASSES[] = {
+    {0x2, 2, 7},        // 10
+    {0x6, 3, 9},        // 110
+    {0xE, 4, 12},       // 1110
+    {0x1E, 5, 32},      // 11110
+    {0x1F, 5, 64},      // 11111
+};
+
+uint64_t bitsOf(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double valueOf(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool fitsSigned(int64_t value, int bits) {
+    if (bits >= 64) {
+        return true;
+    }
+    int64_t limit = int64_t(1) << (bits - 1);
+    return value >= -limit && value < limit;
+}
+
+uint64_t maskOf(int bits) {
+    return bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+}
+
+int64_t signExtend(uint64_t bits, int length) {
+    if (length >= 64) {
+        return static_cast<int64_t>(bits);
+    }
+    uint64_t sign = uint64_t(1) << (length - 1);
+    return static_cast<int64_t>((bits ^ sign) - sign);
+}
+
+// Reads a block's bit stream from the start
+class BitReader {
+public:
+    BitReader(const uint64_t* words)
+        : words(words), position(0) {
+    }
+
+    uint64_t read(int length) {
+        if (length == 0) {
+            return 0;
+        }
+        size_t word = position / 64;
+        int offset = static_cast<int>(position % 64);
+        int available = 64 - offset;
+        position += length;
+
+        uint64_t bits = words[word] << offset;
+        if (length > available) {
+            bits |= words[word + 1] >> available;
+        }
+        return bits >> (64 - length);
+    }
+
+    bool readBit() {
+        bool bit = (words[position / 64] >> (63 - position % 64)) & 1;
+        position++;
+        return bit;
+    }
+
+private:
+    const uint64_t* words;
+    size_t position;
+};
+
+} // namespace
+
+GorillaBlock::GorillaBlock()
+    : words{},
+      bitCount(0),
+      count(0),
+      firstTime(0),
+      firstValue(0.0),
+      lastTime(0),
+      lastDelta(0),
+      lastValueBits(0),
+      lastLeading(-1),
+      lastTrailing(0) {
+}
+
+size_t GorillaBlock::size() const {
+    return count;
+}
+
+bool GorillaBlock::isEmpty() const {
+    return count == 0;
+}
+
+int64_t GorillaBlock::getFirstTime() const {
+    return firstTime;
+}
+
+int64_t GorillaBlock::getLastTime() const {
+    return lastTime;
+}
+
+size_t GorillaBlock::getUsedBytes() const {
+    // The first sample lives in the fields, not the bit stream
+    return (bitCount + 7) / 8 + (count > 0 ? sizeof(firstTime) + sizeof(firstValue) : 0);
+}
+
+void GorillaBlock::writeBits(uint64_t bits, int length) {
+    if (length == 0) {
+        return;
+    }
+    bits &= maskOf(length);
+
+    size_t word = bitCount / 64;
+    int offset = static_cast<int>(bitCount % 64);
+    int available = 64 - offset;
+    bitCount += length;
+
+    if (length <= available) {
+        words[word] |= bits << (available - length);
+    } else {
+        words[word] |= bits >> (length - available);
+        words[word + 1] |= bits << (64 - (length - available));
+    }
+}
+
+bool GorillaBlock::append(int64_t timeMs, double value) {
+    uint64_t valueBits = bitsOf(value);
+
+    if (count == 0) {
+        firstTime = timeMs;
+        firstValue = value;
+        lastTime = timeMs;
+        lastDelta = 0;
+        lastValueBits = valueBits;
+        count = 1;
+        return true;
+    }
+
+    if (bitCount + MAX_SAMPLE_BITS > BLOCK_BYTES * 8) {
+        return false;
+    }
+
+    // Timestamp: the change of the delta, in the shortest class it fits
+    int64_t delta = timeMs - lastTime;
+    int64_t deltaOfDelta = delta - lastDelta;
+    if (deltaOfDelta == 0) {
+        writeBits(0, 1);
+    } else {
+        for (const DeltaClass& deltaClass : DELTA_CLASSES) {
+            if (fitsSigned(deltaOfDelta, deltaClass.payloadBits)) {
+                writeBits(deltaClass.prefix, deltaClass.prefixBits);
+                writeBits(static_cast<uint64_t>(deltaOfDelta), deltaClass.payloadBits);
+                break;
+            }
+        }
+    }
+
+    // Value: XOR with the previous one; reuse the last window of
+    // meaningful bits when the new XOR fits inside it
+    uint64_t xorBits = valueBits ^ lastValueBits;
+    if (xorBits == 0) {
+        writeBits(0, 1);
+    } else {
+        int leading = std::min(__builtin_clzll(xorBits), 31);
+        int trailing = __builtin_ctzll(xorBits);
+
+        if (lastLeading >= 0 && leading >= lastLeading && trailing >= lastTrailing) {
+            int meaningful = 64 - lastLeading - lastTrailing;
+            writeBits(0x2, 2);
+            writeBits(xorBits >> lastTrailing, meaningful);
+        } else {
+            int meaningful = 64 - leading - trailing;
+            writeBits(0x3, 2);
+            writeBits(leading, 5);
+            writeBits(meaningful - 1, 6);
+            writeBits(xorBits >> trailing, meaningful);
+            lastLeading = leading;
+            lastTrailing = trailing;
+        }
+    }
+
+    lastTime = timeMs;
+    lastDelta = delta;
+    lastValueBits = valueBits;
+    count++;
+    return true;
+}
+
+void GorillaBlock::decode(int64_t fromMs, int64_t toMs, std::vector<int64_t>& times,
+                          std::vector<double>& values) const {
+    if (count == 0 || lastTime < fromMs || firstTime > toMs) {
+        return;
+    }
+
+    BitReader reader(words);
+    int64_t time = firstTime;
+    int64_t delta = 0;
+    uint64_t valueBits = bitsOf(firstValue);
+    int leading = 0;
+    int trailing = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            int64_t deltaOfDelta = 0;
+            if (reader.readBit()) {
+                // Count the ones of the prefix to find the class
+                size_t ones = 1;
+                while (ones < 4 && reader.readBit()) {
+                    ones++;
+                }
+                const DeltaClass& deltaClass = DELTA_CLASSES[ones == 4 ? 3 + reader.readBit() : ones - 1];
+                deltaOfDelta = signExtend(reader.read(deltaClass.payloadBits), deltaClass.payloadBits);
+            }
+            delta += deltaOfDelta;
+            time += delta;
+
+            if (reader.readBit()) {
+                if (reader.readBit()) {
+                    leading = static_cast<int>(reader.read(5));
+                    int meaningful = static_cast<int>(reader.read(6)) + 1;
+                    trailing = 64 - leading - meaningful;
+                }
+                valueBits ^= reader.read(64 - leading - trailing) << trailing;
+            }
+        }
+
+        if (time > toMs) {
+            break;
+        }
+        if (time >= fromMs) {
+            times.push_back(time);
+            values.push_back(valueOf(valueBits));
+        }
+    }
+}
+
+CompressedSeries::CompressedSeries(size_t maxBlocks)
+    : maxBlocks(std::max<size_t>(maxBlocks, 1)),
+      head(0),
+      sampleCount(0) {
+}
+
+const GorillaBlock& CompressedSeries::blockAt(size_t index) const {
+    return blocks[(head + index) % blocks.size()];
+}
+
+void CompressedSeries::append(int64_t timeMs, double value) {
+    if (!blocks.empty()) {
+        GorillaBlock& newest = blocks[(head + blocks.size() - 1) % blocks.size()];
+        if (timeMs < newest.getLastTime()) {
+            return;
+        }
+        if (newest.append(timeMs, value)) {
+            sampleCount++;
+            return;
+        }
+    }
+
+    // Start a new block, reusing the oldest once the ring is full
+    if (blocks.size() < maxBlocks) {
+        blocks.emplace_back();
+    } else {
+        sampleCount -= blocks[head].size();
+        blocks[head] = GorillaBlock();
+        head = (head + 1) % blocks.size();
+    }
+    blocks[(head + blocks.size() - 1) % blocks.size()].append(timeMs, value);
+    sampleCount++;
+}
+
+void CompressedSeries::decode(int64_t fromMs, int64_t toMs, std::vector<int64_t>& times,
+                              std::vector<double>& values) const {
+    // Blocks are in time order: skip to the first that reaches fromMs
+    size_t low = 0;
+    size_t high = blocks.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (blockAt(middle).getLastTime() < fromMs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    for (size_t i = low; i < blocks.size() && blockAt(i).getFirstTime() <= toMs; ++i) {
+        blockAt(i).decode(fromMs, toMs, times, values);
+    }
+}
+
+size_t CompressedSeries::size() const {
+    return sampleCount;
+}
+
+size_t CompressedSeries::getCompressedBytes() const {
+    size_t bytes = 0;
+    for (const auto& block : blocks) {
+        bytes += block.getUsedBytes();
+    }
+    return bytes;
+}
+
+size_t CompressedSeries::memoryBytes() const {
+    return blocks.capacity() * sizeof(GorillaBlock);
+}
@@ -5,6 +5,10 @@
 #include "service_window.h"
 #include "usb_window.h"
 #include "memory_window.h"
+#include "process_window.h"
+#include "cgroup_window.h"
+#include "burst_window.h"
+#include "process_scanner.h"
 #include <QVBoxLayout>
 #include <QApplication>
 #include <QScreen>
@@ -107,6 +111,15 @@ void MainWindow::readSettings()
         case 5:
             showMemoryInfo();
             break;
+        case 6:
+            showProcessInfo();
+            break;
+        case 7:
+            showCgroupInfo();
+            break;
+        case 8:
+            showBurstSampling();
+            break;
         default:
             showDiskInfo();
             break;
@@ -132,6 +145,12 @@ void MainWindow::writeSettings()
         currentSection = 4;
     } else if (stackedWidget->currentWidget() == memoryWidget) {
         currentSection = 5;
+    } else if (stackedWidget->currentWidget() == processWidget) {
+        currentSection = 6;
+    } else if (stackedWidget->currentWidget() == cgroupWidget) {
+        currentSection = 7;
+    } else if (stackedWidget->currentWidget() == burstWidget) {
+        currentSection = 8;
     }
     settings.setValue("lastSection", currentSection);
 
@@ -180,6 +199,14 @@ void MainWindow::setupUI() {
     stackedWidget->setObjectName("mainStackedWidget");
     mainLayout->addWidget(stackedWidget);
 
+    // One process scanner feeds every page that lists processes.
+    // Opt-in: set ioUringProcReads=true in the SystemInfo settings file
+    QSettings readSettings("SystemInfo", "SystemInfo");
+    processScanner = new ProcessScanner(readSettings.value("ioUringProcReads", false).toBool()
+                                            ? ProcFileReader::Backend::IO_URING
+                                            : ProcFileReader::Backend::SYNC,
+                                        this);
+
     // Create the different views with error checking
     try {
         qDebug() << "Creating CPU widget...";
@@ -198,7 +225,16 @@ void MainWindow::setupUI() {
         usbWidget = new USBWindow(this);
 
         qDebug() << "Creating memory widget...";
-        memoryWidget = new MemoryWindow(this);
+        memoryWidget = new MemoryWindow(processScanner, this);
+
+        qDebug() << "Creating process widget...";
+        processWidget = new ProcessWindow(processScanner, this);
+
+        qDebug() << "Creating cgroup widget...";
+        cgroupWidget = new CgroupWindow(this);
+
+        qDebug() << "Creating high-frequency sampling widget...";
+        burstWidget = new BurstWindow(this);
     } catch (const std::exception& e) {
         qCritical() << "Exception during widget creation:" << e.what();
         throw;
@@ -215,6 +251,9 @@ void MainWindow::setupUI() {
     stackedWidget->addWidget(serviceWidget);
     stackedWidget->addWidget(usbWidget);
     stackedWidget->addWidget(memoryWidget);
+    stackedWidget->addWidget(processWidget);
+    stackedWidget->addWidget(cgroupWidget);
+    stackedWidget->addWidget(burstWidget);
 
     // Connect button signals
     qDebug() << "Connecting button signals...";
@@ -241,6 +280,24 @@ void MainWindow::setupUI() {
     // Make the button checkable
     memoryButton->setCheckable(true);
 
+    // Add a button for the process list
+    QPushButton *processButton = new QPushButton(QIcon::fromTheme("utilities-system-monitor", QIcon(":/icons/computer.png")), "Processes", this);
+    menuLayout->addWidget(processButton);
+    connect(processButton, &QPushButton::clicked, this, &MainWindow::showProcessInfo);
+    processButton->setCheckable(true);
+
+    // Add a button for the cgroup hierarchy
+    QPushButton *cgroupButton = new QPushButton(QIcon::fromTheme("view-list-tree", QIcon(":/icons/service.png")), "Control Groups", this);
+    menuLayout->addWidget(cgroupButton);
+    connect(cgroupButton, &QPushButton::clicked, this, &MainWindow::showCgroupInfo);
+    cgroupButton->setCheckable(true);
+
+    // Add a button for sub-second sampling
+    QPushButton *burstButton = new QPushButton(QIcon::fromTheme("utilities-system-monitor", QIcon(":/icons/cpu.png")), "High-Frequency Sampling", this);
+    menuLayout->addWidget(burstButton);
+    connect(burstButton, &QPushButton::clicked, this, &MainWindow::showBurstSampling);
+    burstButton->setCheckable(true);
+
     qDebug() << "UI setup complete.";
 }
 
@@ -251,6 +308,9 @@ void MainWindow::createMenus() {
     networkInfoAction = new QAction(tr("&Network Information"), this);
     serviceInfoAction = new QAction(tr("&System Services"), this);
     usbInfoAction = new QAction(tr("&USB Devices"), this);
+    processInfoAction = new QAction(tr("&Processes"), this);
+    cgroupInfoAction = new QAction(tr("C&ontrol Groups"), this);
+    burstSamplingAction = new QAction(tr("&High-Frequency Sampling"), this);
     exitAction = new QAction(tr("E&xit"), this);
     aboutAction = new QAction(tr("&About"), this);
     toggleThemeAction = new QAction(tr("Toggle Dark/Light Mode"), this);
@@ -283,6 +343,21 @@ void MainWindow::createMenus() {
     connect(usbInfoAction, &QAction::triggered, this, &MainWindow::showUSBInfo);
     viewMenu->addAction(usbInfoAction);
 
+    // Process list action
+    processInfoAction->setStatusTip(tr("Show running processes"));
+    connect(processInfoAction, &QAction::triggered, this, &MainWindow::showProcessInfo);
+    viewMenu->addAction(processInfoAction);
+
+    // Cgroup hierarchy action
+    cgroupInfoAction->setStatusTip(tr("Show cgroup resource usage"));
+    connect(cgroupInfoAction, &QAction::triggered, this, &MainWindow::showCgroupInfo);
+    viewMenu->addAction(cgroupInfoAction);
+
+    // Sub-second sampling action
+    burstSamplingAction->setStatusTip(tr("Sample CPU, memory and network at up to 100 Hz"));
+    connect(burstSamplingAction, &QAction::triggered, this, &MainWindow::showBurstSampling);
+    viewMenu->addAction(burstSamplingAction);
+
     viewMenu->addSeparator();
 
     // Exit action
@@ -334,6 +409,9 @@ void MainWindow::showCPUInfo() {
     networkInfoAction->setEnabled(true);
     serviceInfoAction->setEnabled(true);
     usbInfoAction->setEnabled(true);
+    processInfoAction->setEnabled(true);
+    cgroupInfoAction->setEnabled(true);
+    burstSamplingAction->setEnabled(true);
 }
 
 void MainWindow::showDiskInfo() {
@@ -344,6 +422,9 @@ void MainWindow::showDiskInfo() {
     networkInfoAction->setEnabled(true);
     serviceInfoAction->setEnabled(true);
     usbInfoAction->setEnabled(true);
+    processInfoAction->setEnabled(true);
+    cgroupInfoAction->setEnabled(true);
+    burstSamplingAction->setEnabled(true);
 }
 
 void MainWindow::showNetworkInfo() {
@@ -354,6 +435,9 @@ void MainWindow::showNetworkInfo() {
     networkInfoAction->setEnabled(false);
     serviceInfoAction->setEnabled(true);
     usbInfoAction->setEnabled(true);
+    processInfoAction->setEnabled(true);
+    cgroupInfoAction->setEnabled(true);
+    burstSamplingAction->setEnabled(true);
 }
 
 void MainWindow::showServiceInfo() {
@@ -364,6 +448,9 @@ void MainWindow::showServiceInfo() {
     networkInfoAction->setEnabled(true);
     serviceInfoAction->setEnabled(false);
     usbInfoAction->setEnabled(true);
+    processInfoAction->setEnabled(true);
+    cgroupInfoAction->setEnabled(true);
+    burstSamplingAction->setEnabled(true);
 }
 
 void MainWindow::showUSBInfo() {
@@ -374,6 +461,9 @@ void MainWindow::showUSBInfo() {
     networkInfoAction->setEnabled(true);
     serviceInfoAction->setEnabled(true);
     usbInfoAction->setEnabled(false);
+    processInfoAction->setEnabled(true);
+    cgroupInfoAction->setEnabled(true);
+    burstSamplingAction->setEnabled(true);
 }
 
 void MainWindow::showMemoryInfo() {
@@ -384,6 +474,48 @@ void MainWindow::showMemoryInfo() {
     networkInfoAction->setEnabled(true);
     serviceInfoAction->setEnabled(true);
     usbInfoAction->setEnabled(true);
+    processInfoAction->setEnabled(true);
+    cgroupInfoAction->setEnabled(true);
+    burstSamplingAction->setEnabled(true);
+}
+
+void MainWindow::showProcessInfo() {
+    stackedWidget->setCurrentWidget(processWidget);
+    setWindowTitle("System Information - Processes");
+    cpuInfoAction->setEnabled(true);
+    diskInfoAction->setEnabled(true);
+    networkInfoAction->setEnabled(true);
+    serviceInfoAction->setEnabled(true);
+    usbInfoAction->setEnabled(true);
+    processInfoAction->setEnabled(false);
+    cgroupInfoAction->setEnabled(true);
+    burstSamplingAction->setEnabled(true);
+}
+
+void MainWindow::showCgroupInfo() {
+    stackedWidget->setCurrentWidget(cgroupWidget);
+    setWindowTitle("System Information - Control Groups");
+    cpuInfoAction->setEnabled(true);
+    diskInfoAction->setEnabled(true);
+    networkInfoAction->setEnabled(true);
+    serviceInfoAction->setEnabled(true);
+    usbInfoAction->setEnabled(true);
+    processInfoAction->setEnabled(true);
+    cgroupInfoAction->setEnabled(false);
+    burstSamplingAction->setEnabled(true);
+}
+
+void MainWindow::showBurstSampling() {
+    stackedWidget->setCurrentWidget(burstWidget);
+    setWindowTitle("System Information - High-Frequency Sampling");
+    cpuInfoAction->setEnabled(true);
+    diskInfoAction->setEnabled(true);
+    networkInfoAction->setEnabled(true);
+    serviceInfoAction->setEnabled(true);
+    usbInfoAction->setEnabled(true);
+    processInfoAction->setEnabled(true);
+    cgroupInfoAction->setEnabled(true);
+    burstSamplingAction->setEnabled(false);
 }
 
 void MainWindow::about() {
@@ -0,0 +1,179 @@
+#include "memory_stats.h"
+#include <cstring>
+#include <cstdlib>
+
+namespace {
+
+// /proc/vmstat is about 5 KB on current kernels
+const size_t READ_BUFFER_SIZE = 32 * 1024;
+
+// vmstat nr_* lines are gauges except for these running totals
+const char* const NR_COUNTERS[] = {"nr_dirtied", "nr_written", "nr_foll_pin_acquired", "nr_foll_pin_released"};
+
+// Length of the key at the start of line: up to ':' in meminfo, ' ' in vmstat
+size_t keyLength(const char* line, bool vmstat) {
+    const char* end = line;
+    char separator = vmstat ? ' ' : ':';
+    while (*end && *end != separator && *end != '\n') {
+        ++end;
+    }
+    return end - line;
+}
+
+bool isVmstatCounter(const std::string& name) {
+    if (name.compare(0, 3, "nr_") != 0) {
+        return name != "workingset_nodes";
+    }
+    for (const char* counter : NR_COUNTERS) {
+        if (name == counter) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+MemoryStatsCollector::MemoryStatsCollector()
+    : sources{{SysfsFile("/proc/meminfo"), false, 0, 0}, {SysfsFile("/proc/vmstat"), true, 0, 0}},
+      buffer(READ_BUFFER_SIZE),
+      refreshCount(0) {
+
+    // The dictionary is fixed from here on
+    for (Source& source : sources) {
+        source.first = keys.size();
+        if (source.file.read(buffer.data(), buffer.size()) > 0) {
+            buildDictionary(source, buffer.data());
+        }
+        source.count = keys.size() - source.first;
+    }
+
+    values.assign(keys.size(), 0);
+    previousValues.assign(keys.size(), 0);
+    rates.assign(keys.size(), 0.0);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keyIndex[keys[i].name] = i;
+        if (keys[i].counter) {
+            counterIndices.push_back(i);
+        }
+    }
+}
+
+void MemoryStatsCollector::buildDictionary(Source& source, const char* text) {
+    for (const char* line = text; *line; ) {
+        size_t length = keyLength(line, source.vmstat);
+        const char* end = strchr(line, '\n');
+        if (length > 0) {
+            MemoryStatKey key;
+            key.name.assign(line, length);
+            key.vmstat = source.vmstat;
+            if (source.vmstat) {
+                key.counter = isVmstatCounter(key.name);
+                key.unit = key.counter || key.name.compare(0, 3, "nr_") != 0 ? MemoryStatUnit::COUNT
+                                                                               : MemoryStatUnit::PAGES;
+            } else {
+                // "HugePages_Total:       0" has no unit, most lines end in kB
+                size_t lineLength = end ? end - line : strlen(line);
+                bool kilobytes = lineLength >= 3 && memcmp(line + lineLength - 3, " kB", 3) == 0;
+                key.counter = false;
+                key.unit = kilobytes ? MemoryStatUnit::BYTES : MemoryStatUnit::COUNT;
+            }
+            keys.push_back(key);
+        }
+        if (!end) {
+            break;
+        }
+        line = end + 1;
+    }
+}
+
+bool MemoryStatsCollector::refresh() {
+    auto now = std::chrono::steady_clock::now();
+    previousValues.assign(values.begin(), values.end());
+
+    bool ok = false;
+    for (const Source& source : sources) {
+        if (source.file.read(buffer.data(), buffer.size()) > 0) {
+            parse(source, buffer.data());
+            ok = true;
+        }
+    }
+
+    refreshCount++;
+    double elapsed = std::chrono::duration<double>(now - lastRefresh).count();
+    if (refreshCount > 1 && elapsed > 0.0) {
+        for (size_t i : counterIndices) {
+            rates[i] = values[i] >= previousValues[i] ? (values[i] - previousValues[i]) / elapsed : 0.0;
+        }
+    }
+    lastRefresh = now;
+    return ok;
+}
+
+void MemoryStatsCollector::parse(const Source& source, const char* text) {
+    size_t expected = source.first;
+    for (const char* line = text; *line; ) {
+        size_t length = keyLength(line, source.vmstat);
+
+        // The kernel prints its keys in a fixed order, so the next key in
+        // the dictionary almost always matches
+        size_t index = keys.size();
+        if (expected < source.first + source.count && keys[expected].name.size() == length &&
+            memcmp(keys[expected].name.data(), line, length) == 0) {
+            index = expected;
+        } else {
+            auto found = keyIndex.find(std::string(line, length));
+            if (found != keyIndex.end() && found->second >= source.first &&
+                found->second < source.first + source.count) {
+                index = found->second;
+            }
+        }
+
+        const char* value = line + length;
+        if (*value) {
+            ++value;    // The separator
+        }
+        char* end = nullptr;
+        uint64_t parsed = strtoull(value, &end, 10);
+        if (index < keys.size()) {
+            values[index] = keys[index].unit == MemoryStatUnit::BYTES ? parsed * 1024 : parsed;
+            expected = index + 1;
+        }
+
+        const char* next = strchr(end ? end : value, '\n');
+        if (!next) {
+            break;
+        }
+        line = next + 1;
+    }
+}
+
+const std::vector<MemoryStatKey>& MemoryStatsCollector::getKeys() const {
+    return keys;
+}
+
+int MemoryStatsCollector::indexOf(const std::string& name) const {
+    auto found = keyIndex.find(name);
+    return found != keyIndex.end() ? static_cast<int>(found->second) : -1;
+}
+
+const std::vector<uint64_t>& MemoryStatsCollector::getValues() const {
+    return values;
+}
+
+uint64_t MemoryStatsCollector::getValue(size_t index) const {
+    return index < values.size() ? values[index] : 0;
+}
+
+uint64_t MemoryStatsCollector::getValue(const std::string& name) const {
+    int index = indexOf(name);
+    return index >= 0 ? values[index] : 0;
+}
+
+double MemoryStatsCollector::getRate(size_t index) const {
+    return index < rates.size() ? rates[index] : 0.0;
+}
+
+bool MemoryStatsCollector::hasRates() const {
+    return refreshCount > 1;
+}
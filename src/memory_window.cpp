@@ -1,4 +1,6 @@
 #include "memory_window.h"
+#include "numeric_table_item.h"
+#include "forecast_label.h"
 #include <QDateTime>
 #include <QHeaderView>
 #include <QCheckBox>
@@ -8,27 +10,98 @@
 #include <QApplication>
 #include <QProcess>
 #include <QRegularExpression>
+#include <QStandardPaths>
+#include <QDir>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <cmath>
-
-MemoryWindow::MemoryWindow(QWidget *parent) : QWidget(parent) {
+#include <algorithm>
+
+namespace {
+
+// Rows of the top consumers table
+const size_t TOP_CONSUMER_COUNT = 25;
+
+// Spans offered for the history charts
+struct HistoryRange {
+    const char *label;
+    qint64 msecs;
+};
+
+const HistoryRange HISTORY_RANGES[] = {
+    {"10 minutes", 10LL * 60 * 1000},
+    {"1 hour", 60LL * 60 * 1000},
+    {"6 hours", 6LL * 60 * 60 * 1000},
+    {"1 day", 24LL * 60 * 60 * 1000},
+    {"7 days", 7LL * 24 * 60 * 60 * 1000},
+    {"30 days", 30LL * 24 * 60 * 60 * 1000},
+};
+
+} // namespace
+
+MemoryWindow::MemoryWindow(ProcessScanner *scanner, QWidget *parent)
+    : QWidget(parent),
+      processScanner(scanner),
+      ramChartPoints(MAX_CHART_POINTS),
+      swapChartPoints(MAX_CHART_POINTS),
+      statChartPoints(MAX_CHART_POINTS),
+      fragmentationChartPoints(MAX_CHART_POINTS),
+      ramAxisMax(-1.0),
+      swapAxisMax(-1.0),
+      statAxisMax(1.0),
+      statChartStartMsecs(0),
+      fragmentationAxisMax(1.0),
+      chartTier(TimeSeriesTier::RAW),
+      chartBucketCount(0),
+      statHistory(memoryStats.getKeys().size(), CompressedSeries(STAT_HISTORY_BLOCKS)),
+      placementPid(-1),
+      availableRamTrend(FORECAST_SAMPLES),
+      freeSwapTrend(FORECAST_SAMPLES),
+      currentInfo{},
+      historyRangeMsecs(HISTORY_RANGES[0].msecs) {
     setupUI();
 
+    // Show the history of earlier runs before the first sample
+    openHistoryFiles();
+    reloadCharts();
+    reloadStatChart();
+
     // Initialize with current data
     refreshData();
 
     // Set up auto-refresh timer (every 10 seconds)
-    refreshTimer = new QTimer(this);
-    connect(refreshTimer, &QTimer::timeout, this, &MemoryWindow::refreshData);
+    refreshTimer = new DeadlineTimer(this);
+    connect(refreshTimer, &DeadlineTimer::timeout, this, &MemoryWindow::refreshData);
     refreshTimer->start(10000); // 10 seconds
+
+    connect(scanner, &ProcessScanner::snapshotReady, this, &MemoryWindow::processSnapshotReady);
 }
 
 MemoryWindow::~MemoryWindow() {
     if (refreshTimer->isActive()) {
         refreshTimer->stop();
     }
+    if (processScanner) {
+        processScanner->removeClient(this);
+    }
+}
+
+void MemoryWindow::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+
+    // Only the top consumers need process scans, and only while shown
+    if (refreshTimer->isActive()) {
+        processScanner->addClient(this, 10000);
+    } else {
+        processScanner->requestScan();
+    }
+    processSnapshotReady();
+}
+
+void MemoryWindow::hideEvent(QHideEvent *event) {
+    QWidget::hideEvent(event);
+    processScanner->removeClient(this);
 }
 
 void MemoryWindow::setupUI() {
@@ -65,9 +138,38 @@ void MemoryWindow::setupUI() {
     swapLayout->addWidget(swapLabel);
     swapLayout->addWidget(swapProgressBar);
 
+    // Where the trend of the last hour leads
+    ramForecastLabel = new QLabel(this);
+    swapForecastLabel = new QLabel(this);
+    ramLayout->addWidget(ramForecastLabel);
+    swapLayout->addWidget(swapForecastLabel);
+
     usageLayout->addLayout(ramLayout);
     usageLayout->addLayout(swapLayout);
 
+    // One bar per NUMA node, with where its allocations came from
+    if (numaInfo.isNuma()) {
+        for (const NumaNodeInfo &node : numaInfo.getNodes()) {
+            QHBoxLayout *nodeLayout = new QHBoxLayout();
+            QLabel *nodeLabel = new QLabel(QString("Node %1:").arg(node.node), this);
+            nodeLabel->setMinimumWidth(80);
+            QProgressBar *nodeBar = new QProgressBar(this);
+            nodeBar->setRange(0, 100);
+            nodeBar->setTextVisible(true);
+            QLabel *rateLabel = new QLabel(this);
+            rateLabel->setToolTip("Pages allocated per second on this node: by tasks running on it (local) "
+                                  "or on other nodes (remote); miss counts pages placed here that were meant "
+                                  "for another node, foreign pages meant for here that went elsewhere");
+            nodeLayout->addWidget(nodeLabel);
+            nodeLayout->addWidget(nodeBar);
+            nodeLayout->addWidget(rateLabel);
+            usageLayout->addLayout(nodeLayout);
+
+            nodeBars.push_back(nodeBar);
+            nodeRateLabels.push_back(rateLabel);
+        }
+    }
+
     mainLayout->addWidget(usageGroup);
 
     // Detailed memory information table
@@ -81,9 +183,55 @@ void MemoryWindow::setupUI() {
     memoryTable->setAlternatingRowColors(true);
     memoryTable->verticalHeader()->setVisible(false);
 
+    const QStringList metrics = {"Total RAM", "Used RAM", "Free RAM", "Available RAM", "Buffers", "Cached",
+                                 "Shared Memory", "Total Swap", "Used Swap", "Free Swap", "RAM Usage", "Swap Usage"};
+    memoryTable->setRowCount(DetailRowCount);
+    for (int row = 0; row < DetailRowCount; ++row) {
+        memoryTable->setItem(row, 0, new QTableWidgetItem(metrics[row]));
+        memoryTable->setItem(row, 1, new QTableWidgetItem());
+    }
+
     detailsLayout->addWidget(memoryTable);
     mainLayout->addWidget(detailsGroup);
 
+    setupFragmentationGroup(mainLayout);
+
+    // Processes with the most proportional (PSS) memory
+    QGroupBox *topConsumersGroup = new QGroupBox("Top Consumers", this);
+    QVBoxLayout *topConsumersLayout = new QVBoxLayout(topConsumersGroup);
+
+    topConsumersTable = new QTableWidget(0, TopConsumerColumnCount, this);
+    topConsumersTable->setObjectName("topConsumersTable");
+    topConsumersTable->setHorizontalHeaderLabels({"PID", "Name", "PSS", "USS", "RSS", "Swap", "Age"});
+    topConsumersTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    topConsumersTable->horizontalHeader()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+    topConsumersTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    topConsumersTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    topConsumersTable->setAlternatingRowColors(true);
+    topConsumersTable->verticalHeader()->setVisible(false);
+    topConsumersTable->setSortingEnabled(true);
+    topConsumersTable->sortByColumn(PssColumn, Qt::DescendingOrder);
+
+    topConsumersTable->horizontalHeaderItem(PssColumn)->setToolTip("Proportional set size: shared pages split between the processes using them");
+    topConsumersTable->horizontalHeaderItem(UssColumn)->setToolTip("Unique set size: pages only this process uses, freed when it exits");
+    topConsumersTable->horizontalHeaderItem(RssColumn)->setToolTip("Resident set size: counts shared pages in full");
+    topConsumersTable->horizontalHeaderItem(AgeColumn)->setToolTip("Time since smaps_rollup was last read for this process");
+
+    topConsumersLabel = new QLabel("Scanning processes...", this);
+
+    topConsumersLayout->addWidget(topConsumersTable);
+    topConsumersLayout->addWidget(topConsumersLabel);
+
+    numaPlacementLabel = new QLabel(this);
+    numaPlacementLabel->setVisible(numaInfo.isNuma());
+    numaPlacementLabel->setText("Select a process to see its memory per NUMA node");
+    topConsumersLayout->addWidget(numaPlacementLabel);
+    if (numaInfo.isNuma()) {
+        connect(topConsumersTable, &QTableWidget::itemSelectionChanged,
+                this, &MemoryWindow::topConsumerSelectionChanged);
+    }
+    mainLayout->addWidget(topConsumersGroup);
+
     // Charts for memory usage over time
     QGroupBox *chartsGroup = new QGroupBox("Memory Usage Over Time", this);
     QVBoxLayout *chartsLayout = new QVBoxLayout(chartsGroup);
@@ -117,6 +265,12 @@ void MemoryWindow::setupUI() {
     ramValueAxis->setLabelFormat("%.2f");
     ramChart->addAxis(ramValueAxis, Qt::AlignLeft);
 
+    ramChartPoints.addSeries(ramUsageSeries);
+    ramChartPoints.addSeries(ramCachedSeries);
+    ramChartPoints.addSeries(ramBuffersSeries);
+    ramChartPoints.setTimeAxis(ramTimeAxis);
+    ramChartPoints.setWindowMsecs(historyRangeMsecs);
+
     ramUsageSeries->attachAxis(ramTimeAxis);
     ramUsageSeries->attachAxis(ramValueAxis);
     ramCachedSeries->attachAxis(ramTimeAxis);
@@ -148,18 +302,83 @@ void MemoryWindow::setupUI() {
     swapValueAxis->setLabelFormat("%.2f");
     swapChart->addAxis(swapValueAxis, Qt::AlignLeft);
 
+    swapChartPoints.addSeries(swapUsageSeries);
+    swapChartPoints.setTimeAxis(swapTimeAxis);
+    swapChartPoints.setWindowMsecs(historyRangeMsecs);
+
     swapUsageSeries->attachAxis(swapTimeAxis);
     swapUsageSeries->attachAxis(swapValueAxis);
 
     swapChartView = new QChartView(swapChart);
     swapChartView->setRenderHint(QPainter::Antialiasing);
 
+    // Visible time span; longer spans are drawn from the downsampled tiers
+    QHBoxLayout *rangeLayout = new QHBoxLayout();
+    historyRangeCombo = new QComboBox(this);
+    for (const HistoryRange &range : HISTORY_RANGES) {
+        historyRangeCombo->addItem(range.label, range.msecs);
+    }
+    connect(historyRangeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MemoryWindow::historyRangeChanged);
+    rangeLayout->addWidget(new QLabel("Range:", this));
+    rangeLayout->addWidget(historyRangeCombo);
+    rangeLayout->addStretch();
+    chartsLayout->addLayout(rangeLayout);
+
     // Add charts to layout
     QHBoxLayout *chartViewsLayout = new QHBoxLayout();
     chartViewsLayout->addWidget(ramChartView);
     chartViewsLayout->addWidget(swapChartView);
     chartsLayout->addLayout(chartViewsLayout);
 
+    // Any meminfo or vmstat key, charted when picked; counters as rates
+    QHBoxLayout *statLayout = new QHBoxLayout();
+    statCombo = new QComboBox(this);
+    const std::vector<MemoryStatKey> &keys = memoryStats.getKeys();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        QString name = QString::fromStdString(keys[i].name);
+        statCombo->addItem(keys[i].counter ? name + " /s" : name, static_cast<int>(i));
+    }
+    int dirtyIndex = statCombo->findData(memoryStats.indexOf("Dirty"));
+    if (dirtyIndex >= 0) {
+        statCombo->setCurrentIndex(dirtyIndex);
+    }
+    connect(statCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MemoryWindow::statSelectionChanged);
+
+    statValueLabel = new QLabel(this);
+    statLayout->addWidget(new QLabel("Statistic:", this));
+    statLayout->addWidget(statCombo);
+    statLayout->addWidget(statValueLabel);
+    statLayout->addStretch();
+    chartsLayout->addLayout(statLayout);
+
+    statChart = new QChart();
+    statChart->legend()->setVisible(false);
+
+    statSeries = new QLineSeries();
+    statChart->addSeries(statSeries);
+
+    QDateTimeAxis *statTimeAxis = new QDateTimeAxis;
+    statTimeAxis->setFormat("hh:mm:ss");
+    statTimeAxis->setTitleText("Time");
+    statChart->addAxis(statTimeAxis, Qt::AlignBottom);
+
+    QValueAxis *statValueAxis = new QValueAxis;
+    statValueAxis->setLabelFormat("%.1f");
+    statChart->addAxis(statValueAxis, Qt::AlignLeft);
+
+    statChartPoints.addSeries(statSeries);
+    statChartPoints.setTimeAxis(statTimeAxis);
+    statChartPoints.setWindowMsecs(historyRangeMsecs);
+
+    statSeries->attachAxis(statTimeAxis);
+    statSeries->attachAxis(statValueAxis);
+
+    statChartView = new QChartView(statChart);
+    statChartView->setRenderHint(QPainter::Antialiasing);
+    chartsLayout->addWidget(statChartView);
+
     mainLayout->addWidget(chartsGroup);
 
     // Controls at the bottom
@@ -173,6 +392,7 @@ void MemoryWindow::setupUI() {
 
     refreshButton = new QPushButton("Refresh", this);
     connect(refreshButton, &QPushButton::clicked, this, &MemoryWindow::refreshData);
+    connect(refreshButton, &QPushButton::clicked, [this]() { processScanner->requestScan(); });
 
     controlsLayout->addWidget(autoRefreshCheckbox);
     controlsLayout->addStretch();
@@ -189,26 +409,38 @@ void MemoryWindow::refreshData() {
     MemoryInfo info = getMemoryInfo();
 
     // Add to history
-    memoryHistory.push_back(info);
-    if (memoryHistory.size() > MAX_HISTORY_SIZE) {
-        memoryHistory.pop_front();
-    }
+    currentInfo = info;
+    appendHistory(info);
+    appendStatHistory(info.timestamp.toMSecsSinceEpoch());
 
-    // Update UI
+    // Update UI; the charts only take the new point
     updateUI();
+    updateForecasts(info);
+    updateCharts(info);
+
+    numaInfo.refresh();
+    updateNumaNodes();
+    updatePlacement();
+
+    fragmentation.refresh();
+    updateFragmentation(info.timestamp.toMSecsSinceEpoch());
 
     // Update last update time
-    lastUpdateLabel->setText("Last update: " + QDateTime::currentDateTime().toString("hh:mm:ss"));
+    lastUpdateLabel->setText(QString("Last update: %1 (read in %2 ms)")
+                                 .arg(info.timestamp.toString("hh:mm:ss"))
+                                 .arg(info.collectNs / 1e6, 0, 'f', 2));
+    lastUpdateLabel->setToolTip(QString("%1 refreshes skipped because the previous one was still running")
+                                    .arg(refreshTimer->getMissedTicks()));
 
     QApplication::restoreOverrideCursor();
 }
 
 void MemoryWindow::updateUI() {
-    if (memoryHistory.empty()) {
+    if (currentInfo.totalRam == 0) {
         return;
     }
 
-    const MemoryInfo &info = memoryHistory.back();
+    const MemoryInfo &info = currentInfo;
 
     // Update progress bars
     int ramUsagePercent = static_cast<int>((static_cast<double>(info.usedRam) / info.totalRam) * 100);
@@ -218,7 +450,7 @@ void MemoryWindow::updateUI() {
                              .arg(formatSize(info.usedRam))
                              .arg(formatSize(info.totalRam)));
 
-    // Set color based on usage
+    // Set color based on usage; restyling is costly, so only on a change
     QString ramStyle = "QProgressBar { text-align: center; } QProgressBar::chunk { ";
     if (ramUsagePercent < 60) {
         ramStyle += "background-color: #4CAF50; }"; // Green
@@ -227,7 +459,9 @@ void MemoryWindow::updateUI() {
     } else {
         ramStyle += "background-color: #F44336; }"; // Red
     }
-    ramProgressBar->setStyleSheet(ramStyle);
+    if (ramProgressBar->styleSheet() != ramStyle) {
+        ramProgressBar->setStyleSheet(ramStyle);
+    }
 
     int swapUsagePercent = 0;
     if (info.totalSwap > 0) {
@@ -248,130 +482,570 @@ void MemoryWindow::updateUI() {
     } else {
         swapStyle += "background-color: #F44336; }"; // Red
     }
-    swapProgressBar->setStyleSheet(swapStyle);
+    if (swapProgressBar->styleSheet() != swapStyle) {
+        swapProgressBar->setStyleSheet(swapStyle);
+    }
 
-    // Update table
-    memoryTable->setRowCount(0);
+    // Update table cells in place
+    setDetail(TotalRamRow, formatSize(info.totalRam));
+    setDetail(UsedRamRow, formatSize(info.usedRam));
+    setDetail(FreeRamRow, formatSize(info.freeRam));
+    setDetail(AvailableRamRow, formatSize(info.availableRam));
+    setDetail(BuffersRow, formatSize(info.buffers));
+    setDetail(CachedRow, formatSize(info.cached));
+    setDetail(SharedMemoryRow, formatSize(info.shmem));
+    setDetail(TotalSwapRow, formatSize(info.totalSwap));
+    setDetail(UsedSwapRow, formatSize(info.usedSwap));
+    setDetail(FreeSwapRow, formatSize(info.freeSwap));
+    setDetail(RamUsageRow, QString("%1%").arg(ramUsagePercent));
+    setDetail(SwapUsageRow, QString("%1%").arg(swapUsagePercent));
+}
+
+void MemoryWindow::updateForecasts(const MemoryInfo &info) {
+    double seconds = SampleClock::toSeconds(info.sampledNs);
+    availableRamTrend.add(seconds, static_cast<double>(info.availableRam));
+    setForecastLabel(ramForecastLabel, availableRamTrend.forecast(0.0), "RAM", "hour");
 
-    auto addRow = [this](const QString &metric, const QString &value) {
-        int row = memoryTable->rowCount();
-        memoryTable->insertRow(row);
-        memoryTable->setItem(row, 0, new QTableWidgetItem(metric));
-        memoryTable->setItem(row, 1, new QTableWidgetItem(value));
+    if (info.totalSwap > 0) {
+        freeSwapTrend.add(seconds, static_cast<double>(info.freeSwap));
+        setForecastLabel(swapForecastLabel, freeSwapTrend.forecast(0.0), "Swap", "hour");
+    } else {
+        swapForecastLabel->clear();
+    }
+}
+
+void MemoryWindow::setDetail(DetailRow row, const QString &value) {
+    QTableWidgetItem *item = memoryTable->item(row, 1);
+    if (item->text() != value) {
+        item->setText(value);
+    }
+}
+
+void MemoryWindow::openHistoryFiles() {
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/history";
+    if (!QDir().mkpath(directory)) {
+        qWarning() << "Memory history will not be kept: cannot create" << directory;
+        return;
+    }
+
+    const std::pair<TimeSeries*, const char*> files[] = {
+        {&usedRamHistory, "memory-used.ring"},
+        {&cachedHistory, "memory-cached.ring"},
+        {&buffersHistory, "memory-buffers.ring"},
+        {&usedSwapHistory, "swap-used.ring"},
     };
+    for (const auto &file : files) {
+        QString path = directory + "/" + file.second;
+        if (!file.first->attachFile(QFile::encodeName(path).toStdString())) {
+            qWarning() << "Memory history will not be kept in" << path;
+        }
+    }
+}
 
-    addRow("Total RAM", formatSize(info.totalRam));
-    addRow("Used RAM", formatSize(info.usedRam));
-    addRow("Free RAM", formatSize(info.freeRam));
-    addRow("Available RAM", formatSize(info.availableRam));
-    addRow("Buffers", formatSize(info.buffers));
-    addRow("Cached", formatSize(info.cached));
-    addRow("Shared Memory", formatSize(info.shmem));
-    addRow("Total Swap", formatSize(info.totalSwap));
-    addRow("Used Swap", formatSize(info.usedSwap));
-    addRow("Free Swap", formatSize(info.freeSwap));
-    addRow("RAM Usage", QString("%1%").arg(ramUsagePercent));
-    addRow("Swap Usage", QString("%1%").arg(swapUsagePercent));
-
-    // Update charts
-    ramUsageSeries->clear();
-    ramCachedSeries->clear();
-    ramBuffersSeries->clear();
-    swapUsageSeries->clear();
+void MemoryWindow::appendHistory(const MemoryInfo &info) {
+    qint64 msecsSinceEpoch = info.timestamp.toMSecsSinceEpoch();
+    usedRamHistory.append(msecsSinceEpoch, static_cast<double>(info.usedRam));
+    cachedHistory.append(msecsSinceEpoch, static_cast<double>(info.cached));
+    buffersHistory.append(msecsSinceEpoch, static_cast<double>(info.buffers));
+    usedSwapHistory.append(msecsSinceEpoch, static_cast<double>(info.usedSwap));
+}
 
+void MemoryWindow::updateCharts(const MemoryInfo &info) {
     // Convert to GB for better readability in charts
     const double GB = 1024.0 * 1024.0 * 1024.0;
+    qint64 msecsSinceEpoch = info.timestamp.toMSecsSinceEpoch();
+
+    // Repaint each chart once after all of its series and axes moved
+    ramChartView->setUpdatesEnabled(false);
+    swapChartView->setUpdatesEnabled(false);
+
+    // Raw samples roll in one point at a time; a coarser tier only changes
+    // when it completes a bucket, which reloads a few hundred points at most
+    TimeSeriesTier tier = usedRamHistory.tierFor(msecsSinceEpoch - historyRangeMsecs, msecsSinceEpoch,
+                                                 MAX_CHART_POINTS);
+    if (tier == TimeSeriesTier::RAW && chartTier == TimeSeriesTier::RAW) {
+        ramChartPoints.append(msecsSinceEpoch, {info.usedRam / GB, info.cached / GB, info.buffers / GB});
+        swapChartPoints.append(msecsSinceEpoch, {info.usedSwap / GB});
+    } else if (tier != chartTier || usedRamHistory.getBucketCount(tier) != chartBucketCount) {
+        reloadCharts();
+    }
+
+    // Value axes only move when RAM or swap is resized
+    double maxRamValue = info.totalRam / GB;
+    if (maxRamValue != ramAxisMax) {
+        qobject_cast<QValueAxis*>(ramChart->axes(Qt::Vertical).first())->setRange(0, maxRamValue);
+        ramAxisMax = maxRamValue;
+    }
+
+    double maxSwapValue = std::max(1.0, info.totalSwap / GB); // At least 1 GB for visibility
+    if (maxSwapValue != swapAxisMax) {
+        qobject_cast<QValueAxis*>(swapChart->axes(Qt::Vertical).first())->setRange(0, maxSwapValue);
+        swapAxisMax = maxSwapValue;
+    }
+
+    ramChartView->setUpdatesEnabled(true);
+    swapChartView->setUpdatesEnabled(true);
+}
+
+void MemoryWindow::reloadCharts() {
+    const double GB = 1024.0 * 1024.0 * 1024.0;
+    if (usedRamHistory.isEmpty()) {
+        return;
+    }
+
+    qint64 to = usedRamHistory.getLastTime();
+    qint64 from = to - historyRangeMsecs;
+    chartTier = usedRamHistory.tierFor(from, to, MAX_CHART_POINTS);
+    chartBucketCount = usedRamHistory.getBucketCount(chartTier);
+
+    // Buckets are drawn at their average. The files are written one after
+    // another, so after a crash one may lack the last sample of another;
+    // align on the times of used RAM and repeat a value where one is missing
+    const TimeSeries *sources[] = {&usedRamHistory, &cachedHistory, &buffersHistory, &usedSwapHistory};
+    QVector<qint64> times;
+    std::vector<QVector<double>> values(4);
+    for (const TimeSeriesPoint &point : usedRamHistory.range(chartTier, from, to)) {
+        times.append(point.timeMs);
+        values[0].append(point.avg / GB);
+    }
+    for (int i = 1; i < 4; ++i) {
+        std::vector<TimeSeriesPoint> points = sources[i]->range(chartTier, from, to);
+        size_t cursor = 0;
+        double value = 0.0;
+        for (qint64 time : times) {
+            while (cursor < points.size() && points[cursor].timeMs <= time) {
+                value = points[cursor++].avg / GB;
+            }
+            values[i].append(value);
+        }
+    }
+
+    ramChartPoints.replace(times, {values[0], values[1], values[2]});
+    swapChartPoints.replace(times, {values[3]});
+}
+
+void MemoryWindow::historyRangeChanged(int index) {
+    historyRangeMsecs = historyRangeCombo->itemData(index).toLongLong();
+    ramChartPoints.setWindowMsecs(historyRangeMsecs);
+    swapChartPoints.setWindowMsecs(historyRangeMsecs);
+
+    // Dates matter once the range spans more than a day
+    QString format = historyRangeMsecs > 24LL * 60 * 60 * 1000 ? "MM-dd hh:mm" : "hh:mm:ss";
+    for (QChart *chart : {ramChart, swapChart, statChart, fragmentationChart}) {
+        qobject_cast<QDateTimeAxis*>(chart->axes(Qt::Horizontal).first())->setFormat(format);
+    }
+
+    ramChartView->setUpdatesEnabled(false);
+    swapChartView->setUpdatesEnabled(false);
+    reloadCharts();
+    ramChartView->setUpdatesEnabled(true);
+    swapChartView->setUpdatesEnabled(true);
+
+    statChartPoints.setWindowMsecs(historyRangeMsecs);
+    fragmentationChartPoints.setWindowMsecs(historyRangeMsecs);
+    reloadStatChart();
+}
+
+void MemoryWindow::statSelectionChanged(int) {
+    reloadStatChart();
+}
 
-    for (const auto &historyItem : memoryHistory) {
-        qint64 msecsSinceEpoch = historyItem.timestamp.toMSecsSinceEpoch();
+void MemoryWindow::appendStatHistory(qint64 msecsSinceEpoch) {
+    // Gauges as read, counters as their rate once there is one
+    const std::vector<MemoryStatKey> &keys = memoryStats.getKeys();
+    const std::vector<uint64_t> &values = memoryStats.getValues();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!keys[i].counter) {
+            statHistory[i].append(msecsSinceEpoch, static_cast<double>(values[i]));
+        } else if (memoryStats.hasRates()) {
+            statHistory[i].append(msecsSinceEpoch, memoryStats.getRate(i));
+        }
+    }
 
-        // RAM chart
-        double usedRamGB = historyItem.usedRam / GB;
-        double cachedGB = historyItem.cached / GB;
-        double buffersGB = historyItem.buffers / GB;
+    int index = statCombo->currentData().toInt();
+    if (index < 0 || index >= static_cast<int>(keys.size()) || (keys[index].counter && !memoryStats.hasRates())) {
+        return;
+    }
 
-        ramUsageSeries->append(msecsSinceEpoch, usedRamGB);
-        ramCachedSeries->append(msecsSinceEpoch, cachedGB);
-        ramBuffersSeries->append(msecsSinceEpoch, buffersGB);
+    double value = keys[index].counter ? memoryStats.getRate(index) : static_cast<double>(values[index]);
+    statValueLabel->setText(formatStat(index, value));
 
-        // Swap chart
-        double usedSwapGB = historyItem.usedSwap / GB;
-        swapUsageSeries->append(msecsSinceEpoch, usedSwapGB);
+    // Only the selected key is on screen; the axis grows to fit
+    double chartValue = statChartValue(index, value);
+    statChartView->setUpdatesEnabled(false);
+    statChartPoints.append(msecsSinceEpoch, {chartValue});
+    if (chartValue > statAxisMax) {
+        statAxisMax = chartValue * 1.2;
+        qobject_cast<QValueAxis*>(statChart->axes(Qt::Vertical).first())->setRange(0, statAxisMax);
+    }
+    if (statChartStartMsecs == 0) {
+        statChartStartMsecs = msecsSinceEpoch;
     }
+    updateStatChartTitle(msecsSinceEpoch);
+    statChartView->setUpdatesEnabled(true);
+}
 
-    // Update chart axes
-    if (!memoryHistory.empty()) {
-        QDateTime firstTime = memoryHistory.front().timestamp;
-        QDateTime lastTime = memoryHistory.back().timestamp;
+void MemoryWindow::reloadStatChart() {
+    int index = statCombo->currentData().toInt();
+    const std::vector<MemoryStatKey> &keys = memoryStats.getKeys();
+    if (index < 0 || index >= static_cast<int>(keys.size())) {
+        return;
+    }
 
-        // RAM chart
-        QDateTimeAxis *ramTimeAxis = qobject_cast<QDateTimeAxis*>(ramChart->axes(Qt::Horizontal).first());
-        ramTimeAxis->setRange(firstTime, lastTime);
+    std::vector<int64_t> times;
+    std::vector<double> values;
+    qint64 to = SampleClock::toWallMsecs(SampleClock::nowNs());
+    statHistory[index].decode(to - historyRangeMsecs, to, times, values);
+
+    QVector<qint64> chartTimes;
+    QVector<double> chartValues;
+    double maxValue = 0.0;
+    for (size_t i = 0; i < times.size(); ++i) {
+        double chartValue = statChartValue(index, values[i]);
+        chartTimes.append(times[i]);
+        chartValues.append(chartValue);
+        maxValue = std::max(maxValue, chartValue);
+    }
 
-        QValueAxis *ramValueAxis = qobject_cast<QValueAxis*>(ramChart->axes(Qt::Vertical).first());
-        double maxRamValue = info.totalRam / GB;
-        ramValueAxis->setRange(0, maxRamValue);
+    statChartView->setUpdatesEnabled(false);
+    statChartPoints.replace(chartTimes, {chartValues});
 
-        // Swap chart
-        QDateTimeAxis *swapTimeAxis = qobject_cast<QDateTimeAxis*>(swapChart->axes(Qt::Horizontal).first());
-        swapTimeAxis->setRange(firstTime, lastTime);
+    const char *unitTitle = "Count";
+    if (keys[index].counter) {
+        unitTitle = "Per second";
+    } else if (keys[index].unit == MemoryStatUnit::BYTES) {
+        unitTitle = "MB";
+    } else if (keys[index].unit == MemoryStatUnit::PAGES) {
+        unitTitle = "Pages";
+    }
+    statChartStartMsecs = times.empty() ? 0 : times.front();
+    updateStatChartTitle(to);
+    QValueAxis *valueAxis = qobject_cast<QValueAxis*>(statChart->axes(Qt::Vertical).first());
+    valueAxis->setTitleText(unitTitle);
+    statAxisMax = maxValue > 0.0 ? maxValue * 1.2 : 1.0;
+    valueAxis->setRange(0, statAxisMax);
+    statChartView->setUpdatesEnabled(true);
+
+    statValueLabel->setText(values.empty() ? QString() : formatStat(index, values.back()));
+}
 
-        QValueAxis *swapValueAxis = qobject_cast<QValueAxis*>(swapChart->axes(Qt::Vertical).first());
-        double maxSwapValue = std::max(1.0, info.totalSwap / GB); // At least 1 GB for visibility
-        swapValueAxis->setRange(0, maxSwapValue);
+void MemoryWindow::updateStatChartTitle(qint64 latestMsecs) {
+    // A point or two short of the range is just sampling; anything more is
+    // history the key never had or its compressed blocks no longer hold
+    const qint64 slackMsecs = 60 * 1000;
+    QString title = statCombo->currentText();
+    if (statChartStartMsecs == 0) {
+        title += " (no history yet)";
+    } else if (latestMsecs - statChartStartMsecs + slackMsecs < historyRangeMsecs) {
+        double seconds = (latestMsecs - statChartStartMsecs) / 1000.0;
+        title += QString(" (last %1 kept)").arg(QString::fromStdString(TrendEstimator::formatDuration(seconds)));
+    }
+    if (statChart->title() != title) {
+        statChart->setTitle(title);
     }
 }
 
-MemoryInfo MemoryWindow::getMemoryInfo() {
-    MemoryInfo info = {};
-    info.timestamp = QDateTime::currentDateTime();
+double MemoryWindow::statChartValue(size_t index, double value) const {
+    if (memoryStats.getKeys()[index].unit == MemoryStatUnit::BYTES) {
+        return value / (1024.0 * 1024.0);
+    }
+    return value;
+}
 
-    // Read /proc/meminfo
-    QFile file("/proc/meminfo");
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Failed to open /proc/meminfo";
-        return info;
+QString MemoryWindow::formatStat(size_t index, double value) const {
+    const MemoryStatKey &key = memoryStats.getKeys()[index];
+    if (key.counter) {
+        return QString("%1 /s").arg(value, 0, 'f', 1);
+    }
+    if (key.unit == MemoryStatUnit::BYTES) {
+        return formatSize(static_cast<uint64_t>(value));
+    }
+    if (key.unit == MemoryStatUnit::PAGES) {
+        return QString("%1 pages").arg(static_cast<qulonglong>(value));
+    }
+    return QString::number(static_cast<qulonglong>(value));
+}
+
+void MemoryWindow::processSnapshotReady() {
+    // The scanner may be running for another page while this one is hidden
+    std::shared_ptr<const ProcessSnapshot> latest = processScanner->getSnapshot();
+    if (!isVisible() || !latest || latest == processSnapshot) {
+        return;
+    }
+    processSnapshot = std::move(latest);
+
+    smapsSampler.update(processSnapshot->processes);
+    updateTopConsumers();
+}
+
+void MemoryWindow::updateTopConsumers() {
+    std::vector<SmapsRollupInfo> top = smapsSampler.getTopConsumers(TOP_CONSUMER_COUNT);
+
+    // Temporarily disable sorting while updating the table
+    topConsumersTable->setSortingEnabled(false);
+    topConsumersTable->clearContents();
+    topConsumersTable->setRowCount(static_cast<int>(top.size()));
+
+    auto setCell = [this](int row, int column, const QString &text, double value) {
+        QTableWidgetItem *item = new NumericTableItem();
+        item->setText(text);
+        item->setData(Qt::UserRole, value);
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        topConsumersTable->setItem(row, column, item);
+    };
+
+    for (size_t i = 0; i < top.size(); ++i) {
+        const SmapsRollupInfo &process = top[i];
+        int row = static_cast<int>(i);
+
+        setCell(row, PidColumn, QString::number(process.pid), process.pid);
+        topConsumersTable->setItem(row, NameColumn, new QTableWidgetItem(QString::fromStdString(process.name)));
+        setCell(row, PssColumn, formatSize(process.pssBytes), static_cast<double>(process.pssBytes));
+        setCell(row, UssColumn, formatSize(process.ussBytes), static_cast<double>(process.ussBytes));
+        setCell(row, RssColumn, formatSize(process.rssBytes), static_cast<double>(process.rssBytes));
+        setCell(row, SwapColumn, formatSize(process.swapBytes), static_cast<double>(process.swapBytes));
+        setCell(row, AgeColumn, QString("%1 s").arg(process.ageSeconds, 0, 'f', 0), process.ageSeconds);
+
+        topConsumersTable->item(row, SwapColumn)->setToolTip(
+            QString("Proportional swap: %1").arg(formatSize(process.swapPssBytes)));
+    }
+
+    topConsumersTable->setSortingEnabled(true);
+
+    topConsumersLabel->setText(QString("%1 of %2 processes sampled; %3 read this refresh in %4 ms (budget %5 ms)")
+                                   .arg(smapsSampler.getSampledCount())
+                                   .arg(smapsSampler.getProcessCount())
+                                   .arg(smapsSampler.getLastSampleCount())
+                                   .arg(smapsSampler.getLastSampleDurationMs(), 0, 'f', 1)
+                                   .arg(smapsSampler.getBudgetMs(), 0, 'f', 0));
+}
+
+void MemoryWindow::setupFragmentationGroup(QVBoxLayout *mainLayout) {
+    QGroupBox *fragmentationGroup = new QGroupBox("Fragmentation", this);
+    QVBoxLayout *fragmentationLayout = new QVBoxLayout(fragmentationGroup);
+
+    thpLabel = new QLabel(this);
+    thpLabel->setWordWrap(true);
+    fragmentationLayout->addWidget(thpLabel);
+
+    // Free blocks per buddy order for each zone
+    const std::vector<ZoneFragmentation> &zones = fragmentation.getZones();
+    int orderCount = 0;
+    for (const ZoneFragmentation &zone : zones) {
+        orderCount = std::max(orderCount, zone.orderCount);
     }
 
-    QTextStream in(&file);
-    QString line;
-
-    while (in.readLineInto(&line)) {
-        QStringList parts = line.split(":");
-        if (parts.size() < 2) continue;
-
-        QString key = parts[0].trimmed();
-        QString valueStr = parts[1].trimmed();
-
-        // Remove " kB" suffix and convert to bytes
-        valueStr.remove(" kB");
-        uint64_t value = valueStr.toULongLong() * 1024; // Convert KB to bytes
-
-        if (key == "MemTotal") {
-            info.totalRam = value;
-        } else if (key == "MemFree") {
-            info.freeRam = value;
-        } else if (key == "MemAvailable") {
-            info.availableRam = value;
-        } else if (key == "Buffers") {
-            info.buffers = value;
-        } else if (key == "Cached") {
-            info.cached = value;
-        } else if (key == "Shmem") {
-            info.shmem = value;
-        } else if (key == "SwapTotal") {
-            info.totalSwap = value;
-        } else if (key == "SwapFree") {
-            info.freeSwap = value;
+    QStringList headers = {"Node", "Zone"};
+    for (int order = 0; order < orderCount; ++order) {
+        headers << QString("Order %1").arg(order);
+    }
+    headers << "Free" << "Unusable";
+
+    fragmentationTable = new QTableWidget(0, headers.size(), this);
+    fragmentationTable->setHorizontalHeaderLabels(headers);
+    fragmentationTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    fragmentationTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    fragmentationTable->setAlternatingRowColors(true);
+    fragmentationTable->verticalHeader()->setVisible(false);
+    fragmentationTable->horizontalHeaderItem(headers.size() - 1)->setToolTip(
+        QString("Share of free memory in blocks smaller than a huge page (order %1); "
+                "high values mean huge page allocations need compaction").arg(fragmentation.getHugeOrder()));
+    fragmentationLayout->addWidget(fragmentationTable);
+
+    // Free memory in huge-page-sized blocks over time, one line per zone
+    fragmentationChart = new QChart();
+    fragmentationChart->setTitle(QString("Free Memory in Blocks of Order %1 or Higher").arg(fragmentation.getHugeOrder()));
+    fragmentationChart->legend()->setVisible(true);
+    fragmentationChart->legend()->setAlignment(Qt::AlignBottom);
+
+    QDateTimeAxis *timeAxis = new QDateTimeAxis;
+    timeAxis->setFormat("hh:mm:ss");
+    timeAxis->setTitleText("Time");
+    fragmentationChart->addAxis(timeAxis, Qt::AlignBottom);
+
+    QValueAxis *valueAxis = new QValueAxis;
+    valueAxis->setTitleText("Memory (MB)");
+    valueAxis->setLabelFormat("%.0f");
+    fragmentationChart->addAxis(valueAxis, Qt::AlignLeft);
+
+    for (const ZoneFragmentation &zone : zones) {
+        QLineSeries *series = new QLineSeries();
+        series->setName(QString("Node %1 %2").arg(zone.node).arg(zone.zone));
+        fragmentationChart->addSeries(series);
+        series->attachAxis(timeAxis);
+        series->attachAxis(valueAxis);
+        fragmentationChartPoints.addSeries(series);
+    }
+    fragmentationChartPoints.setTimeAxis(timeAxis);
+    fragmentationChartPoints.setWindowMsecs(historyRangeMsecs);
+
+    fragmentationChartView = new QChartView(fragmentationChart);
+    fragmentationChartView->setRenderHint(QPainter::Antialiasing);
+    fragmentationLayout->addWidget(fragmentationChartView);
+
+    mainLayout->addWidget(fragmentationGroup);
+}
+
+void MemoryWindow::updateFragmentation(qint64 msecsSinceEpoch) {
+    auto rate = [this](const char *name) {
+        int index = memoryStats.indexOf(name);
+        return index >= 0 ? memoryStats.getRate(index) : 0.0;
+    };
+
+    thpLabel->setText(QString("Transparent huge pages: %1, defrag %2. THP faults %3/s, fallbacks %4/s, "
+                              "collapses %5/s (failed %6/s), splits %7/s. "
+                              "Compaction stalls %8/s, failed %9/s, succeeded %10/s.")
+                          .arg(QString::fromStdString(fragmentation.getThpEnabled()))
+                          .arg(QString::fromStdString(fragmentation.getThpDefrag()))
+                          .arg(rate("thp_fault_alloc"), 0, 'f', 1)
+                          .arg(rate("thp_fault_fallback"), 0, 'f', 1)
+                          .arg(rate("thp_collapse_alloc"), 0, 'f', 1)
+                          .arg(rate("thp_collapse_alloc_failed"), 0, 'f', 1)
+                          .arg(rate("thp_split_page"), 0, 'f', 1)
+                          .arg(rate("compact_stall"), 0, 'f', 1)
+                          .arg(rate("compact_fail"), 0, 'f', 1)
+                          .arg(rate("compact_success"), 0, 'f', 1));
+
+    const std::vector<ZoneFragmentation> &zones = fragmentation.getZones();
+    const uint64_t pageSize = fragmentation.getPageSize();
+    const int columns = fragmentationTable->columnCount();
+    const int orderColumns = columns - 4;
+
+    auto setCell = [this](int row, int column, const QString &text) {
+        QTableWidgetItem *item = fragmentationTable->item(row, column);
+        if (!item) {
+            item = new QTableWidgetItem();
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            fragmentationTable->setItem(row, column, item);
+        }
+        if (item->text() != text) {
+            item->setText(text);
         }
+        return item;
+    };
+
+    fragmentationTable->setRowCount(static_cast<int>(zones.size()));
+    std::vector<double> chartValues;
+    for (size_t i = 0; i < zones.size(); ++i) {
+        const ZoneFragmentation &zone = zones[i];
+        int row = static_cast<int>(i);
+
+        setCell(row, 0, QString::number(zone.node));
+        setCell(row, 1, QString::fromLatin1(zone.zone));
+        for (int order = 0; order < orderColumns; ++order) {
+            QTableWidgetItem *item = setCell(row, 2 + order,
+                order < zone.orderCount ? QString::number(zone.freeBlocks[order]) : QString());
+
+            // Which migrate types the free blocks belong to
+            QStringList types;
+            for (int type = 0; type < zone.migrateTypeCount && order < zone.orderCount; ++type) {
+                bool lowerBound = zone.lowerBoundsByType[type] & (1u << order);
+                types << QString("%1: %2%3").arg(zone.migrateTypes[type])
+                                            .arg(lowerBound ? ">" : "")
+                                            .arg(zone.freeBlocksByType[type][order]);
+            }
+            item->setToolTip(fragmentation.hasPageTypeInfo()
+                ? types.join("\n") : QString("Per migrate type counts need read access to /proc/pagetypeinfo"));
+        }
+        setCell(row, columns - 2, formatSize(zone.freePages * pageSize));
+        setCell(row, columns - 1, QString("%1%").arg(zone.unusableIndex * 100.0, 0, 'f', 1));
+
+        chartValues.push_back(static_cast<double>(zone.hugeFreePages * pageSize) / (1024.0 * 1024.0));
+    }
+
+    // The axis grows to the largest value seen
+    fragmentationChartView->setUpdatesEnabled(false);
+    fragmentationChartPoints.append(msecsSinceEpoch, chartValues);
+    double maxValue = chartValues.empty() ? 0.0 : *std::max_element(chartValues.begin(), chartValues.end());
+    if (maxValue > fragmentationAxisMax) {
+        fragmentationAxisMax = maxValue * 1.2;
+        qobject_cast<QValueAxis*>(fragmentationChart->axes(Qt::Vertical).first())->setRange(0, fragmentationAxisMax);
+    }
+    fragmentationChartView->setUpdatesEnabled(true);
+}
+
+void MemoryWindow::updateNumaNodes() {
+    const std::vector<NumaNodeInfo> &nodes = numaInfo.getNodes();
+    for (size_t i = 0; i < nodeBars.size() && i < nodes.size(); ++i) {
+        const NumaNodeInfo &node = nodes[i];
+        int usagePercent = node.totalBytes > 0
+            ? static_cast<int>((static_cast<double>(node.usedBytes) / node.totalBytes) * 100) : 0;
+        nodeBars[i]->setValue(usagePercent);
+        nodeBars[i]->setFormat(QString("%1% (%2 / %3)")
+                               .arg(usagePercent)
+                               .arg(formatSize(node.usedBytes))
+                               .arg(formatSize(node.totalBytes)));
+
+        nodeRateLabels[i]->setText(QString("local %1/s, remote %2/s, miss %3/s, foreign %4/s")
+                                   .arg(node.localRate, 0, 'f', 0)
+                                   .arg(node.otherRate, 0, 'f', 0)
+                                   .arg(node.missRate, 0, 'f', 0)
+                                   .arg(node.foreignRate, 0, 'f', 0));
     }
+}
 
-    file.close();
+void MemoryWindow::topConsumerSelectionChanged() {
+    // Rebuilding the table clears the selection; keep the last process then
+    QList<QTableWidgetItem*> selected = topConsumersTable->selectedItems();
+    if (selected.isEmpty()) {
+        return;
+    }
+
+    QTableWidgetItem *pidItem = topConsumersTable->item(selected.first()->row(), PidColumn);
+    if (pidItem) {
+        placementPid = pidItem->data(Qt::UserRole).toInt();
+        updatePlacement();
+    }
+}
+
+void MemoryWindow::updatePlacement() {
+    if (placementPid < 0 || !numaInfo.isNuma()) {
+        return;
+    }
+
+    NumaPlacement placement;
+    if (!NumaInfoCollector::readPlacement(placementPid, placement)) {
+        numaPlacementLabel->setText(QString("PID %1: NUMA placement not readable").arg(placementPid));
+        return;
+    }
+
+    QStringList parts;
+    for (size_t i = 0; i < placement.nodes.size(); ++i) {
+        double share = placement.totalBytes > 0 ? 100.0 * placement.bytes[i] / placement.totalBytes : 0.0;
+        parts << QString("node %1: %2 (%3%, %4 anonymous)")
+                     .arg(placement.nodes[i])
+                     .arg(formatSize(placement.bytes[i]))
+                     .arg(share, 0, 'f', 0)
+                     .arg(formatSize(placement.anonBytes[i]));
+    }
+    numaPlacementLabel->setText(QString("PID %1: %2").arg(placementPid).arg(parts.join("; ")));
+}
+
+MemoryInfo MemoryWindow::getMemoryInfo() {
+    MemoryInfo info = {};
+    info.sampledNs = SampleClock::nowNs();
+    info.timestamp = QDateTime::fromMSecsSinceEpoch(SampleClock::toWallMsecs(info.sampledNs));
+
+    // Read /proc/meminfo and /proc/vmstat
+    if (!memoryStats.refresh()) {
+        qWarning() << "Failed to read /proc/meminfo";
+        return info;
+    }
+
+    info.totalRam = memoryStats.getValue("MemTotal");
+    info.freeRam = memoryStats.getValue("MemFree");
+    info.availableRam = memoryStats.getValue("MemAvailable");
+    info.buffers = memoryStats.getValue("Buffers");
+    info.cached = memoryStats.getValue("Cached");
+    info.shmem = memoryStats.getValue("Shmem");
+    info.totalSwap = memoryStats.getValue("SwapTotal");
+    info.freeSwap = memoryStats.getValue("SwapFree");
 
     // Calculate derived values
     info.usedRam = info.totalRam - info.freeRam - info.buffers - info.cached;
     info.usedSwap = info.totalSwap - info.freeSwap;
 
+    info.collectNs = SampleClock::nowNs() - info.sampledNs;
     return info;
 }
 
@@ -391,7 +1065,11 @@ QString MemoryWindow::formatSize(uint64_t bytes) const {
 void MemoryWindow::toggleAutoRefresh(bool enabled) {
     if (enabled) {
         refreshTimer->start(10000);
+        if (isVisible()) {
+            processScanner->addClient(this, 10000);
+        }
     } else {
         refreshTimer->stop();
+        processScanner->removeClient(this);
     }
 }
\ No newline at end of file
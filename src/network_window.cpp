@@ -10,8 +10,8 @@ NetworkWindow::NetworkWindow(QWidget *parent) : QWidget(parent) {
     updateTable();
 
     // Set up auto-refresh timer (every 5 seconds)
-    autoRefreshTimer = new QTimer(this);
-    connect(autoRefreshTimer, &QTimer::timeout, this, &NetworkWindow::refreshData);
+    autoRefreshTimer = new DeadlineTimer(this);
+    connect(autoRefreshTimer, &DeadlineTimer::timeout, this, &NetworkWindow::refreshData);
     autoRefreshTimer->start(5000);
 }
 
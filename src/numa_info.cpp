@@ -0,0 +1,216 @@
+#include "numa_info.h"
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const size_t READ_BUFFER_SIZE = 8192;
+
+// numa_maps of a large process is read in chunks of this size
+const size_t MAPS_CHUNK_SIZE = 64 * 1024;
+
+// Value after "<key>" in text, or 0
+uint64_t valueOf(const char* text, const char* key) {
+    const char* found = strstr(text, key);
+    return found ? strtoull(found + strlen(key), nullptr, 10) : 0;
+}
+
+double rateOf(uint64_t current, uint64_t previous, double elapsed) {
+    return current >= previous ? (current - previous) / elapsed : 0.0;
+}
+
+// Add one numa_maps line to the placement
+void addMapping(const char* line, const char* end, NumaPlacement& placement) {
+    uint64_t pageSize = 4096;
+    bool anon = false;
+
+    // Page size and type first; they come after the N<node>= fields
+    for (const char* token = line; token < end; ) {
+        const char* tokenEnd = static_cast<const char*>(memchr(token, ' ', end - token));
+        if (!tokenEnd) {
+            tokenEnd = end;
+        }
+        if (strncmp(token, "kernelpagesize_kB=", 18) == 0) {
+            pageSize = strtoull(token + 18, nullptr, 10) * 1024;
+        } else if (strncmp(token, "anon=", 5) == 0) {
+            anon = true;
+        }
+        token = tokenEnd + 1;
+    }
+
+    for (const char* token = line; token < end; ) {
+        const char* tokenEnd = static_cast<const char*>(memchr(token, ' ', end - token));
+        if (!tokenEnd) {
+            tokenEnd = end;
+        }
+        if (token[0] == 'N' && token[1] >= '0' && token[1] <= '9') {
+            char* equals = nullptr;
+            int node = static_cast<int>(strtol(token + 1, &equals, 10));
+            if (equals && *equals == '=') {
+                uint64_t bytes = strtoull(equals + 1, nullptr, 10) * pageSize;
+
+                auto it = std::lower_bound(placement.nodes.begin(), placement.nodes.end(), node);
+                size_t index = it - placement.nodes.begin();
+                if (it == placement.nodes.end() || *it != node) {
+                    placement.nodes.insert(it, node);
+                    placement.bytes.insert(placement.bytes.begin() + index, 0);
+                    placement.anonBytes.insert(placement.anonBytes.begin() + index, 0);
+                }
+                placement.bytes[index] += bytes;
+                if (anon) {
+                    placement.anonBytes[index] += bytes;
+                }
+                placement.totalBytes += bytes;
+            }
+        }
+        token = tokenEnd + 1;
+    }
+}
+
+} // namespace
+
+NumaInfoCollector::NumaInfoCollector()
+    : buffer(READ_BUFFER_SIZE),
+      hasPreviousRefresh(false) {
+
+    discoverNodes();
+    refresh();
+}
+
+void NumaInfoCollector::discoverNodes() {
+    const std::string nodeRoot = "/sys/devices/system/node";
+    std::error_code ec;
+
+    std::vector<int> found;
+    for (const auto& entry : fs::directory_iterator(nodeRoot, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+            std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+            found.push_back(std::stoi(name.substr(4)));
+        }
+    }
+    std::sort(found.begin(), found.end());
+
+    for (int node : found) {
+        std::string directory = nodeRoot + "/node" + std::to_string(node);
+        NodeHandle handle{SysfsFile(directory + "/meminfo"), SysfsFile(directory + "/numastat")};
+        if (!handle.meminfo.isOpen()) {
+            continue;
+        }
+
+        NumaNodeInfo info{};
+        info.node = node;
+        nodes.push_back(info);
+        handles.push_back(std::move(handle));
+    }
+}
+
+void NumaInfoCollector::refresh() {
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastRefresh).count();
+    bool withRates = hasPreviousRefresh && elapsed > 0.0;
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        NumaNodeInfo& info = nodes[i];
+
+        // "Node 0 MemTotal:        5209848 kB"
+        if (handles[i].meminfo.read(buffer.data(), buffer.size()) > 0) {
+            const char* text = buffer.data();
+            info.totalBytes = valueOf(text, "MemTotal:") * 1024;
+            info.freeBytes = valueOf(text, "MemFree:") * 1024;
+            info.usedBytes = valueOf(text, "MemUsed:") * 1024;
+            info.filePagesBytes = valueOf(text, "FilePages:") * 1024;
+            info.anonPagesBytes = valueOf(text, "AnonPages:") * 1024;
+        }
+
+        if (handles[i].numastat.read(buffer.data(), buffer.size()) > 0) {
+            NumaNodeInfo previous = info;
+            const char* text = buffer.data();
+            info.numaHit = valueOf(text, "numa_hit ");
+            info.numaMiss = valueOf(text, "numa_miss ");
+            info.numaForeign = valueOf(text, "numa_foreign ");
+            info.interleaveHit = valueOf(text, "interleave_hit ");
+            info.localNode = valueOf(text, "local_node ");
+            info.otherNode = valueOf(text, "other_node ");
+
+            if (withRates) {
+                info.hitRate = rateOf(info.numaHit, previous.numaHit, elapsed);
+                info.missRate = rateOf(info.numaMiss, previous.numaMiss, elapsed);
+                info.foreignRate = rateOf(info.numaForeign, previous.numaForeign, elapsed);
+                info.localRate = rateOf(info.localNode, previous.localNode, elapsed);
+                info.otherRate = rateOf(info.otherNode, previous.otherNode, elapsed);
+            }
+        }
+    }
+
+    lastRefresh = now;
+    hasPreviousRefresh = true;
+}
+
+const std::vector<NumaNodeInfo>& NumaInfoCollector::getNodes() const {
+    return nodes;
+}
+
+bool NumaInfoCollector::isNuma() const {
+    size_t withMemory = 0;
+    for (const auto& node : nodes) {
+        if (node.totalBytes > 0) {
+            withMemory++;
+        }
+    }
+    return withMemory > 1;
+}
+
+bool NumaInfoCollector::readPlacement(int pid, NumaPlacement& placement) {
+    placement = NumaPlacement{};
+
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/numa_maps", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Lines can straddle chunks; keep the unfinished tail for the next read
+    std::vector<char> chunk(MAPS_CHUNK_SIZE);
+    size_t pending = 0;
+    bool ok = true;
+    for (;;) {
+        ssize_t length = read(fd, chunk.data() + pending, chunk.size() - pending);
+        if (length < 0) {
+            ok = false;
+            break;
+        }
+        size_t available = pending + length;
+
+        const char* line = chunk.data();
+        const char* end = chunk.data() + available;
+        while (const char* newline = static_cast<const char*>(memchr(line, '\n', end - line))) {
+            addMapping(line, newline, placement);
+            line = newline + 1;
+        }
+
+        pending = end - line;
+        if (length == 0) {
+            if (pending > 0) {
+                addMapping(line, end, placement);
+            }
+            break;
+        }
+        if (pending == chunk.size()) {
+            pending = 0;    // A line longer than the chunk; skip it
+        } else {
+            memmove(chunk.data(), line, pending);
+        }
+    }
+
+    close(fd);
+    return ok;
+}
@@ -0,0 +1,289 @@
+#include "perf_counters.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+namespace {
+
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+    int slot;
+};
+
+long perfEventOpen(perf_event_attr* attr, pid_t pid, int cpu, int groupFd, unsigned long flags) {
+    return syscall(__NR_perf_event_open, attr, pid, cpu, groupFd, flags);
+}
+
+} // namespace
+
+PerfCounterCollector::PerfCounterCollector()
+    : mode(PerfCounterMode::UNAVAILABLE),
+      rates{},
+      hasPreviousSample(false) {
+
+    int error = 0;
+    if (openGroups(true, error)) {
+        mode = PerfCounterMode::HARDWARE;
+        statusMessage = "Hardware and software counters active";
+    } else if (error != EACCES && error != EPERM && openGroups(false, error)) {
+        // No PMU (typical inside VMs): keep the software events only
+        mode = PerfCounterMode::SOFTWARE_ONLY;
+        statusMessage = "Hardware PMU events unavailable; showing software events only";
+    } else if (error == EACCES || error == EPERM) {
+        statusMessage = "System-wide counters need perf_event_paranoid <= 0 or CAP_PERFMON "
+                        "(current perf_event_paranoid: " + std::to_string(readParanoidLevel()) + ")";
+    } else {
+        statusMessage = std::string("perf_event_open failed: ") + std::strerror(error);
+    }
+
+    refresh();
+}
+
+PerfCounterCollector::~PerfCounterCollector() {
+    closeGroups();
+}
+
+PerfCounterMode PerfCounterCollector::getMode() const {
+    return mode;
+}
+
+std::string PerfCounterCollector::getStatusMessage() const {
+    return statusMessage;
+}
+
+int PerfCounterCollector::getMonitoredCpuCount() const {
+    return static_cast<int>(groups.size());
+}
+
+PerfCounterRates PerfCounterCollector::getRates() const {
+    return rates;
+}
+
+bool PerfCounterCollector::openGroups(bool hardware, int& error) {
+    closeGroups();
+
+    for (int cpu : getOnlineCpus()) {
+        CpuGroup group = {};
+        group.cpu = cpu;
+        if (!openGroup(group, hardware, error)) {
+            for (int fd : group.fds) {
+                close(fd);
+            }
+            closeGroups();
+            return false;
+        }
+        groups.push_back(group);
+    }
+
+    if (groups.empty()) {
+        error = ENODEV;
+        return false;
+    }
+    return true;
+}
+
+bool PerfCounterCollector::openGroup(CpuGroup& group, bool hardware, int& error) {
+    std::vector<EventSpec> events;
+    if (hardware) {
+        events.push_back({PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, COUNTER_LEADER});
+        events.push_back({PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, COUNTER_INSTRUCTIONS});
+        events.push_back({PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, COUNTER_CACHE_MISSES});
+        events.push_back({PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, COUNTER_BRANCH_MISSES});
+    } else {
+        events.push_back({PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK, COUNTER_LEADER});
+    }
+    events.push_back({PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, COUNTER_CONTEXT_SWITCHES});
+    events.push_back({PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, COUNTER_CPU_MIGRATIONS});
+    events.push_back({PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, COUNTER_PAGE_FAULTS});
+
+    for (const auto& event : events) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = event.type;
+        attr.config = event.config;
+        attr.read_format = PERF_FORMAT_GROUP |
+                           PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.disabled = group.fds.empty() ? 1 : 0;
+        attr.exclude_hv = 1;
+
+        int leaderFd = group.fds.empty() ? -1 : group.fds.front();
+        long fd = perfEventOpen(&attr, -1, group.cpu, leaderFd, PERF_FLAG_FD_CLOEXEC);
+        if (fd < 0) {
+            if (group.fds.empty()) {
+                // Without a leader there is no group for this CPU
+                error = errno;
+                return false;
+            }
+            // A missing member (e.g. no cache-miss event) only drops that metric
+            continue;
+        }
+
+        group.fds.push_back(static_cast<int>(fd));
+        group.counterSlots.push_back(event.slot);
+    }
+
+    ioctl(group.fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group.fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+void PerfCounterCollector::closeGroups() {
+    for (auto& group : groups) {
+        // Close members before the leader
+        for (auto it = group.fds.rbegin(); it != group.fds.rend(); ++it) {
+            close(*it);
+        }
+    }
+    groups.clear();
+    hasPreviousSample = false;
+}
+
+void PerfCounterCollector::refresh() {
+    if (groups.empty()) {
+        rates = PerfCounterRates{};
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double totals[COUNTER_COUNT] = {};
+
+    // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, values[nr]
+    uint64_t buffer[3 + COUNTER_COUNT];
+
+    for (auto& group : groups) {
+        ssize_t bytes = read(group.fds.front(), buffer, sizeof(buffer));
+        if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+            continue;
+        }
+
+        uint64_t count = buffer[0];
+        uint64_t timeEnabled = buffer[1];
+        uint64_t timeRunning = buffer[2];
+        if (count > group.counterSlots.size()) {
+            count = group.counterSlots.size();
+        }
+
+        if (group.hasPrevious) {
+            uint64_t enabledDelta = timeEnabled - group.lastTimeEnabled;
+            uint64_t runningDelta = timeRunning - group.lastTimeRunning;
+
+            // Scale for PMU multiplexing; a group that never ran contributes nothing
+            double scale = runningDelta > 0
+                ? static_cast<double>(enabledDelta) / runningDelta
+                : 0.0;
+
+            for (uint64_t i = 0; i < count; ++i) {
+                int slot = group.counterSlots[i];
+                uint64_t value = buffer[3 + i];
+                if (value >= group.lastValues[slot]) {
+                    totals[slot] += (value - group.lastValues[slot]) * scale;
+                }
+            }
+        }
+
+        for (uint64_t i = 0; i < count; ++i) {
+            group.lastValues[group.counterSlots[i]] = buffer[3 + i];
+        }
+        group.lastTimeEnabled = timeEnabled;
+        group.lastTimeRunning = timeRunning;
+        group.hasPrevious = true;
+    }
+
+    if (hasPreviousSample) {
+        double elapsed = std::chrono::duration<double>(now - lastSampleTime).count();
+        if (elapsed > 0.0) {
+            PerfCounterRates updated = {};
+            if (mode == PerfCounterMode::HARDWARE) {
+                updated.cyclesPerSec = totals[COUNTER_LEADER] / elapsed;
+                updated.instructionsPerSec = totals[COUNTER_INSTRUCTIONS] / elapsed;
+                updated.instructionsPerCycle = totals[COUNTER_LEADER] > 0
+                    ? totals[COUNTER_INSTRUCTIONS] / totals[COUNTER_LEADER]
+                    : 0.0;
+                updated.cacheMissesPerSec = totals[COUNTER_CACHE_MISSES] / elapsed;
+                updated.branchMissesPerSec = totals[COUNTER_BRANCH_MISSES] / elapsed;
+            }
+            updated.contextSwitchesPerSec = totals[COUNTER_CONTEXT_SWITCHES] / elapsed;
+            updated.cpuMigrationsPerSec = totals[COUNTER_CPU_MIGRATIONS] / elapsed;
+            updated.pageFaultsPerSec = totals[COUNTER_PAGE_FAULTS] / elapsed;
+            updated.valid = true;
+            rates = updated;
+        }
+    }
+
+    lastSampleTime = now;
+    hasPreviousSample = true;
+}
+
+std::vector<int> PerfCounterCollector::getOnlineCpus() const {
+    std::vector<int> cpus;
+
+    // Format: "0-3,5,7-8"
+    std::ifstream file("/sys/devices/system/cpu/online");
+    std::string content;
+    if (file.is_open() && std::getline(file, content)) {
+        std::istringstream stream(content);
+        std::string range;
+        while (std::getline(stream, range, ',')) {
+            try {
+                size_t dash = range.find('-');
+                int first = std::stoi(range.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            } catch (...) {
+                continue;
+            }
+        }
+    }
+
+    if (cpus.empty()) {
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < count; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+
+    return cpus;
+}
+
+int PerfCounterCollector::readParanoidLevel() const {
+    std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+    int level = 2;
+    if (file.is_open()) {
+        file >> level;
+    }
+    return level;
+}
+
+void PerfCounterCollector::printAllInfo() const {
+    std::cout << "Performance Counters:" << std::endl;
+    std::cout << "---------------------" << std::endl;
+    std::cout << "Status: " << statusMessage << std::endl;
+
+    if (mode == PerfCounterMode::UNAVAILABLE || !rates.valid) {
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    if (mode == PerfCounterMode::HARDWARE) {
+        std::cout << "IPC: " << rates.instructionsPerCycle << std::endl;
+        std::cout << "Instructions/s: " << rates.instructionsPerSec << std::endl;
+        std::cout << "Cycles/s: " << rates.cyclesPerSec << std::endl;
+        std::cout << "Cache misses/s: " << rates.cacheMissesPerSec << std::endl;
+        std::cout << "Branch misses/s: " << rates.branchMissesPerSec << std::endl;
+    }
+    std::cout << "Context switches/s: " << rates.contextSwitchesPerSec << std::endl;
+    std::cout << "CPU migrations/s: " << rates.cpuMigrationsPerSec << std::endl;
+    std::cout << "Page faults/s: " << rates.pageFaultsPerSec << std::endl;
+}
@@ -0,0 +1,166 @@
+#include "proc_events.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+namespace {
+
+const size_t RECEIVE_BUFFER_SIZE = 64 * 1024;
+const int SOCKET_BUFFER_SIZE = 4 * 1024 * 1024;
+
+} // namespace
+
+ProcEventListener::ProcEventListener()
+    : socketFd(-1),
+      forkCount(0),
+      execCount(0),
+      exitCount(0),
+      receiveBuffer(RECEIVE_BUFFER_SIZE) {
+
+    socketFd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (socketFd < 0) {
+        return;
+    }
+
+    // Fork storms can queue a lot of events between two ticks
+    int bufferSize = SOCKET_BUFFER_SIZE;
+    if (setsockopt(socketFd, SOL_SOCKET, SO_RCVBUFFORCE, &bufferSize, sizeof(bufferSize)) != 0) {
+        setsockopt(socketFd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+    }
+
+    sockaddr_nl address;
+    std::memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = CN_IDX_PROC;
+    address.nl_pid = 0;     // Let the kernel assign a port id
+
+    if (bind(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || !subscribe(true)) {
+        close();
+    }
+}
+
+ProcEventListener::~ProcEventListener() {
+    if (socketFd >= 0) {
+        subscribe(false);
+    }
+    close();
+}
+
+bool ProcEventListener::isActive() const {
+    return socketFd >= 0;
+}
+
+uint64_t ProcEventListener::getForkCount() const {
+    return forkCount;
+}
+
+uint64_t ProcEventListener::getExecCount() const {
+    return execCount;
+}
+
+uint64_t ProcEventListener::getExitCount() const {
+    return exitCount;
+}
+
+bool ProcEventListener::subscribe(bool enable) {
+    // nlmsghdr | cn_msg | proc_cn_mcast_op
+    char message[NLMSG_SPACE(sizeof(cn_msg) + sizeof(uint32_t))];
+    std::memset(message, 0, sizeof(message));
+
+    nlmsghdr* header = reinterpret_cast<nlmsghdr*>(message);
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(uint32_t));
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = 0;
+
+    cn_msg* connectorMessage = static_cast<cn_msg*>(NLMSG_DATA(header));
+    connectorMessage->id.idx = CN_IDX_PROC;
+    connectorMessage->id.val = CN_VAL_PROC;
+    connectorMessage->len = sizeof(uint32_t);
+
+    uint32_t operation = enable ? PROC_CN_MCAST_LISTEN : PROC_CN_MCAST_IGNORE;
+    std::memcpy(connectorMessage->data, &operation, sizeof(operation));
+
+    return send(socketFd, message, header->nlmsg_len, 0) >= 0;
+}
+
+bool ProcEventListener::drainEvents(std::vector<ProcEvent>& events) {
+    if (socketFd < 0) {
+        return false;
+    }
+
+    bool complete = true;
+
+    while (true) {
+        ssize_t length = recv(socketFd, receiveBuffer.data(), receiveBuffer.size(), 0);
+        if (length < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ENOBUFS) {
+                // The kernel dropped events; keep draining but report the gap
+                complete = false;
+                continue;
+            }
+            break;  // EAGAIN: queue is empty
+        }
+        if (length == 0) {
+            break;
+        }
+
+        nlmsghdr* header = reinterpret_cast<nlmsghdr*>(receiveBuffer.data());
+        int remaining = static_cast<int>(length);
+        for (; NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+            if (header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP) {
+                continue;
+            }
+
+            const cn_msg* connectorMessage = static_cast<const cn_msg*>(NLMSG_DATA(header));
+            if (connectorMessage->id.idx != CN_IDX_PROC || connectorMessage->id.val != CN_VAL_PROC) {
+                continue;
+            }
+
+            // The payload follows the 20-byte cn_msg header, so it is not
+            // aligned for proc_event's 64-bit timestamp; copy it out
+            proc_event eventData;
+            size_t payloadLength = std::min<size_t>(connectorMessage->len, sizeof(eventData));
+            std::memset(&eventData, 0, sizeof(eventData));
+            std::memcpy(&eventData, connectorMessage->data, payloadLength);
+            const proc_event* event = &eventData;
+            switch (event->what) {
+                case proc_event::PROC_EVENT_FORK:
+                    // Threads share the parent's tgid; only new processes count here
+                    if (event->event_data.fork.child_pid == event->event_data.fork.child_tgid) {
+                        forkCount++;
+                        events.push_back({ProcEventType::FORK, event->event_data.fork.child_tgid});
+                    }
+                    break;
+                case proc_event::PROC_EVENT_EXEC:
+                    execCount++;
+                    events.push_back({ProcEventType::EXEC, event->event_data.exec.process_tgid});
+                    break;
+                case proc_event::PROC_EVENT_EXIT:
+                    if (event->event_data.exit.process_pid == event->event_data.exit.process_tgid) {
+                        exitCount++;
+                        events.push_back({ProcEventType::EXIT, event->event_data.exit.process_tgid});
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    return complete;
+}
+
+void ProcEventListener::close() {
+    if (socketFd >= 0) {
+        ::close(socketFd);
+        socketFd = -1;
+    }
+}
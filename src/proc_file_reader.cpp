@@ -0,0 +1,363 @@
+#include "proc_file_reader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+namespace {
+
+// Submission queue depth; larger batches are processed in chunks of this size
+const unsigned RING_ENTRIES = 256;
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+} // namespace
+
+struct ProcFileReader::Ring {
+    int fd = -1;
+    unsigned entries = 0;
+
+    void* sqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    void* cqRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    unsigned localTail = 0;
+    std::vector<int> results;
+
+    io_uring_sqe* nextSqe(uint64_t userData) {
+        unsigned index = localTail & *sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->user_data = userData;
+        sqArray[index] = index;
+        localTail++;
+        return sqe;
+    }
+};
+
+ProcFileReader::ProcFileReader(Backend preferred)
+    : backend(Backend::SYNC),
+      ring(nullptr) {
+
+    if (preferred == Backend::IO_URING && setupRing()) {
+        backend = Backend::IO_URING;
+    }
+}
+
+ProcFileReader::~ProcFileReader() {
+    destroyRing();
+}
+
+ProcFileReader::Backend ProcFileReader::getBackend() const {
+    return backend;
+}
+
+bool ProcFileReader::setupRing() {
+    ring = new Ring();
+
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = RING_ENTRIES * 2;
+
+    ring->fd = ioUringSetup(RING_ENTRIES, &params);
+    if (ring->fd < 0) {
+        // ENOSYS (old kernel), EPERM (io_uring_disabled sysctl, seccomp) ...
+        destroyRing();
+        return false;
+    }
+    ring->entries = params.sq_entries;
+
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap && ring->cqRingSize > ring->sqRingSize) {
+        ring->sqRingSize = ring->cqRingSize;
+    }
+
+    ring->sqRing = mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sqRing == MAP_FAILED) {
+        destroyRing();
+        return false;
+    }
+
+    if (singleMmap) {
+        ring->cqRing = ring->sqRing;
+    } else {
+        ring->cqRing = mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cqRing == MAP_FAILED) {
+            destroyRing();
+            return false;
+        }
+    }
+
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        destroyRing();
+        return false;
+    }
+    ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(ring->sqRing);
+    char* cq = static_cast<char*>(ring->cqRing);
+    ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    ring->localTail = *ring->sqTail;
+
+    // OPENAT, READ and CLOSE all appeared in 5.6; probe rather than guess
+    size_t probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    io_uring_probe* probe = static_cast<io_uring_probe*>(calloc(1, probeSize));
+    bool supported = probe != nullptr &&
+                     ioUringRegister(ring->fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+    if (supported) {
+        for (unsigned op : {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE}) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+                supported = false;
+            }
+        }
+    }
+    free(probe);
+
+    if (!supported) {
+        destroyRing();
+        return false;
+    }
+
+    ring->results.resize(ring->entries);
+    openFds.resize(ring->entries);
+    return true;
+}
+
+void ProcFileReader::destroyRing() {
+    if (!ring) {
+        return;
+    }
+
+    if (ring->sqes) {
+        munmap(ring->sqes, ring->sqesSize);
+    }
+    if (ring->cqRing != MAP_FAILED && ring->cqRing != ring->sqRing) {
+        munmap(ring->cqRing, ring->cqRingSize);
+    }
+    if (ring->sqRing != MAP_FAILED) {
+        munmap(ring->sqRing, ring->sqRingSize);
+    }
+    if (ring->fd >= 0) {
+        close(ring->fd);
+    }
+
+    delete ring;
+    ring = nullptr;
+}
+
+void ProcFileReader::readAll(std::vector<ProcReadRequest>& requests) {
+    if (backend == Backend::IO_URING) {
+        readAllUring(requests);
+    } else {
+        readAllSync(requests);
+    }
+}
+
+void ProcFileReader::readAllSync(std::vector<ProcReadRequest>& requests) {
+    for (auto& request : requests) {
+        request.length = -ENOENT;
+        if (request.capacity == 0) {
+            continue;
+        }
+
+        int fd = openat(request.dirFd, request.name, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            request.length = -errno;
+            continue;
+        }
+
+        ssize_t total = 0;
+        while (static_cast<size_t>(total) < request.capacity - 1) {
+            ssize_t n = read(fd, request.buffer + total, request.capacity - 1 - total);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            total += n;
+        }
+
+        close(fd);
+        request.buffer[total] = '\0';
+        request.length = total;
+    }
+}
+
+void ProcFileReader::readAllUring(std::vector<ProcReadRequest>& requests) {
+    size_t chunkSize = ring->entries;
+    for (size_t offset = 0; offset < requests.size(); offset += chunkSize) {
+        size_t count = std::min(chunkSize, requests.size() - offset);
+        if (backend == Backend::IO_URING) {
+            readChunkUring(requests.data() + offset, count);
+        } else {
+            std::vector<ProcReadRequest> rest(requests.begin() + offset, requests.end());
+            readAllSync(rest);
+            std::copy(rest.begin(), rest.end(), requests.begin() + offset);
+            return;
+        }
+    }
+}
+
+void ProcFileReader::readChunkUring(ProcReadRequest* requests, size_t count) {
+    // Phase 1: open every file of the chunk
+    for (size_t i = 0; i < count; ++i) {
+        openFds[i] = -1;
+        io_uring_sqe* sqe = ring->nextSqe(i);
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = requests[i].dirFd;
+        sqe->addr = reinterpret_cast<uint64_t>(requests[i].name);
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    }
+    if (submitAndWait(count) < 0) {
+        failChunk(requests, count);
+        return;
+    }
+
+    unsigned reads = 0;
+    for (size_t i = 0; i < count; ++i) {
+        openFds[i] = ring->results[i];
+        requests[i].length = openFds[i] < 0 ? openFds[i] : -EIO;
+        if (openFds[i] < 0 || requests[i].capacity == 0) {
+            continue;
+        }
+
+        // Phase 2: read each opened file from offset 0
+        io_uring_sqe* sqe = ring->nextSqe(i);
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = openFds[i];
+        sqe->addr = reinterpret_cast<uint64_t>(requests[i].buffer);
+        sqe->len = static_cast<unsigned>(requests[i].capacity - 1);
+        sqe->off = 0;
+        reads++;
+    }
+
+    if (reads > 0) {
+        if (submitAndWait(reads) < 0) {
+            failChunk(requests, count);
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (openFds[i] < 0 || requests[i].capacity == 0) {
+                continue;
+            }
+            int result = ring->results[i];
+            requests[i].length = result;
+            if (result >= 0) {
+                requests[i].buffer[result] = '\0';
+            }
+        }
+    }
+
+    // Phase 3: close everything that was opened
+    unsigned closes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (openFds[i] < 0) {
+            continue;
+        }
+        io_uring_sqe* sqe = ring->nextSqe(i);
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = openFds[i];
+        closes++;
+    }
+
+    if (closes > 0 && submitAndWait(closes) < 0) {
+        // Some of the closes may have run without their completion being
+        // reaped, and their fd numbers may already belong to another thread.
+        // Closing again could hit someone else's file, so leak the rest
+        std::fill(openFds.begin(), openFds.begin() + count, -1);
+        failChunk(requests, count);
+    }
+}
+
+void ProcFileReader::failChunk(ProcReadRequest* requests, size_t count) {
+    // The ring is in an unknown state after a failed io_uring_enter();
+    // tearing it down cancels whatever was still queued. Stay on the
+    // synchronous backend from here on and redo the chunk.
+    destroyRing();
+    backend = Backend::SYNC;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (openFds[i] >= 0) {
+            close(openFds[i]);
+        }
+    }
+
+    std::vector<ProcReadRequest> retry(requests, requests + count);
+    readAllSync(retry);
+    std::copy(retry.begin(), retry.end(), requests);
+}
+
+int ProcFileReader::submitAndWait(unsigned count) {
+    // Publish the queued entries to the kernel
+    __atomic_store_n(ring->sqTail, ring->localTail, __ATOMIC_RELEASE);
+
+    unsigned submitted = 0;
+    unsigned reaped = 0;
+    while (reaped < count) {
+        unsigned toSubmit = count - submitted;
+        int ret = ioUringEnter(ring->fd, toSubmit, toSubmit > 0 ? count - reaped : 1,
+                               IORING_ENTER_GETEVENTS);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        submitted += static_cast<unsigned>(ret);
+
+        unsigned head = *ring->cqHead;
+        unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = ring->cqes[head & *ring->cqMask];
+            if (cqe.user_data < ring->results.size()) {
+                ring->results[cqe.user_data] = cqe.res;
+            }
+            head++;
+            reaped++;
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    return static_cast<int>(reaped);
+}
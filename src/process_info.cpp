@@ -0,0 +1,490 @@
+#include "process_info.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <unordered_map>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace {
+
+// Layout returned by getdents64(2)
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+const size_t DIRENT_BUFFER_SIZE = 64 * 1024;
+
+// PIDs whose files are read in one ProcFileReader batch
+const size_t READ_BATCH_SIZE = 1024;
+const size_t STAT_BUFFER_SIZE = 1024;
+const size_t STATM_BUFFER_SIZE = 256;
+const size_t STATUS_BUFFER_SIZE = 4096;
+
+// Room for "<pid>/status" plus the terminator
+const size_t PATH_SLOT_SIZE = 32;
+const char* const PROCESS_FILES[] = {"stat", "statm", "status"};
+const int FILE_KINDS = 3;
+
+// Event-driven ticks between consistency rescans of /proc
+const int FULL_RESCAN_INTERVAL = 30;
+
+// Parse the next decimal field (negative values read as 0) and advance past it
+uint64_t nextNumber(const char*& cursor, const char* end) {
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t')) {
+        ++cursor;
+    }
+    bool negative = cursor < end && *cursor == '-';
+    if (negative) {
+        ++cursor;
+    }
+    uint64_t value = 0;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+        value = value * 10 + (*cursor - '0');
+        ++cursor;
+    }
+    return negative ? 0 : value;
+}
+
+void skipFields(const char*& cursor, const char* end, int count) {
+    for (int i = 0; i < count; ++i) {
+        while (cursor < end && *cursor == ' ') {
+            ++cursor;
+        }
+        while (cursor < end && *cursor != ' ') {
+            ++cursor;
+        }
+    }
+}
+
+} // namespace
+
+ProcessInfoCollector::ProcessInfoCollector(ProcFileReader::Backend readBackend)
+    : procFd(-1),
+      direntBuffer(DIRENT_BUFFER_SIZE),
+      fileReader(readBackend),
+      pathArena(READ_BATCH_SIZE * FILE_KINDS * PATH_SLOT_SIZE),
+      statBuffers(READ_BATCH_SIZE * STAT_BUFFER_SIZE),
+      statmBuffers(READ_BATCH_SIZE * STATM_BUFFER_SIZE),
+      hasPreviousScan(false),
+      lastScanDurationMs(0.0),
+      ticksSinceFullScan(0),
+      lastForkCount(0),
+      lastExecCount(0),
+      lastExitCount(0),
+      forkRate(0.0),
+      execRate(0.0),
+      exitRate(0.0) {
+
+    ticksPerSecond = sysconf(_SC_CLK_TCK);
+    if (ticksPerSecond <= 0) {
+        ticksPerSecond = 100;
+    }
+    pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize <= 0) {
+        pageSize = 4096;
+    }
+
+    procFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    refresh();
+}
+
+ProcessInfoCollector::~ProcessInfoCollector() {
+    if (procFd >= 0) {
+        close(procFd);
+    }
+}
+
+const std::vector<ProcessInfo>& ProcessInfoCollector::getProcesses() const {
+    return processes;
+}
+
+double ProcessInfoCollector::getLastScanDurationMs() const {
+    return lastScanDurationMs;
+}
+
+bool ProcessInfoCollector::usesIoUring() const {
+    return fileReader.getBackend() == ProcFileReader::Backend::IO_URING;
+}
+
+void ProcessInfoCollector::refresh() {
+    if (procFd < 0) {
+        return;
+    }
+
+    auto scanStart = std::chrono::steady_clock::now();
+
+    // Keep the last snapshot for CPU deltas; its storage is reused next time
+    previousProcesses.swap(processes);
+    processes.clear();
+    processes.reserve(previousProcesses.size() + 64);
+
+    double elapsedTicks = 0.0;
+    if (hasPreviousScan) {
+        elapsedTicks = std::chrono::duration<double>(scanStart - lastScanTime).count() * ticksPerSecond;
+    }
+
+    // With the proc connector the PID set is maintained from fork/exit
+    // events; /proc is only rescanned periodically as a consistency check
+    // or when the event socket overflowed
+    bool fullScan = true;
+    if (procEvents.isActive()) {
+        pendingEvents.clear();
+        bool complete = procEvents.drainEvents(pendingEvents);
+        if (complete && hasPreviousScan && ticksSinceFullScan < FULL_RESCAN_INTERVAL) {
+            applyEvents();
+            fullScan = false;
+        }
+    }
+
+    if (fullScan) {
+        scanPidList();
+        ticksSinceFullScan = 0;
+    } else {
+        ticksSinceFullScan++;
+    }
+
+    size_t previousCursor = 0;
+    size_t liveCount = 0;
+
+    for (size_t first = 0; first < livePids.size(); first += READ_BATCH_SIZE) {
+        size_t count = std::min(READ_BATCH_SIZE, livePids.size() - first);
+        readBatch(first, count, elapsedTicks, previousCursor);
+
+        for (auto& info : batch) {
+            if (info.pid < 0) {
+                continue;   // Exited since it was listed
+            }
+            livePids[liveCount++] = info.pid;
+            processes.push_back(std::move(info));
+        }
+    }
+    livePids.resize(liveCount);
+
+    updateEventRates(scanStart);
+
+    lastScanTime = scanStart;
+    hasPreviousScan = true;
+    lastScanDurationMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - scanStart).count();
+}
+
+void ProcessInfoCollector::scanPidList() {
+    livePids.clear();
+
+    // Walk /proc with getdents64 on the directory fd we keep open
+    lseek(procFd, 0, SEEK_SET);
+
+    while (true) {
+        long bytes = syscall(SYS_getdents64, procFd, direntBuffer.data(), direntBuffer.size());
+        if (bytes <= 0) {
+            break;
+        }
+
+        long offset = 0;
+        while (offset < bytes) {
+            const LinuxDirent64* entry = reinterpret_cast<const LinuxDirent64*>(direntBuffer.data() + offset);
+            offset += entry->d_reclen;
+
+            const char* name = entry->d_name;
+            if (name[0] < '1' || name[0] > '9') {
+                continue;
+            }
+
+            int pid = 0;
+            const char* p = name;
+            while (*p >= '0' && *p <= '9') {
+                pid = pid * 10 + (*p - '0');
+                ++p;
+            }
+            if (*p == '\0') {
+                livePids.push_back(pid);
+            }
+        }
+    }
+
+    // /proc lists PIDs in ascending order, but do not rely on it
+    if (!std::is_sorted(livePids.begin(), livePids.end())) {
+        std::sort(livePids.begin(), livePids.end());
+    }
+}
+
+void ProcessInfoCollector::applyEvents() {
+    if (pendingEvents.empty()) {
+        return;
+    }
+
+    // Only the last event per PID counts (fork+exit of a short-lived child
+    // cancels out, exit+fork of a reused PID keeps it)
+    std::unordered_map<int, bool> alive;
+    for (const auto& event : pendingEvents) {
+        if (event.type == ProcEventType::FORK) {
+            alive[event.pid] = true;
+        } else if (event.type == ProcEventType::EXIT) {
+            alive[event.pid] = false;
+        }
+    }
+
+    size_t keep = 0;
+    for (size_t i = 0; i < livePids.size(); ++i) {
+        auto it = alive.find(livePids[i]);
+        if (it != alive.end()) {
+            if (!it->second) {
+                continue;
+            }
+            alive.erase(it);    // Already listed
+        }
+        livePids[keep++] = livePids[i];
+    }
+    livePids.resize(keep);
+
+    for (const auto& [pid, isAlive] : alive) {
+        if (isAlive) {
+            livePids.push_back(pid);
+        }
+    }
+    std::sort(livePids.begin(), livePids.end());
+}
+
+void ProcessInfoCollector::updateEventRates(std::chrono::steady_clock::time_point now) {
+    if (!procEvents.isActive()) {
+        return;
+    }
+
+    uint64_t forks = procEvents.getForkCount();
+    uint64_t execs = procEvents.getExecCount();
+    uint64_t exits = procEvents.getExitCount();
+
+    if (hasPreviousScan) {
+        double elapsed = std::chrono::duration<double>(now - lastScanTime).count();
+        if (elapsed > 0.0) {
+            forkRate = (forks - lastForkCount) / elapsed;
+            execRate = (execs - lastExecCount) / elapsed;
+            exitRate = (exits - lastExitCount) / elapsed;
+        }
+    }
+
+    lastForkCount = forks;
+    lastExecCount = execs;
+    lastExitCount = exits;
+}
+
+bool ProcessInfoCollector::isEventDriven() const {
+    return procEvents.isActive();
+}
+
+double ProcessInfoCollector::getForkRate() const {
+    return forkRate;
+}
+
+double ProcessInfoCollector::getExecRate() const {
+    return execRate;
+}
+
+double ProcessInfoCollector::getExitRate() const {
+    return exitRate;
+}
+
+const ProcessInfo* ProcessInfoCollector::findPrevious(int pid, size_t& cursor) const {
+    // Both scans are in PID order, so a forward-moving cursor finds matches
+    // without hashing; fall back to binary search if the order ever differs
+    while (cursor < previousProcesses.size() && previousProcesses[cursor].pid < pid) {
+        ++cursor;
+    }
+    if (cursor < previousProcesses.size() && previousProcesses[cursor].pid == pid) {
+        return &previousProcesses[cursor];
+    }
+
+    auto it = std::lower_bound(previousProcesses.begin(), previousProcesses.end(), pid,
+                               [](const ProcessInfo& info, int value) { return info.pid < value; });
+    if (it != previousProcesses.end() && it->pid == pid) {
+        return &*it;
+    }
+    return nullptr;
+}
+
+void ProcessInfoCollector::readBatch(size_t first, size_t count, double elapsedTicks, size_t& previousCursor) {
+    // stat and statm of every PID in the batch go out as one request list
+    requests.clear();
+    for (size_t i = 0; i < count; ++i) {
+        int pid = livePids[first + i];
+        requests.push_back({procFd, pathFor(i, 0, pid), &statBuffers[i * STAT_BUFFER_SIZE], STAT_BUFFER_SIZE, 0});
+        requests.push_back({procFd, pathFor(i, 1, pid), &statmBuffers[i * STATM_BUFFER_SIZE], STATM_BUFFER_SIZE, 0});
+    }
+    fileReader.readAll(requests);
+
+    batch.resize(count);
+    statusIndex.clear();
+
+    for (size_t i = 0; i < count; ++i) {
+        ProcessInfo& info = batch[i];
+        info.pid = livePids[first + i];
+        info.cpuPercent = 0.0;
+        info.uid = 0;
+
+        if (!parseStat(&statBuffers[i * STAT_BUFFER_SIZE], requests[2 * i].length, info)) {
+            info.pid = -1;
+            continue;
+        }
+        parseStatm(&statmBuffers[i * STATM_BUFFER_SIZE], requests[2 * i + 1].length, info);
+
+        // A reused PID is a new process; its ticks are not a delta of the old one's
+        const ProcessInfo* previous = findPrevious(info.pid, previousCursor);
+        if (previous && previous->startTime != info.startTime) {
+            previous = nullptr;
+        }
+        if (previous && elapsedTicks > 0.0 && info.cpuTicks >= previous->cpuTicks) {
+            info.cpuPercent = (info.cpuTicks - previous->cpuTicks) * 100.0 / elapsedTicks;
+        }
+
+        // status is the most expensive of the three; owner only changes on
+        // setuid, so read it for new processes (or reused PIDs) only
+        if (previous) {
+            info.uid = previous->uid;
+        } else {
+            statusIndex.push_back(i);
+        }
+    }
+
+    if (statusIndex.empty()) {
+        return;
+    }
+
+    if (statusBuffers.size() < statusIndex.size() * STATUS_BUFFER_SIZE) {
+        statusBuffers.resize(statusIndex.size() * STATUS_BUFFER_SIZE);
+    }
+
+    requests.clear();
+    for (size_t k = 0; k < statusIndex.size(); ++k) {
+        size_t i = statusIndex[k];
+        requests.push_back({procFd, pathFor(i, 2, batch[i].pid), &statusBuffers[k * STATUS_BUFFER_SIZE],
+                            STATUS_BUFFER_SIZE, 0});
+    }
+    fileReader.readAll(requests);
+
+    for (size_t k = 0; k < statusIndex.size(); ++k) {
+        parseStatusUid(&statusBuffers[k * STATUS_BUFFER_SIZE], requests[k].length, batch[statusIndex[k]]);
+    }
+}
+
+const char* ProcessInfoCollector::pathFor(size_t slot, int kind, int pid) {
+    char* path = &pathArena[(slot * FILE_KINDS + kind) * PATH_SLOT_SIZE];
+    snprintf(path, PATH_SLOT_SIZE, "%d/%s", pid, PROCESS_FILES[kind]);
+    return path;
+}
+
+bool ProcessInfoCollector::parseStat(const char* data, ssize_t length, ProcessInfo& info) {
+    if (length <= 0) {
+        return false;
+    }
+
+    const char* begin = data;
+    const char* end = begin + length;
+
+    // comm may contain spaces and parentheses; it ends at the last ')'
+    const char* openParen = static_cast<const char*>(memchr(begin, '(', length));
+    const char* closeParen = nullptr;
+    for (const char* p = end - 1; p > begin; --p) {
+        if (*p == ')') {
+            closeParen = p;
+            break;
+        }
+    }
+    if (!openParen || !closeParen || closeParen < openParen || closeParen + 2 >= end) {
+        return false;
+    }
+
+    info.name.assign(openParen + 1, closeParen - openParen - 1);
+
+    const char* cursor = closeParen + 2;
+    info.state = *cursor++;                        // 3 state
+    info.ppid = static_cast<int>(nextNumber(cursor, end)); // 4 ppid
+    skipFields(cursor, end, 5);                    // 5-9
+    info.minorFaults = nextNumber(cursor, end);    // 10 minflt
+    skipFields(cursor, end, 1);                    // 11 cminflt
+    info.majorFaults = nextNumber(cursor, end);    // 12 majflt
+    skipFields(cursor, end, 1);                    // 13 cmajflt
+    uint64_t utime = nextNumber(cursor, end);      // 14 utime
+    uint64_t stime = nextNumber(cursor, end);      // 15 stime
+    skipFields(cursor, end, 4);                    // 16-19
+    info.numThreads = static_cast<int>(nextNumber(cursor, end)); // 20 num_threads
+    skipFields(cursor, end, 1);                    // 21 itrealvalue
+    info.startTime = nextNumber(cursor, end);      // 22 starttime
+    info.virtualBytes = nextNumber(cursor, end);   // 23 vsize
+    skipFields(cursor, end, 18);                   // 24-41
+    info.blkioDelayTicks = nextNumber(cursor, end); // 42 delayacct_blkio_ticks
+    info.cpuTicks = utime + stime;
+
+    return true;
+}
+
+bool ProcessInfoCollector::parseStatm(const char* data, ssize_t length, ProcessInfo& info) {
+    info.rssBytes = 0;
+    info.sharedBytes = 0;
+    if (length <= 0) {
+        return false;
+    }
+
+    // size resident shared text lib data dt (in pages)
+    const char* cursor = data;
+    const char* end = cursor + length;
+    nextNumber(cursor, end);
+    info.rssBytes = nextNumber(cursor, end) * pageSize;
+    info.sharedBytes = nextNumber(cursor, end) * pageSize;
+    return true;
+}
+
+bool ProcessInfoCollector::parseStatusUid(const char* data, ssize_t length, ProcessInfo& info) {
+    if (length <= 0) {
+        return false;
+    }
+
+    const char* line = strstr(data, "\nUid:");
+    if (!line) {
+        return false;
+    }
+
+    const char* cursor = line + 5;
+    info.uid = static_cast<uid_t>(nextNumber(cursor, data + length));
+    return true;
+}
+
+void ProcessInfoCollector::printAllInfo() const {
+    std::cout << "Process Information:" << std::endl;
+    std::cout << "--------------------" << std::endl;
+    std::cout << "Processes: " << processes.size()
+              << " (scan " << std::fixed << std::setprecision(2) << lastScanDurationMs << " ms, "
+              << (usesIoUring() ? "io_uring" : "sync") << " reads)" << std::endl;
+    if (procEvents.isActive()) {
+        std::cout << "Forks/s: " << forkRate << ", Execs/s: " << execRate
+                  << ", Exits/s: " << exitRate << std::endl;
+    }
+
+    // Top 10 by resident memory
+    std::vector<const ProcessInfo*> sorted;
+    sorted.reserve(processes.size());
+    for (const auto& process : processes) {
+        sorted.push_back(&process);
+    }
+    size_t count = std::min<size_t>(10, sorted.size());
+    std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end(),
+                      [](const ProcessInfo* a, const ProcessInfo* b) { return a->rssBytes > b->rssBytes; });
+
+    for (size_t i = 0; i < count; ++i) {
+        const ProcessInfo* process = sorted[i];
+        std::cout << std::setw(8) << process->pid << "  "
+                  << std::setw(16) << std::left << process->name << std::right
+                  << std::setw(8) << std::setprecision(1) << process->cpuPercent << "%  "
+                  << (process->rssBytes / 1024) << " KB" << std::endl;
+    }
+}
@@ -0,0 +1,266 @@
+#include "process_io.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t IO_BUFFER_SIZE = 256;
+
+// Room for "<pid>/io" plus the terminator
+const size_t PATH_SLOT_SIZE = 24;
+
+// Keys of /proc/<pid>/io in the order of the counters array; none is on
+// the first line, and the newline keeps cancelled_write_bytes from matching
+const char* const IO_KEYS[] = {"\nread_bytes: ", "\nwrite_bytes: ", "\nsyscr: ", "\nsyscw: "};
+
+// Weights of the stat deltas when ranking candidates: time blocked on
+// block I/O is the strongest hint, then major faults (which are reads),
+// then CPU time, which every write() burns
+const double BLKIO_WEIGHT = 1e6;
+const double MAJOR_FAULT_WEIGHT = 1e3;
+const double CPU_WEIGHT = 1.0;
+
+// Processes that did I/O on their last read stay ahead of every stat hint
+const double IO_ACTIVE_BOOST = 1e12;
+
+double deltaOf(uint64_t current, uint64_t previous) {
+    return current >= previous ? static_cast<double>(current - previous) : 0.0;
+}
+
+} // namespace
+
+ProcessIoCollector::ProcessIoCollector(size_t topK, size_t sweepBudget)
+    : topK(topK),
+      sweepBudget(sweepBudget),
+      procFd(-1),
+      fileReader(ProcFileReader::Backend::SYNC),
+      pathArena((topK + sweepBudget) * PATH_SLOT_SIZE),
+      ioBuffers((topK + sweepBudget) * IO_BUFFER_SIZE),
+      hasPreviousUpdate(false),
+      generation(0),
+      sweepPid(0),
+      lastUpdateDurationMs(0.0) {
+
+    procFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+ProcessIoCollector::~ProcessIoCollector() {
+    if (procFd >= 0) {
+        close(procFd);
+    }
+}
+
+const std::vector<ProcessIoInfo>& ProcessIoCollector::getActiveProcesses() const {
+    return active;
+}
+
+size_t ProcessIoCollector::getLastIoReadCount() const {
+    return selected.size();
+}
+
+size_t ProcessIoCollector::getProcessCount() const {
+    return entries.size();
+}
+
+double ProcessIoCollector::getLastUpdateDurationMs() const {
+    return lastUpdateDurationMs;
+}
+
+void ProcessIoCollector::update(const std::vector<ProcessInfo>& processes) {
+    if (procFd < 0) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = hasPreviousUpdate ? std::chrono::duration<double>(now - lastUpdateTime).count() : 0.0;
+    generation++;
+
+    // Keep the last entries for deltas; their storage is reused next time
+    previousEntries.swap(entries);
+    entries.clear();
+    entries.reserve(processes.size());
+
+    size_t cursor = 0;
+    for (const auto& info : processes) {
+        Entry entry{};
+        entry.pid = info.pid;
+        entry.startTime = info.startTime;
+        entry.cpuTicks = info.cpuTicks;
+        entry.minorFaults = info.minorFaults;
+        entry.majorFaults = info.majorFaults;
+        entry.blkioDelayTicks = info.blkioDelayTicks;
+
+        // Both lists are in PID order, so a forward-moving cursor finds matches
+        while (cursor < previousEntries.size() && previousEntries[cursor].pid < info.pid) {
+            ++cursor;
+        }
+        const Entry* previous = nullptr;
+        if (cursor < previousEntries.size() && previousEntries[cursor].pid == info.pid &&
+            previousEntries[cursor].startTime == info.startTime) {
+            previous = &previousEntries[cursor];
+        }
+
+        if (previous) {
+            entry.hasIo = previous->hasIo;
+            entry.ioDenied = previous->ioDenied;
+            entry.ioActive = previous->ioActive;
+            entry.readBytes = previous->readBytes;
+            entry.writeBytes = previous->writeBytes;
+            entry.readCalls = previous->readCalls;
+            entry.writeCalls = previous->writeCalls;
+            entry.ioTime = previous->ioTime;
+        } else if (hasPreviousUpdate) {
+            // Started since the last update: everything it did so far is
+            // the delta, and its I/O counters started from zero
+            entry.hasIo = true;
+            entry.ioTime = lastUpdateTime;
+        }
+
+        if (hasPreviousUpdate && elapsed > 0.0) {
+            double minorDelta = deltaOf(info.minorFaults, previous ? previous->minorFaults : 0);
+            double majorDelta = deltaOf(info.majorFaults, previous ? previous->majorFaults : 0);
+            double blkioDelta = deltaOf(info.blkioDelayTicks, previous ? previous->blkioDelayTicks : 0);
+            double cpuDelta = deltaOf(info.cpuTicks, previous ? previous->cpuTicks : 0);
+
+            entry.minorFaultsPerSec = minorDelta / elapsed;
+            entry.majorFaultsPerSec = majorDelta / elapsed;
+            entry.score = blkioDelta * BLKIO_WEIGHT + majorDelta * MAJOR_FAULT_WEIGHT + cpuDelta * CPU_WEIGHT;
+        }
+        if (entry.ioActive) {
+            entry.score += IO_ACTIVE_BOOST;
+        }
+
+        entries.push_back(entry);
+    }
+
+    selectCandidates();
+    readIo(now);
+
+    // Report everything that moved, busiest first
+    active.clear();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry& entry = entries[i];
+        if (entry.readBytesPerSec <= 0.0 && entry.writeBytesPerSec <= 0.0 &&
+            entry.readCallsPerSec <= 0.0 && entry.writeCallsPerSec <= 0.0 &&
+            entry.majorFaultsPerSec <= 0.0 && entry.minorFaultsPerSec <= 0.0) {
+            continue;
+        }
+        active.push_back({entry.pid, processes[i].name, entry.ioSampled,
+                          entry.readBytesPerSec, entry.writeBytesPerSec,
+                          entry.readCallsPerSec, entry.writeCallsPerSec,
+                          entry.majorFaultsPerSec, entry.minorFaultsPerSec});
+    }
+    std::sort(active.begin(), active.end(), [](const ProcessIoInfo& a, const ProcessIoInfo& b) {
+        double left = a.readBytesPerSec + a.writeBytesPerSec;
+        double right = b.readBytesPerSec + b.writeBytesPerSec;
+        if (left != right) return left > right;
+        if (a.majorFaultsPerSec != b.majorFaultsPerSec) return a.majorFaultsPerSec > b.majorFaultsPerSec;
+        return a.minorFaultsPerSec > b.minorFaultsPerSec;
+    });
+
+    lastUpdateTime = now;
+    hasPreviousUpdate = true;
+    lastUpdateDurationMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - now).count();
+}
+
+void ProcessIoCollector::selectCandidates() {
+    selected.clear();
+
+    // First pass: the top K by stat activity
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].score > 0.0 && !entries[i].ioDenied) {
+            selected.push_back(i);
+        }
+    }
+    if (selected.size() > topK) {
+        std::nth_element(selected.begin(), selected.begin() + topK, selected.end(),
+                         [this](size_t a, size_t b) { return entries[a].score > entries[b].score; });
+        selected.resize(topK);
+    }
+    for (size_t i : selected) {
+        entries[i].selectedGeneration = generation;
+    }
+
+    // Second pass: a bounded slice of the rest, resuming where the last
+    // update stopped, so every process is read once per full rotation
+    if (entries.empty() || sweepBudget == 0) {
+        return;
+    }
+
+    size_t start = std::lower_bound(entries.begin(), entries.end(), sweepPid,
+                                    [](const Entry& entry, int pid) { return entry.pid < pid; }) - entries.begin();
+    size_t swept = 0;
+    for (size_t step = 0; step < entries.size() && swept < sweepBudget; ++step) {
+        size_t i = (start + step) % entries.size();
+        Entry& entry = entries[i];
+        if (entry.ioDenied || entry.selectedGeneration == generation) {
+            continue;
+        }
+        entry.selectedGeneration = generation;
+        selected.push_back(i);
+        sweepPid = entry.pid + 1;
+        swept++;
+    }
+}
+
+void ProcessIoCollector::readIo(std::chrono::steady_clock::time_point now) {
+    requests.clear();
+    for (size_t k = 0; k < selected.size(); ++k) {
+        char* path = &pathArena[k * PATH_SLOT_SIZE];
+        snprintf(path, PATH_SLOT_SIZE, "%d/io", entries[selected[k]].pid);
+        requests.push_back({procFd, path, &ioBuffers[k * IO_BUFFER_SIZE], IO_BUFFER_SIZE, 0});
+    }
+    fileReader.readAll(requests);
+
+    for (size_t k = 0; k < selected.size(); ++k) {
+        Entry& entry = entries[selected[k]];
+        ssize_t length = requests[k].length;
+        if (length == -EACCES || length == -EPERM) {
+            entry.ioDenied = true;
+            continue;
+        }
+
+        uint64_t counters[4];
+        if (!parseIo(&ioBuffers[k * IO_BUFFER_SIZE], length, counters)) {
+            continue;   // Exited since the snapshot
+        }
+
+        double elapsed = std::chrono::duration<double>(now - entry.ioTime).count();
+        if (entry.hasIo && elapsed > 0.0) {
+            entry.readBytesPerSec = deltaOf(counters[0], entry.readBytes) / elapsed;
+            entry.writeBytesPerSec = deltaOf(counters[1], entry.writeBytes) / elapsed;
+            entry.readCallsPerSec = deltaOf(counters[2], entry.readCalls) / elapsed;
+            entry.writeCallsPerSec = deltaOf(counters[3], entry.writeCalls) / elapsed;
+        }
+
+        entry.ioActive = entry.readBytesPerSec > 0.0 || entry.writeBytesPerSec > 0.0;
+        entry.ioSampled = true;
+        entry.hasIo = true;
+        entry.readBytes = counters[0];
+        entry.writeBytes = counters[1];
+        entry.readCalls = counters[2];
+        entry.writeCalls = counters[3];
+        entry.ioTime = now;
+    }
+}
+
+bool ProcessIoCollector::parseIo(const char* data, ssize_t length, uint64_t counters[4]) const {
+    if (length <= 0) {
+        return false;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        const char* line = strstr(data, IO_KEYS[i]);
+        if (!line) {
+            return false;
+        }
+        counters[i] = strtoull(line + strlen(IO_KEYS[i]), nullptr, 10);
+    }
+    return true;
+}
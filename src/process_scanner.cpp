@@ -0,0 +1,109 @@
+#include "process_scanner.h"
+#include "sample_clock.h"
+#include <algorithm>
+#include <chrono>
+
+ProcessScanner::ProcessScanner(ProcFileReader::Backend readBackend, QObject *parent)
+    : QObject(parent),
+      readBackend(readBackend),
+      lastScanStartNs(0),
+      scanRequested(false),
+      stopping(false) {
+    thread = std::thread(&ProcessScanner::run, this);
+}
+
+ProcessScanner::~ProcessScanner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+
+    // A scan in progress is finished first, about a second at worst
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void ProcessScanner::addClient(const void *client, int intervalMs) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        clientIntervalsNs[client] = std::max(intervalMs, 1) * 1000000LL;
+    }
+    wakeup.notify_all();
+}
+
+void ProcessScanner::removeClient(const void *client) {
+    std::lock_guard<std::mutex> lock(mutex);
+    clientIntervalsNs.erase(client);
+}
+
+void ProcessScanner::requestScan() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        scanRequested = true;
+    }
+    wakeup.notify_all();
+}
+
+std::shared_ptr<const ProcessSnapshot> ProcessScanner::getSnapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return snapshot;
+}
+
+int64_t ProcessScanner::intervalNsLocked() const {
+    int64_t interval = 0;
+    for (const auto& client : clientIntervalsNs) {
+        interval = interval == 0 ? client.second : std::min(interval, client.second);
+    }
+    return interval;
+}
+
+void ProcessScanner::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        // Scans keep to a grid from the previous start, like DeadlineTimer;
+        // one that overran its interval is followed by the next right away
+        while (!stopping && !scanRequested) {
+            int64_t interval = intervalNsLocked();
+            if (interval == 0) {
+                wakeup.wait(lock);
+                continue;
+            }
+            int64_t remaining = lastScanStartNs + interval - SampleClock::nowNs();
+            if (lastScanStartNs == 0 || remaining <= 0) {
+                break;
+            }
+            wakeup.wait_for(lock, std::chrono::nanoseconds(remaining));
+        }
+        if (stopping) {
+            return;
+        }
+        scanRequested = false;
+        lastScanStartNs = SampleClock::nowNs();
+        lock.unlock();
+
+        // The first scan happens in the constructor
+        if (collector) {
+            collector->refresh();
+        } else {
+            collector = std::make_unique<ProcessInfoCollector>(readBackend);
+        }
+
+        auto next = std::make_shared<ProcessSnapshot>();
+        next->processes = collector->getProcesses();
+        next->sampledNs = SampleClock::nowNs();
+        next->scanDurationMs = collector->getLastScanDurationMs();
+        next->usesIoUring = collector->usesIoUring();
+        next->eventDriven = collector->isEventDriven();
+        next->forkRate = collector->getForkRate();
+        next->execRate = collector->getExecRate();
+        next->exitRate = collector->getExitRate();
+
+        lock.lock();
+        snapshot = std::move(next);
+        lock.unlock();
+        emit snapshotReady();
+        lock.lock();
+    }
+}
@@ -0,0 +1,220 @@
+#include "process_table_model.h"
+#include <QColor>
+#include <algorithm>
+#include <pwd.h>
+
+ProcessTableModel::ProcessTableModel(QObject *parent)
+    : QAbstractTableModel(parent),
+      sortColumn(CpuColumn),
+      sortOrder(Qt::DescendingOrder) {
+}
+
+int ProcessTableModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rows.size());
+}
+
+int ProcessTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ProcessTableModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= static_cast<int>(rows.size())) {
+        return QVariant();
+    }
+
+    const ProcessInfo &process = processes[rows[index.row()]];
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+            case PidColumn:
+                return process.pid;
+            case NameColumn:
+                return QString::fromStdString(process.name);
+            case UserColumn:
+                return userName(process.uid);
+            case StateColumn:
+                return QString(QChar(process.state));
+            case CpuColumn:
+                return QString::number(process.cpuPercent, 'f', 1);
+            case MemoryColumn:
+                return formatSize(process.rssBytes);
+            case ThreadsColumn:
+                return process.numThreads;
+            case ParentColumn:
+                return process.ppid;
+            default:
+                return QVariant();
+        }
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        if (index.column() == NameColumn || index.column() == UserColumn) {
+            return int(Qt::AlignLeft | Qt::AlignVCenter);
+        }
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    if (role == Qt::ForegroundRole && index.column() == StateColumn) {
+        if (process.state == 'R') {
+            return QColor(Qt::darkGreen);
+        } else if (process.state == 'D') {
+            return QColor(Qt::red);
+        } else if (process.state == 'Z') {
+            return QColor(Qt::darkGray);
+        }
+    }
+
+    return QVariant();
+}
+
+QVariant ProcessTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+        case PidColumn: return "PID";
+        case NameColumn: return "Name";
+        case UserColumn: return "User";
+        case StateColumn: return "State";
+        case CpuColumn: return "CPU %";
+        case MemoryColumn: return "Memory (RSS)";
+        case ThreadsColumn: return "Threads";
+        case ParentColumn: return "Parent PID";
+        default: return QVariant();
+    }
+}
+
+void ProcessTableModel::sort(int column, Qt::SortOrder order) {
+    sortColumn = column;
+    sortOrder = order;
+
+    emit layoutAboutToBeChanged();
+    std::vector<int> oldRows = rows;
+    rebuildRows();
+
+    // Sorting keeps the same rows, so selection and the current index
+    // follow their process to its new row
+    std::vector<int> newRowOf(processes.size(), -1);
+    for (size_t row = 0; row < rows.size(); ++row) {
+        newRowOf[rows[row]] = static_cast<int>(row);
+    }
+    QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex &index : from) {
+        int row = index.row() < static_cast<int>(oldRows.size()) ? newRowOf[oldRows[index.row()]] : -1;
+        to.append(row < 0 ? QModelIndex() : this->index(row, index.column()));
+    }
+    changePersistentIndexList(from, to);
+    emit layoutChanged();
+}
+
+void ProcessTableModel::setProcesses(const std::vector<ProcessInfo> &snapshot) {
+    beginResetModel();
+    processes = snapshot;
+    rebuildRows();
+    endResetModel();
+}
+
+void ProcessTableModel::setFilter(const QString &text) {
+    beginResetModel();
+    filter = text;
+    rebuildRows();
+    endResetModel();
+}
+
+int ProcessTableModel::pidAt(int row) const {
+    if (row < 0 || row >= static_cast<int>(rows.size())) {
+        return -1;
+    }
+    return processes[rows[row]].pid;
+}
+
+int ProcessTableModel::rowOfPid(int pid) const {
+    for (size_t row = 0; row < rows.size(); ++row) {
+        if (processes[rows[row]].pid == pid) {
+            return static_cast<int>(row);
+        }
+    }
+    return -1;
+}
+
+void ProcessTableModel::rebuildRows() {
+    rows.clear();
+    rows.reserve(processes.size());
+
+    for (size_t i = 0; i < processes.size(); ++i) {
+        if (!filter.isEmpty()) {
+            const ProcessInfo &process = processes[i];
+            if (!QString::fromStdString(process.name).contains(filter, Qt::CaseInsensitive) &&
+                !QString::number(process.pid).startsWith(filter)) {
+                continue;
+            }
+        }
+        rows.push_back(static_cast<int>(i));
+    }
+
+    // Sort row indices on the raw values rather than display strings
+    auto less = [this](int a, int b) {
+        const ProcessInfo &left = processes[a];
+        const ProcessInfo &right = processes[b];
+        switch (sortColumn) {
+            case NameColumn:
+                if (left.name != right.name) return left.name < right.name;
+                break;
+            case UserColumn:
+                if (left.uid != right.uid) return left.uid < right.uid;
+                break;
+            case StateColumn:
+                if (left.state != right.state) return left.state < right.state;
+                break;
+            case CpuColumn:
+                if (left.cpuPercent != right.cpuPercent) return left.cpuPercent < right.cpuPercent;
+                break;
+            case MemoryColumn:
+                if (left.rssBytes != right.rssBytes) return left.rssBytes < right.rssBytes;
+                break;
+            case ThreadsColumn:
+                if (left.numThreads != right.numThreads) return left.numThreads < right.numThreads;
+                break;
+            case ParentColumn:
+                if (left.ppid != right.ppid) return left.ppid < right.ppid;
+                break;
+            default:
+                break;
+        }
+        return left.pid < right.pid;
+    };
+
+    if (sortOrder == Qt::AscendingOrder) {
+        std::sort(rows.begin(), rows.end(), less);
+    } else {
+        std::sort(rows.begin(), rows.end(), [&less](int a, int b) { return less(b, a); });
+    }
+}
+
+QString ProcessTableModel::userName(uid_t uid) const {
+    auto it = userNames.constFind(uid);
+    if (it != userNames.constEnd()) {
+        return it.value();
+    }
+
+    struct passwd *entry = getpwuid(uid);
+    QString name = entry ? QString::fromLocal8Bit(entry->pw_name) : QString::number(uid);
+    userNames.insert(uid, name);
+    return name;
+}
+
+QString ProcessTableModel::formatSize(uint64_t bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unitIndex = 0;
+    double size = static_cast<double>(bytes);
+
+    while (size >= 1024.0 && unitIndex < 4) {
+        size /= 1024.0;
+        unitIndex++;
+    }
+
+    return QString("%1 %2").arg(size, 0, 'f', 2).arg(units[unitIndex]);
+}
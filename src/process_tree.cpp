@@ -0,0 +1,216 @@
+#include "process_tree.h"
+#include <cmath>
+
+namespace {
+
+int64_t toCpuMilli(double cpuPercent) {
+    return static_cast<int64_t>(std::llround(cpuPercent * 1000.0));
+}
+
+} // namespace
+
+ProcessTree::ProcessTree()
+    : generation(0),
+      propagationSteps(0) {
+
+    ProcessTreeNode root{};
+    root.pid = ROOT_PID;
+    root.ppid = -1;
+    root.parent = -1;
+    root.name = "All processes";
+    nodes.emplace(ROOT_PID, std::move(root));
+}
+
+const ProcessTreeNode* ProcessTree::find(int pid) const {
+    auto it = nodes.find(pid);
+    return it != nodes.end() ? &it->second : nullptr;
+}
+
+size_t ProcessTree::size() const {
+    return nodes.size() - 1;
+}
+
+const std::vector<int>& ProcessTree::getChangedPids() const {
+    return changedPids;
+}
+
+const std::vector<int>& ProcessTree::getRestructuredPids() const {
+    return restructuredPids;
+}
+
+uint64_t ProcessTree::getLastPropagationSteps() const {
+    return propagationSteps;
+}
+
+void ProcessTree::update(const std::vector<ProcessInfo>& snapshot) {
+    generation++;
+    changedPids.clear();
+    restructuredPids.clear();
+    pendingAttach.clear();
+    removedPids.clear();
+    propagationSteps = 0;
+
+    nodes[ROOT_PID].seenGeneration = generation;
+
+    // Mark survivors; a PID with a different start time is a new process
+    for (const auto& info : snapshot) {
+        auto it = nodes.find(info.pid);
+        if (it != nodes.end() && it->second.startTime == info.startTime) {
+            it->second.seenGeneration = generation;
+        }
+    }
+
+    // Drop exited processes. Their subtree totals leave the ancestors with
+    // them; children stay detached until their new parent is known.
+    for (const auto& [pid, node] : nodes) {
+        if (node.seenGeneration != generation) {
+            removedPids.push_back(pid);
+        }
+    }
+    for (int pid : removedPids) {
+        ProcessTreeNode& node = nodes[pid];
+        detach(node);
+        for (int childPid : node.children) {
+            ProcessTreeNode& child = nodes[childPid];
+            child.parent = -1;
+            pendingAttach.push_back(childPid);
+        }
+        node.children.clear();
+        nodes.erase(pid);
+    }
+
+    for (const auto& info : snapshot) {
+        auto it = nodes.find(info.pid);
+        int64_t cpuMilli = toCpuMilli(info.cpuPercent);
+
+        if (it == nodes.end()) {
+            ProcessTreeNode node{};
+            node.pid = info.pid;
+            node.ppid = info.ppid;
+            node.parent = -1;
+            node.name = info.name;
+            node.startTime = info.startTime;
+            node.selfCpuMilli = cpuMilli;
+            node.selfRssBytes = info.rssBytes;
+            node.selfThreads = info.numThreads;
+            node.totalCpuMilli = cpuMilli;
+            node.totalRssBytes = info.rssBytes;
+            node.totalThreads = info.numThreads;
+            node.totalProcesses = 1;
+            node.seenGeneration = generation;
+            nodes.emplace(info.pid, std::move(node));
+            pendingAttach.push_back(info.pid);
+            continue;
+        }
+
+        ProcessTreeNode& node = it->second;
+        int64_t cpuDelta = cpuMilli - node.selfCpuMilli;
+        int64_t rssDelta = static_cast<int64_t>(info.rssBytes - node.selfRssBytes);
+        int64_t threadDelta = info.numThreads - node.selfThreads;
+
+        if (node.name != info.name) {
+            node.name = info.name;     // exec() changed comm
+            markChanged(node);
+        }
+
+        if (cpuDelta != 0 || rssDelta != 0 || threadDelta != 0) {
+            node.selfCpuMilli = cpuMilli;
+            node.selfRssBytes = info.rssBytes;
+            node.selfThreads = info.numThreads;
+            propagate(node.pid, cpuDelta, rssDelta, threadDelta, 0);
+        }
+
+        if (node.ppid != info.ppid) {
+            // Reparented, usually to init or a subreaper after its parent exited
+            node.ppid = info.ppid;
+            detach(node);
+        }
+        if (node.parent < 0) {
+            pendingAttach.push_back(node.pid);
+        }
+    }
+
+    for (int pid : pendingAttach) {
+        auto it = nodes.find(pid);
+        if (it != nodes.end() && it->second.parent < 0) {
+            attach(it->second);
+        }
+    }
+}
+
+void ProcessTree::propagate(int pid, int64_t cpuMilli, int64_t rssBytes, int64_t threads, int64_t processes) {
+    // Walk up until the root, or until a detached node: its totals reach
+    // the rest of the chain when it is attached
+    for (int current = pid; current >= 0;) {
+        ProcessTreeNode& node = nodes[current];
+        node.totalCpuMilli += cpuMilli;
+        node.totalRssBytes += static_cast<uint64_t>(rssBytes);
+        node.totalThreads += threads;
+        node.totalProcesses += processes;
+        markChanged(node);
+        propagationSteps++;
+
+        if (current == ROOT_PID) {
+            break;
+        }
+        current = node.parent;
+    }
+}
+
+void ProcessTree::attach(ProcessTreeNode& node) {
+    int target = node.ppid;
+    auto it = nodes.find(target);
+    if (target == node.pid || it == nodes.end()) {
+        target = ROOT_PID;
+    } else {
+        // A reused PID can make the reported parent one of our descendants
+        for (int current = target; current >= 0 && current != ROOT_PID; current = nodes[current].parent) {
+            if (current == node.pid) {
+                target = ROOT_PID;
+                break;
+            }
+        }
+    }
+
+    ProcessTreeNode& parent = nodes[target];
+    node.parent = target;
+    node.indexInParent = parent.children.size();
+    parent.children.push_back(node.pid);
+    markRestructured(parent);
+
+    propagate(target, node.totalCpuMilli, static_cast<int64_t>(node.totalRssBytes),
+              node.totalThreads, node.totalProcesses);
+}
+
+void ProcessTree::detach(ProcessTreeNode& node) {
+    if (node.parent < 0) {
+        return;
+    }
+
+    ProcessTreeNode& parent = nodes[node.parent];
+    propagate(node.parent, -node.totalCpuMilli, -static_cast<int64_t>(node.totalRssBytes),
+              -node.totalThreads, -node.totalProcesses);
+
+    // Swap-remove keeps this O(1) even under a parent with many children
+    int last = parent.children.back();
+    parent.children[node.indexInParent] = last;
+    nodes[last].indexInParent = node.indexInParent;
+    parent.children.pop_back();
+    markRestructured(parent);
+
+    node.parent = -1;
+}
+
+void ProcessTree::markChanged(ProcessTreeNode& node) {
+    if (node.changedGeneration != generation) {
+        node.changedGeneration = generation;
+        changedPids.push_back(node.pid);
+    }
+}
+
+void ProcessTree::markRestructured(ProcessTreeNode& node) {
+    if (node.restructuredGeneration != generation) {
+        node.restructuredGeneration = generation;
+        restructuredPids.push_back(node.pid);
+    }
+}
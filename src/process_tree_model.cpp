@@ -0,0 +1,319 @@
+#include "process_tree_model.h"
+#include "process_table_model.h"
+#include <algorithm>
+
+ProcessTreeModel::ProcessTreeModel(QObject *parent)
+    : QAbstractItemModel(parent) {
+
+    // The invisible root is always fetched so top-level processes show up
+    // with the first snapshot
+    visible[ProcessTree::ROOT_PID] = {-1, 0, true, {}};
+}
+
+const ProcessTree &ProcessTreeModel::getTree() const {
+    return tree;
+}
+
+int ProcessTreeModel::pidOf(const QModelIndex &index) const {
+    return index.isValid() ? static_cast<int>(index.internalId()) : -1;
+}
+
+QModelIndex ProcessTreeModel::index(int row, int column, const QModelIndex &parent) const {
+    if (row < 0 || column < 0 || column >= ColumnCount) {
+        return QModelIndex();
+    }
+
+    int parentPid = parent.isValid() ? static_cast<int>(parent.internalId()) : ProcessTree::ROOT_PID;
+    auto it = visible.find(parentPid);
+    if (it == visible.end() || row >= static_cast<int>(it->second.children.size())) {
+        return QModelIndex();
+    }
+
+    return createIndex(row, column, static_cast<quintptr>(it->second.children[row]));
+}
+
+QModelIndex ProcessTreeModel::parent(const QModelIndex &child) const {
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+
+    // Answer from the mirror, not the tree: during a row removal the view
+    // still needs the structure it was last told about
+    auto it = visible.find(static_cast<int>(child.internalId()));
+    if (it == visible.end() || it->second.parent == ProcessTree::ROOT_PID) {
+        return QModelIndex();
+    }
+    return indexOfPid(it->second.parent);
+}
+
+QModelIndex ProcessTreeModel::indexOfPid(int pid, int column) const {
+    auto it = visible.find(pid);
+    if (pid == ProcessTree::ROOT_PID || it == visible.end()) {
+        return QModelIndex();
+    }
+
+    auto parentIt = visible.find(it->second.parent);
+    if (parentIt == visible.end()) {
+        return QModelIndex();
+    }
+
+    const std::vector<int> &siblings = parentIt->second.children;
+    auto position = std::lower_bound(siblings.begin(), siblings.end(), pid);
+    if (position == siblings.end() || *position != pid) {
+        return QModelIndex();
+    }
+    return createIndex(static_cast<int>(position - siblings.begin()), column, static_cast<quintptr>(pid));
+}
+
+int ProcessTreeModel::rowCount(const QModelIndex &parent) const {
+    if (parent.column() > 0) {
+        return 0;
+    }
+
+    int pid = parent.isValid() ? static_cast<int>(parent.internalId()) : ProcessTree::ROOT_PID;
+    auto it = visible.find(pid);
+    if (it == visible.end() || !it->second.fetched) {
+        return 0;
+    }
+    return static_cast<int>(it->second.children.size());
+}
+
+int ProcessTreeModel::columnCount(const QModelIndex &) const {
+    return ColumnCount;
+}
+
+bool ProcessTreeModel::hasChildren(const QModelIndex &parent) const {
+    if (parent.column() > 0) {
+        return false;
+    }
+
+    int pid = parent.isValid() ? static_cast<int>(parent.internalId()) : ProcessTree::ROOT_PID;
+    auto it = visible.find(pid);
+    if (it != visible.end() && it->second.fetched) {
+        return !it->second.children.empty();
+    }
+
+    // Not expanded yet: report children without materializing them
+    const ProcessTreeNode *node = tree.find(pid);
+    return node && !node->children.empty();
+}
+
+bool ProcessTreeModel::canFetchMore(const QModelIndex &parent) const {
+    int pid = parent.isValid() ? static_cast<int>(parent.internalId()) : ProcessTree::ROOT_PID;
+    auto it = visible.find(pid);
+    if (it == visible.end() || it->second.fetched) {
+        return false;
+    }
+
+    const ProcessTreeNode *node = tree.find(pid);
+    return node && !node->children.empty();
+}
+
+void ProcessTreeModel::fetchMore(const QModelIndex &parent) {
+    int pid = parent.isValid() ? static_cast<int>(parent.internalId()) : ProcessTree::ROOT_PID;
+    auto it = visible.find(pid);
+    if (it == visible.end() || it->second.fetched) {
+        return;
+    }
+
+    // Inserting into visible may rehash; references survive, iterators do not
+    VisibleNode &node = it->second;
+    std::vector<int> children = sortedChildren(pid);
+    if (children.empty()) {
+        node.fetched = true;
+        return;
+    }
+
+    beginInsertRows(parent, 0, static_cast<int>(children.size()) - 1);
+    for (int childPid : children) {
+        visible[childPid] = {pid, tree.find(childPid)->startTime, false, {}};
+    }
+    node.children = std::move(children);
+    node.fetched = true;
+    endInsertRows();
+}
+
+QVariant ProcessTreeModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    const ProcessTreeNode *node = tree.find(static_cast<int>(index.internalId()));
+    if (!node) {
+        return QVariant();
+    }
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+            case NameColumn:
+                return QString::fromStdString(node->name);
+            case PidColumn:
+                return node->pid;
+            case CpuColumn:
+                return QString::number(node->totalCpuMilli / 1000.0, 'f', 1);
+            case MemoryColumn:
+                return ProcessTableModel::formatSize(node->totalRssBytes);
+            case ThreadsColumn:
+                return static_cast<qlonglong>(node->totalThreads);
+            case ProcessesColumn:
+                return static_cast<qlonglong>(node->totalProcesses);
+            case OwnCpuColumn:
+                return QString::number(node->selfCpuMilli / 1000.0, 'f', 1);
+            default:
+                return QVariant();
+        }
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        if (index.column() == NameColumn) {
+            return int(Qt::AlignLeft | Qt::AlignVCenter);
+        }
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    return QVariant();
+}
+
+QVariant ProcessTreeModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractItemModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+        case NameColumn: return "Name";
+        case PidColumn: return "PID";
+        case CpuColumn: return "Subtree CPU %";
+        case MemoryColumn: return "Subtree Memory";
+        case ThreadsColumn: return "Subtree Threads";
+        case ProcessesColumn: return "Processes";
+        case OwnCpuColumn: return "Own CPU %";
+        default: return QVariant();
+    }
+}
+
+void ProcessTreeModel::setProcesses(const std::vector<ProcessInfo> &snapshot) {
+    tree.update(snapshot);
+
+    // Only expanded nodes whose children changed need row updates. Remove
+    // everything stale first so a process moving between two expanded
+    // parents is never mirrored twice. A node can leave the mirror in the
+    // first pass and come back unfetched in the second, so check each time.
+    auto isExpanded = [this](int pid) {
+        auto it = visible.find(pid);
+        return it != visible.end() && it->second.fetched && tree.find(pid);
+    };
+
+    const std::vector<int> &restructured = tree.getRestructuredPids();
+    for (int pid : restructured) {
+        if (isExpanded(pid)) {
+            removeStaleChildren(pid);
+        }
+    }
+    for (int pid : restructured) {
+        if (isExpanded(pid)) {
+            insertNewChildren(pid);
+        }
+    }
+
+    for (int pid : tree.getChangedPids()) {
+        if (pid == ProcessTree::ROOT_PID) {
+            continue;
+        }
+        QModelIndex first = indexOfPid(pid);
+        if (first.isValid()) {
+            emit dataChanged(first, first.sibling(first.row(), ColumnCount - 1));
+        }
+    }
+}
+
+std::vector<int> ProcessTreeModel::sortedChildren(int pid) const {
+    std::vector<int> children;
+    const ProcessTreeNode *node = tree.find(pid);
+    if (node) {
+        children = node->children;
+        std::sort(children.begin(), children.end());
+    }
+    return children;
+}
+
+void ProcessTreeModel::removeStaleChildren(int pid) {
+    VisibleNode &node = visible[pid];
+    QModelIndex parentIndex = indexOfPid(pid);
+
+    auto isStale = [this, pid](int childPid) {
+        const ProcessTreeNode *child = tree.find(childPid);
+        return !child || child->parent != pid || child->startTime != visible[childPid].startTime;
+    };
+
+    // Walk backwards so row numbers of pending runs stay valid
+    int row = static_cast<int>(node.children.size()) - 1;
+    while (row >= 0) {
+        if (!isStale(node.children[row])) {
+            row--;
+            continue;
+        }
+
+        int last = row;
+        while (row > 0 && isStale(node.children[row - 1])) {
+            row--;
+        }
+
+        beginRemoveRows(parentIndex, row, last);
+        for (int i = row; i <= last; ++i) {
+            forgetSubtree(node.children[i]);
+        }
+        node.children.erase(node.children.begin() + row, node.children.begin() + last + 1);
+        endRemoveRows();
+
+        row--;
+    }
+}
+
+void ProcessTreeModel::insertNewChildren(int pid) {
+    VisibleNode &node = visible[pid];
+    QModelIndex parentIndex = indexOfPid(pid);
+    std::vector<int> desired = sortedChildren(pid);
+
+    // After removeStaleChildren() the mirrored children are a sorted subset
+    // of desired; insert each run of missing PIDs at its position
+    size_t row = 0;
+    size_t next = 0;
+    while (next < desired.size()) {
+        if (row < node.children.size() && node.children[row] == desired[next]) {
+            row++;
+            next++;
+            continue;
+        }
+
+        size_t runEnd = next;
+        while (runEnd < desired.size() &&
+               (row >= node.children.size() || desired[runEnd] != node.children[row])) {
+            runEnd++;
+        }
+
+        beginInsertRows(parentIndex, static_cast<int>(row), static_cast<int>(row + runEnd - next) - 1);
+        for (size_t i = next; i < runEnd; ++i) {
+            visible[desired[i]] = {pid, tree.find(desired[i])->startTime, false, {}};
+        }
+        node.children.insert(node.children.begin() + row, desired.begin() + next, desired.begin() + runEnd);
+        endInsertRows();
+
+        row += runEnd - next;
+        next = runEnd;
+    }
+}
+
+void ProcessTreeModel::forgetSubtree(int pid) {
+    std::vector<int> pending{pid};
+    while (!pending.empty()) {
+        int current = pending.back();
+        pending.pop_back();
+
+        auto it = visible.find(current);
+        if (it == visible.end()) {
+            continue;
+        }
+        pending.insert(pending.end(), it->second.children.begin(), it->second.children.end());
+        visible.erase(it);
+    }
+}
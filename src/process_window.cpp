@@ -0,0 +1,226 @@
+#include "process_window.h"
+#include <QHeaderView>
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QCheckBox>
+#include <QItemSelectionModel>
+
+namespace {
+
+const int AUTO_REFRESH_MS = 2000;
+
+} // namespace
+
+ProcessWindow::ProcessWindow(ProcessScanner *scanner, QWidget *parent)
+    : QWidget(parent),
+      scanner(scanner),
+      autoRefreshEnabled(true) {
+    setupUI();
+    connect(scanner, &ProcessScanner::snapshotReady, this, &ProcessWindow::snapshotReady);
+}
+
+ProcessWindow::~ProcessWindow() {
+    if (scanner) {
+        scanner->removeClient(this);
+    }
+}
+
+void ProcessWindow::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+
+    // Show what the last scan found while the next one runs
+    snapshotReady();
+    updateScanRequest();
+}
+
+void ProcessWindow::hideEvent(QHideEvent *event) {
+    QWidget::hideEvent(event);
+    updateScanRequest();
+}
+
+void ProcessWindow::updateScanRequest() {
+    if (isVisible() && autoRefreshEnabled) {
+        scanner->addClient(this, AUTO_REFRESH_MS);
+    } else {
+        scanner->removeClient(this);
+        if (isVisible() && !snapshot) {
+            scanner->requestScan();
+        }
+    }
+}
+
+void ProcessWindow::setupUI() {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    QFont titleFont = font();
+    titleFont.setPointSize(12);
+    titleFont.setBold(true);
+
+    // Create header
+    QLabel *headerLabel = new QLabel("Processes", this);
+    headerLabel->setFont(titleFont);
+    layout->addWidget(headerLabel);
+
+    // Create filter controls
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+
+    QLabel *filterLabel = new QLabel("Filter:", this);
+    filterLayout->addWidget(filterLabel);
+
+    filterEdit = new QLineEdit(this);
+    filterEdit->setPlaceholderText("Enter process name or PID to filter...");
+    connect(filterEdit, &QLineEdit::textChanged, this, &ProcessWindow::filterProcesses);
+    filterLayout->addWidget(filterEdit);
+
+    layout->addLayout(filterLayout);
+
+    // The model only materializes the rows the view asks for, so a host
+    // with 100k processes costs no more to display than one with 100
+    processModel = new ProcessTableModel(this);
+
+    processView = new QTableView(this);
+    processView->setObjectName("processTable");
+    processView->setModel(processModel);
+    processView->setSortingEnabled(true);
+    processView->sortByColumn(ProcessTableModel::CpuColumn, Qt::DescendingOrder);
+    processView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    processView->setSelectionMode(QAbstractItemView::SingleSelection);
+    processView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    processView->setAlternatingRowColors(true);
+    processView->setWordWrap(false);
+    processView->verticalHeader()->setVisible(false);
+    processView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    processView->verticalHeader()->setDefaultSectionSize(processView->fontMetrics().height() + 6);
+    processView->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    processView->horizontalHeader()->setSectionResizeMode(ProcessTableModel::NameColumn, QHeaderView::Stretch);
+
+    // Parent/child view with per-subtree totals. Children are fetched on
+    // first expansion and the tree is only updated while this tab is shown.
+    treeModel = new ProcessTreeModel(this);
+
+    treeView = new QTreeView(this);
+    treeView->setObjectName("processTree");
+    treeView->setModel(treeModel);
+    treeView->setUniformRowHeights(true);
+    treeView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    treeView->setSelectionMode(QAbstractItemView::SingleSelection);
+    treeView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    treeView->setAlternatingRowColors(true);
+    treeView->header()->setSectionResizeMode(QHeaderView::Interactive);
+    treeView->header()->setSectionResizeMode(ProcessTreeModel::NameColumn, QHeaderView::Stretch);
+    treeView->header()->setStretchLastSection(false);
+
+    tabWidget = new QTabWidget(this);
+    tabWidget->addTab(processView, "List");
+    tabWidget->addTab(treeView, "Tree");
+    connect(tabWidget, &QTabWidget::currentChanged, this, &ProcessWindow::viewChanged);
+    layout->addWidget(tabWidget);
+
+    // Create controls at the bottom
+    QHBoxLayout *controlLayout = new QHBoxLayout();
+
+    // Auto-refresh checkbox
+    QCheckBox *autoRefreshCheckbox = new QCheckBox("Auto-refresh (2s)", this);
+    autoRefreshCheckbox->setChecked(true);
+    connect(autoRefreshCheckbox, &QCheckBox::toggled, [this](bool checked) {
+        autoRefreshEnabled = checked;
+        updateScanRequest();
+    });
+    controlLayout->addWidget(autoRefreshCheckbox);
+
+    controlLayout->addStretch();
+
+    summaryLabel = new QLabel(this);
+    controlLayout->addWidget(summaryLabel);
+
+    // Last update label
+    lastUpdateLabel = new QLabel(this);
+    controlLayout->addWidget(lastUpdateLabel);
+
+    // Refresh button
+    refreshButton = new QPushButton("Refresh", this);
+    connect(refreshButton, &QPushButton::clicked, this, &ProcessWindow::refreshData);
+    controlLayout->addWidget(refreshButton);
+
+    layout->addLayout(controlLayout);
+}
+
+void ProcessWindow::updateTable() {
+    if (!snapshot) {
+        summaryLabel->setText("Scanning processes...");
+        return;
+    }
+
+    // Keep the selected process selected across the model reset
+    int selectedPid = -1;
+    QModelIndexList selected = processView->selectionModel()->selectedRows();
+    if (!selected.isEmpty()) {
+        selectedPid = processModel->pidAt(selected.first().row());
+    }
+
+    processModel->setProcesses(snapshot->processes);
+
+    if (selectedPid >= 0) {
+        int row = processModel->rowOfPid(selectedPid);
+        if (row >= 0) {
+            processView->selectRow(row);
+        }
+    }
+
+    if (tabWidget->currentWidget() == treeView) {
+        updateTree();
+    }
+
+    QString summary = QString("%1 processes (scan %2 ms, %3)")
+                          .arg(snapshot->processes.size())
+                          .arg(snapshot->scanDurationMs, 0, 'f', 1)
+                          .arg(snapshot->usesIoUring ? "io_uring" : "sync");
+    if (snapshot->eventDriven) {
+        summary += QString("  |  Forks: %1/s  Execs: %2/s  Exits: %3/s")
+                       .arg(snapshot->forkRate, 0, 'f', 1)
+                       .arg(snapshot->execRate, 0, 'f', 1)
+                       .arg(snapshot->exitRate, 0, 'f', 1);
+    }
+    summaryLabel->setText(summary);
+    summaryLabel->setToolTip(snapshot->eventDriven
+        ? "Process list tracked from kernel fork/exit events"
+        : "Fork/exec rates need CAP_NET_ADMIN for the netlink proc connector");
+
+    // Update last refresh time
+    QDateTime now = QDateTime::currentDateTime();
+    lastUpdateLabel->setText("Last updated: " + now.toString("hh:mm:ss"));
+}
+
+void ProcessWindow::updateTree() {
+    // Incremental: selection and expansion survive because rows are
+    // inserted/removed rather than reset
+    if (snapshot) {
+        treeModel->setProcesses(snapshot->processes);
+    }
+}
+
+void ProcessWindow::viewChanged(int index) {
+    bool treeShown = tabWidget->widget(index) == treeView;
+    filterEdit->setEnabled(!treeShown);
+    if (treeShown) {
+        updateTree();
+    }
+}
+
+void ProcessWindow::refreshData() {
+    scanner->requestScan();
+}
+
+void ProcessWindow::snapshotReady() {
+    // Other pages may keep the scanner busy while this one is hidden
+    std::shared_ptr<const ProcessSnapshot> latest = scanner->getSnapshot();
+    if (!isVisible() || !latest || latest == snapshot) {
+        return;
+    }
+    snapshot = std::move(latest);
+    updateTable();
+}
+
+void ProcessWindow::filterProcesses(const QString& text) {
+    processModel->setFilter(text);
+}
@@ -0,0 +1,77 @@
+#include "rolling_line_series.h"
+#include <QDateTime>
+#include <algorithm>
+
+RollingLineSeries::RollingLineSeries(int capacity)
+    : maxPoints(capacity),
+      windowMsecs(0),
+      timeAxis(nullptr) {
+}
+
+void RollingLineSeries::addSeries(QLineSeries *lineSeries) {
+    series.push_back(lineSeries);
+}
+
+void RollingLineSeries::setTimeAxis(QDateTimeAxis *axis) {
+    timeAxis = axis;
+}
+
+void RollingLineSeries::setWindowMsecs(qint64 msecs) {
+    windowMsecs = msecs;
+}
+
+int RollingLineSeries::size() const {
+    return series.empty() ? 0 : series.front()->count();
+}
+
+int RollingLineSeries::capacity() const {
+    return maxPoints;
+}
+
+void RollingLineSeries::append(qint64 msecsSinceEpoch, const std::vector<double> &values) {
+    for (size_t i = 0; i < series.size() && i < values.size(); ++i) {
+        QLineSeries *lineSeries = series[i];
+        lineSeries->append(msecsSinceEpoch, values[i]);
+
+        // One pointsRemoved() for the whole overflow, not one per point
+        int excess = lineSeries->count() - maxPoints;
+        if (windowMsecs > 0) {
+            qint64 cutoff = msecsSinceEpoch - windowMsecs;
+            int expired = 0;
+            while (expired < lineSeries->count() && lineSeries->at(expired).x() < cutoff) {
+                ++expired;
+            }
+            excess = std::max(excess, expired);
+        }
+        if (excess > 0) {
+            lineSeries->removePoints(0, excess);
+        }
+    }
+    updateTimeAxis();
+}
+
+void RollingLineSeries::replace(const QVector<qint64> &times, const std::vector<QVector<double>> &values) {
+    int first = std::max(0, times.size() - maxPoints);
+    for (size_t i = 0; i < series.size() && i < values.size(); ++i) {
+        QVector<QPointF> points;
+        points.reserve(times.size() - first);
+        for (int j = first; j < times.size() && j < values[i].size(); ++j) {
+            points.append(QPointF(times[j], values[i][j]));
+        }
+
+        // A single pointsReplaced() instead of a signal per point
+        series[i]->replace(points);
+    }
+    updateTimeAxis();
+}
+
+void RollingLineSeries::updateTimeAxis() {
+    if (!timeAxis || series.empty() || series.front()->count() == 0) {
+        return;
+    }
+
+    const QLineSeries *reference = series.front();
+    qint64 last = static_cast<qint64>(reference->at(reference->count() - 1).x());
+    qint64 first = windowMsecs > 0 ? last - windowMsecs : static_cast<qint64>(reference->at(0).x());
+    timeAxis->setRange(QDateTime::fromMSecsSinceEpoch(first), QDateTime::fromMSecsSinceEpoch(last));
+}
@@ -0,0 +1,47 @@
+#include "sample_clock.h"
+#include <atomic>
+#include <ctime>
+
+namespace {
+
+const int64_t NSEC_PER_SEC = 1000000000;
+const int64_t NSEC_PER_MSEC = 1000000;
+const int64_t OFFSET_STEP_NS = NSEC_PER_SEC;    // Smaller moves are slew or jitter
+
+int64_t readClock(clockid_t clock) {
+    timespec now;
+    clock_gettime(clock, &now);
+    return static_cast<int64_t>(now.tv_sec) * NSEC_PER_SEC + now.tv_nsec;
+}
+
+// Wall clock minus boot time, read back to back
+int64_t readWallOffsetNs() {
+    return readClock(CLOCK_REALTIME) - readClock(CLOCK_BOOTTIME);
+}
+
+// The offset in use, replaced only when the wall clock has been stepped
+int64_t wallOffsetNs() {
+    static std::atomic<int64_t> offset(readWallOffsetNs());
+
+    int64_t current = readWallOffsetNs();
+    int64_t used = offset.load(std::memory_order_relaxed);
+    if (current - used > OFFSET_STEP_NS || used - current > OFFSET_STEP_NS) {
+        offset.store(current, std::memory_order_relaxed);
+        return current;
+    }
+    return used;
+}
+
+} // namespace
+
+int64_t SampleClock::nowNs() {
+    return readClock(CLOCK_BOOTTIME);
+}
+
+double SampleClock::toSeconds(int64_t ns) {
+    return static_cast<double>(ns) / NSEC_PER_SEC;
+}
+
+int64_t SampleClock::toWallMsecs(int64_t ns) {
+    return (ns + wallOffsetNs()) / NSEC_PER_MSEC;
+}
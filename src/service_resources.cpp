@@ -0,0 +1,179 @@
+#include "service_resources.h"
+#include "cgroup_info.h"
+#include <unordered_set>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+
+const size_t READ_BUFFER_SIZE = 64 * 1024;     // io.stat grows with the device count
+const char* const SYSTEM_SLICE = "system.slice";
+
+double ratePerSecond(uint64_t current, uint64_t previous, double elapsedSeconds) {
+    return current >= previous ? (current - previous) / elapsedSeconds : 0.0;
+}
+
+// systemd escapes '-' in slice names, since it separates the slice levels
+std::string escapeSliceName(const std::string& name) {
+    std::string escaped;
+    for (char c : name) {
+        if (c == '-') {
+            escaped += "\\x2d";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+ServiceResourceCollector::ServiceResourceCollector()
+    : sliceFd(-1),
+      readBuffer(READ_BUFFER_SIZE),
+      hasPreviousSample(false),
+      lastSampleDurationMs(0.0) {
+
+    std::string slicePath = CgroupInfoCollector::findMountPoint() + "/" + SYSTEM_SLICE;
+    sliceFd = open(slicePath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+ServiceResourceCollector::~ServiceResourceCollector() {
+    units.clear();
+    if (sliceFd >= 0) {
+        close(sliceFd);
+    }
+}
+
+bool ServiceResourceCollector::isAvailable() const {
+    return sliceFd >= 0;
+}
+
+const ServiceResources* ServiceResourceCollector::find(const std::string& unit) const {
+    auto it = units.find(unit);
+    return it == units.end() ? nullptr : &it->second.resources;
+}
+
+const std::vector<std::string>& ServiceResourceCollector::getTrackedUnits() const {
+    return trackedUnits;
+}
+
+double ServiceResourceCollector::getLastSampleDurationMs() const {
+    return lastSampleDurationMs;
+}
+
+void ServiceResourceCollector::setRunningUnits(const std::vector<std::string>& names) {
+    if (sliceFd < 0) {
+        return;
+    }
+
+    std::unordered_set<std::string> running(names.begin(), names.end());
+    for (auto it = units.begin(); it != units.end();) {
+        if (running.count(it->first) == 0) {
+            it = units.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const std::string& name : names) {
+        auto it = units.find(name);
+        if (it != units.end() && it->second.resolved) {
+            continue;
+        }
+
+        // New units, and units that had no cgroup last time (still starting)
+        Unit& unit = units[name];
+        unit.resources = {false, 0.0, 0, 0, 0.0, 0.0};
+        unit.hasPrevious = false;
+        unit.resolved = resolveUnit(name, unit);
+    }
+
+    trackedUnits.assign(names.begin(), names.end());
+}
+
+bool ServiceResourceCollector::resolveUnit(const std::string& name, Unit& unit) const {
+    struct stat st;
+    if (fstatat(sliceFd, name.c_str(), &st, 0) == 0 && S_ISDIR(st.st_mode)) {
+        unit.relativePath = name;
+        return true;
+    }
+
+    // Template instances live in a slice of their own, e.g.
+    // system-getty.slice/getty@tty1.service
+    size_t at = name.find('@');
+    if (at == std::string::npos) {
+        return false;
+    }
+
+    std::string path = "system-" + escapeSliceName(name.substr(0, at)) + ".slice/" + name;
+    if (fstatat(sliceFd, path.c_str(), &st, 0) == 0 && S_ISDIR(st.st_mode)) {
+        unit.relativePath = path;
+        return true;
+    }
+    return false;
+}
+
+SysfsFile ServiceResourceCollector::openFile(const Unit& unit, const char* name) const {
+    // A controller that is not enabled just leaves its file closed
+    return SysfsFile(sliceFd, (unit.relativePath + "/" + name).c_str());
+}
+
+void ServiceResourceCollector::sample() {
+    auto now = std::chrono::steady_clock::now();
+    double elapsedSeconds = hasPreviousSample
+        ? std::chrono::duration<double>(now - lastSampleTime).count()
+        : 0.0;
+
+    for (auto& [name, unit] : units) {
+        if (unit.resolved) {
+            readUnit(unit, elapsedSeconds);
+        }
+    }
+
+    lastSampleTime = now;
+    hasPreviousSample = true;
+    lastSampleDurationMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - now).count();
+}
+
+void ServiceResourceCollector::readUnit(Unit& unit, double elapsedSeconds) {
+    ServiceResources& resources = unit.resources;
+    uint64_t cpuUsageUsec = 0;
+    bool cpuOk = openFile(unit, "cpu.stat").read(readBuffer.data(), readBuffer.size()) > 0 &&
+                 CgroupInfoCollector::parseKeyValue(readBuffer.data(), "usage_usec", cpuUsageUsec);
+    if (!cpuOk) {
+        // The unit stopped and its cgroup is gone; the next list refresh
+        // drops or re-resolves it
+        resources = {false, 0.0, 0, 0, 0.0, 0.0};
+        unit.resolved = false;
+        unit.hasPrevious = false;
+        return;
+    }
+
+    resources.memoryBytes = 0;
+    openFile(unit, "memory.current").readUInt64(resources.memoryBytes);
+    resources.tasks = 0;
+    openFile(unit, "pids.current").readUInt64(resources.tasks);
+
+    uint64_t ioReadBytes = 0;
+    uint64_t ioWriteBytes = 0;
+    if (openFile(unit, "io.stat").read(readBuffer.data(), readBuffer.size()) >= 0) {
+        ioReadBytes = CgroupInfoCollector::sumKeyTokens(readBuffer.data(), "rbytes=");
+        ioWriteBytes = CgroupInfoCollector::sumKeyTokens(readBuffer.data(), "wbytes=");
+    }
+
+    resources.available = true;
+
+    if (unit.hasPrevious && elapsedSeconds > 0.0) {
+        resources.cpuPercent = ratePerSecond(cpuUsageUsec, unit.lastCpuUsageUsec, elapsedSeconds) / 10000.0;
+        resources.ioReadBytesPerSec = ratePerSecond(ioReadBytes, unit.lastIoReadBytes, elapsedSeconds);
+        resources.ioWriteBytesPerSec = ratePerSecond(ioWriteBytes, unit.lastIoWriteBytes, elapsedSeconds);
+    }
+
+    unit.lastCpuUsageUsec = cpuUsageUsec;
+    unit.lastIoReadBytes = ioReadBytes;
+    unit.lastIoWriteBytes = ioWriteBytes;
+    unit.hasPrevious = true;
+}
@@ -1,4 +1,5 @@
 #include "service_window.h"
+#include "numeric_table_item.h"
 #include <QHeaderView>
 #include <QDateTime>
 #include <QMessageBox>
@@ -9,12 +10,20 @@
 
 ServiceWindow::ServiceWindow(QWidget *parent) : QWidget(parent), selectedService("") {
     setupUI();
+    updateTrackedUnits();
+    serviceResources.sample();
     updateTable();
 
     // Set up auto-refresh timer (every 10 seconds)
     autoRefreshTimer = new QTimer(this);
     connect(autoRefreshTimer, &QTimer::timeout, this, &ServiceWindow::refreshData);
     autoRefreshTimer->start(10000);
+
+    // Resource usage only re-reads the cgroup files of running units, so it
+    // can refresh much more often than the systemctl unit list
+    resourceTimer = new DeadlineTimer(this);
+    connect(resourceTimer, &DeadlineTimer::timeout, this, &ServiceWindow::updateResources);
+    resourceTimer->start(2000);
 }
 
 void ServiceWindow::setupUI() {
@@ -52,10 +61,11 @@ void ServiceWindow::setupUI() {
     // Create table for services
     serviceTable = new QTableWidget(this);
     serviceTable->setObjectName("serviceTable");
-    serviceTable->setColumnCount(4);
+    serviceTable->setColumnCount(ColumnCount);
     serviceTable->setHorizontalHeaderLabels(
-        {"Service", "Description", "Status", "Sub-State"});
-    serviceTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        {"Service", "Description", "Status", "Sub-State", "CPU %", "Memory", "Tasks", "Read/s", "Write/s"});
+    serviceTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    serviceTable->horizontalHeader()->setSectionResizeMode(DescriptionColumn, QHeaderView::Stretch);
     serviceTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     serviceTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     serviceTable->setSelectionMode(QAbstractItemView::SingleSelection);
@@ -119,13 +129,15 @@ void ServiceWindow::setupUI() {
     QHBoxLayout *statusLayout = new QHBoxLayout();
 
     // Auto-refresh checkbox
-    QCheckBox *autoRefreshCheckbox = new QCheckBox("Auto-refresh (10s)", this);
+    QCheckBox *autoRefreshCheckbox = new QCheckBox("Auto-refresh (10s, usage 2s)", this);
     autoRefreshCheckbox->setChecked(true);
     connect(autoRefreshCheckbox, &QCheckBox::toggled, [this](bool checked) {
         if (checked) {
             autoRefreshTimer->start(10000);
+            resourceTimer->start(2000);
         } else {
             autoRefreshTimer->stop();
+            resourceTimer->stop();
         }
     });
     statusLayout->addWidget(autoRefreshCheckbox);
@@ -168,6 +180,7 @@ void ServiceWindow::updateTable() {
     }
 
     serviceTable->setRowCount(filteredServices.size());
+    nameItems.clear();
 
     for (size_t i = 0; i < filteredServices.size(); ++i) {
         const auto& service = filteredServices[i];
@@ -175,11 +188,12 @@ void ServiceWindow::updateTable() {
         // Service name
         QTableWidgetItem *nameItem = new QTableWidgetItem(QString::fromStdString(service.name));
         nameItem->setData(Qt::UserRole, QString::fromStdString(service.name)); // Store original name for sorting
-        serviceTable->setItem(i, 0, nameItem);
+        serviceTable->setItem(i, NameColumn, nameItem);
+        nameItems.insert(nameItem->text(), nameItem);
 
         // Description
         QTableWidgetItem *descItem = new QTableWidgetItem(QString::fromStdString(service.description));
-        serviceTable->setItem(i, 1, descItem);
+        serviceTable->setItem(i, DescriptionColumn, descItem);
 
         // Status
         QTableWidgetItem *statusItem = new QTableWidgetItem(QString::fromStdString(service.activeState));
@@ -199,11 +213,19 @@ void ServiceWindow::updateTable() {
             statusItem->setData(Qt::UserRole + 1, "inactive"); // Add status attribute
         }
         statusItem->setData(Qt::UserRole, statusValue);
-        serviceTable->setItem(i, 2, statusItem);
+        serviceTable->setItem(i, StatusColumn, statusItem);
 
         // Sub-state
         QTableWidgetItem *subStateItem = new QTableWidgetItem(QString::fromStdString(service.subState));
-        serviceTable->setItem(i, 3, subStateItem);
+        serviceTable->setItem(i, SubStateColumn, subStateItem);
+
+        // Resource usage, empty for units that are not running
+        for (int column = CpuColumn; column < ColumnCount; ++column) {
+            QTableWidgetItem *item = new NumericTableItem();
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            serviceTable->setItem(i, column, item);
+        }
+        setResourceCells(i, serviceResources.find(service.name));
     }
 
     // Re-enable sorting if it was enabled before
@@ -222,6 +244,7 @@ void ServiceWindow::refreshData() {
     Qt::SortOrder sortOrder = serviceTable->horizontalHeader()->sortIndicatorOrder();
 
     serviceInfo.refresh();
+    updateTrackedUnits();
     updateTable();
 
     // Restore the sort order
@@ -235,12 +258,71 @@ void ServiceWindow::refreshData() {
     }
 }
 
+void ServiceWindow::updateTrackedUnits() {
+    std::vector<std::string> running;
+    for (const auto& service : serviceInfo.getAllServices()) {
+        if (service.status == ServiceStatus::ACTIVE) {
+            running.push_back(service.name);
+        }
+    }
+    serviceResources.setRunningUnits(running);
+}
+
+void ServiceWindow::updateResources() {
+    if (!serviceResources.isAvailable()) {
+        return;
+    }
+
+    serviceResources.sample();
+
+    // Only rows of running units change; re-sort once at the end
+    bool wasSortingEnabled = serviceTable->isSortingEnabled();
+    serviceTable->setSortingEnabled(false);
+
+    for (const std::string& name : serviceResources.getTrackedUnits()) {
+        QTableWidgetItem *nameItem = nameItems.value(QString::fromStdString(name));
+        if (nameItem) {
+            setResourceCells(nameItem->row(), serviceResources.find(name));
+        }
+    }
+
+    serviceTable->setSortingEnabled(wasSortingEnabled);
+
+    lastUpdateLabel->setToolTip(QString("Resource usage of %1 running units read in %2 ms")
+                                    .arg(serviceResources.getTrackedUnits().size())
+                                    .arg(serviceResources.getLastSampleDurationMs(), 0, 'f', 2));
+}
+
+void ServiceWindow::setResourceCells(int row, const ServiceResources *resources) {
+    auto setCell = [this, row](int column, const QString &text, double value) {
+        QTableWidgetItem *item = serviceTable->item(row, column);
+        if (item->text() != text) {
+            item->setText(text);
+        }
+        item->setData(Qt::UserRole, value);
+    };
+
+    if (!resources || !resources->available) {
+        // Sort below every running unit
+        for (int column = CpuColumn; column < ColumnCount; ++column) {
+            setCell(column, QString(), -1.0);
+        }
+        return;
+    }
+
+    setCell(CpuColumn, QString::number(resources->cpuPercent, 'f', 1), resources->cpuPercent);
+    setCell(MemoryColumn, formatSize(resources->memoryBytes), static_cast<double>(resources->memoryBytes));
+    setCell(TasksColumn, QString::number(resources->tasks), static_cast<double>(resources->tasks));
+    setCell(IoReadColumn, formatSize(static_cast<uint64_t>(resources->ioReadBytesPerSec)) + "/s", resources->ioReadBytesPerSec);
+    setCell(IoWriteColumn, formatSize(static_cast<uint64_t>(resources->ioWriteBytesPerSec)) + "/s", resources->ioWriteBytesPerSec);
+}
+
 void ServiceWindow::filterServices(const QString& text) {
     updateTable();
 }
 
 void ServiceWindow::serviceSelected(int row, int column) {
-    selectedService = serviceTable->item(row, 0)->text().toStdString();
+    selectedService = serviceTable->item(row, NameColumn)->text().toStdString();
 
     // Get detailed information about the selected service
     ServiceInfo details = serviceInfo.getServiceDetails(selectedService);
@@ -356,4 +438,17 @@ void ServiceWindow::showMessage(const QString& message, bool isError) {
         statusLabel->setText("");
         statusLabel->setStyleSheet("");
     });
+}
+
+QString ServiceWindow::formatSize(uint64_t bytes) const {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unitIndex = 0;
+    double size = static_cast<double>(bytes);
+
+    while (size >= 1024.0 && unitIndex < 4) {
+        size /= 1024.0;
+        unitIndex++;
+    }
+
+    return QString::number(size, 'f', unitIndex == 0 ? 0 : 1) + " " + units[unitIndex];
 }
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "smaps_sampler.h"
+#include "sysfs_file.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t READ_BUFFER_SIZE = 4096;
+
+// Age given to processes never read, so they rank ahead of any cached one
+const double UNSAMPLED_AGE_SECONDS = 1e9;
+
+// Starting guess for the cost of one smaps_rollup read
+const double INITIAL_READ_MS = 0.2;
+
+// Value of "\n<key> <n> kB" in bytes
+uint64_t kilobytesOf(const char* text, const char* key) {
+    const char* line = strstr(text, key);
+    return line ? strtoull(line + strlen(key), nullptr, 10) * 1024 : 0;
+}
+
+} // namespace
+
+SmapsSampler::SmapsSampler(double budgetMs)
+    : budgetMs(budgetMs),
+      procFd(-1),
+      readBuffer(READ_BUFFER_SIZE),
+      averageReadMs(INITIAL_READ_MS),
+      lastSampleCount(0),
+      lastSampleDurationMs(0.0),
+      sampledCount(0) {
+
+    procFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+SmapsSampler::~SmapsSampler() {
+    if (procFd >= 0) {
+        close(procFd);
+    }
+}
+
+void SmapsSampler::setBudgetMs(double budget) {
+    budgetMs = budget;
+}
+
+double SmapsSampler::getBudgetMs() const {
+    return budgetMs;
+}
+
+size_t SmapsSampler::getLastSampleCount() const {
+    return lastSampleCount;
+}
+
+double SmapsSampler::getLastSampleDurationMs() const {
+    return lastSampleDurationMs;
+}
+
+size_t SmapsSampler::getSampledCount() const {
+    return sampledCount;
+}
+
+size_t SmapsSampler::getProcessCount() const {
+    return entries.size();
+}
+
+void SmapsSampler::update(const std::vector<ProcessInfo>& processes) {
+    if (procFd < 0) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Carry cached values over to processes that are still the same
+    previousEntries.swap(entries);
+    entries.clear();
+    entries.reserve(processes.size());
+
+    size_t cursor = 0;
+    for (const auto& info : processes) {
+        while (cursor < previousEntries.size() && previousEntries[cursor].pid < info.pid) {
+            ++cursor;
+        }
+
+        if (cursor < previousEntries.size() && previousEntries[cursor].pid == info.pid &&
+            previousEntries[cursor].startTime == info.startTime) {
+            entries.push_back(std::move(previousEntries[cursor]));
+        } else {
+            entries.push_back(Entry{});
+            entries.back().pid = info.pid;
+            entries.back().startTime = info.startTime;
+        }
+
+        Entry& entry = entries.back();
+        entry.rssBytes = info.rssBytes;
+        entry.name = info.name;
+    }
+
+    // Rank by RSS times staleness. Only the head of the ranking can fit in
+    // the budget, so order just as many as the recent read cost suggests
+    candidates.clear();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry& entry = entries[i];
+        if (entry.denied || entry.rssBytes == 0) {
+            continue;   // Kernel threads have no address space to walk
+        }
+        double age = entry.sampled
+            ? std::chrono::duration<double>(start - entry.sampledAt).count()
+            : UNSAMPLED_AGE_SECONDS;
+        candidates.push_back({static_cast<double>(entry.rssBytes) * age, i});
+    }
+
+    size_t expected = static_cast<size_t>(budgetMs / std::max(averageReadMs, 0.01)) * 2 + 16;
+    size_t ranked = std::min(expected, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + ranked, candidates.end(),
+                      [](const std::pair<double, size_t>& a, const std::pair<double, size_t>& b) {
+                          return a.first > b.first;
+                      });
+
+    // The budget covers the whole update, carry-over and ranking included
+    lastSampleCount = 0;
+    auto readStart = std::chrono::steady_clock::now();
+    auto now = readStart;
+    for (size_t k = 0; k < ranked; ++k) {
+        if (std::chrono::duration<double, std::milli>(now - start).count() >= budgetMs) {
+            break;
+        }
+        if (readRollup(entries[candidates[k].second])) {
+            lastSampleCount++;
+        }
+        now = std::chrono::steady_clock::now();
+    }
+
+    if (lastSampleCount > 0) {
+        double readMs = std::chrono::duration<double, std::milli>(now - readStart).count();
+        averageReadMs = 0.7 * averageReadMs + 0.3 * (readMs / lastSampleCount);
+    }
+
+    sampledCount = 0;
+    for (const auto& entry : entries) {
+        if (entry.sampled) {
+            sampledCount++;
+        }
+    }
+
+    lastSampleDurationMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+bool SmapsSampler::readRollup(Entry& entry) {
+    char path[32];
+    snprintf(path, sizeof(path), "%d/smaps_rollup", entry.pid);
+
+    SysfsFile file(procFd, path);
+    if (!file.isOpen()) {
+        if (errno == EACCES || errno == EPERM) {
+            entry.denied = true;
+        }
+        return false;
+    }
+
+    ssize_t length = file.read(readBuffer.data(), readBuffer.size());
+    if (length <= 0) {
+        // Kernel threads and zombies read as empty
+        if (length < 0 && (errno == EACCES || errno == EPERM)) {
+            entry.denied = true;
+        }
+        return false;
+    }
+
+    const char* text = readBuffer.data();
+    entry.pssBytes = kilobytesOf(text, "\nPss:");
+    entry.ussBytes = kilobytesOf(text, "\nPrivate_Clean:") + kilobytesOf(text, "\nPrivate_Dirty:");
+    entry.swapBytes = kilobytesOf(text, "\nSwap:");
+    entry.swapPssBytes = kilobytesOf(text, "\nSwapPss:");
+    entry.sampledAt = std::chrono::steady_clock::now();
+    entry.sampled = true;
+    return true;
+}
+
+std::vector<SmapsRollupInfo> SmapsSampler::getTopConsumers(size_t count) const {
+    std::vector<const Entry*> sampled;
+    for (const auto& entry : entries) {
+        if (entry.sampled) {
+            sampled.push_back(&entry);
+        }
+    }
+
+    count = std::min(count, sampled.size());
+    std::partial_sort(sampled.begin(), sampled.begin() + count, sampled.end(),
+                      [](const Entry* a, const Entry* b) { return a->pssBytes > b->pssBytes; });
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<SmapsRollupInfo> top;
+    top.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Entry* entry = sampled[i];
+        top.push_back({entry->pid, entry->name, entry->rssBytes, entry->pssBytes, entry->ussBytes,
+                       entry->swapBytes, entry->swapPssBytes,
+                       std::chrono::duration<double>(now - entry->sampledAt).count()});
+    }
+    return top;
+}
@@ -0,0 +1,184 @@
+#include "statvfs_pool.h"
+#include "sample_clock.h"
+#include <sys/statvfs.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <utility>
+
+StatvfsPool::StatvfsPool(size_t maxWorkers, size_t maxStuckWorkers, int64_t stuckAfterNs)
+    : state(std::make_shared<State>()) {
+    state->maxWorkers = maxWorkers > 0 ? maxWorkers : 1;
+    state->maxStuckWorkers = maxStuckWorkers;
+    state->stuckAfterNs = stuckAfterNs;
+}
+
+StatvfsPool::~StatvfsPool() {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->stopping = true;
+    state->queue.clear();
+    state->workAvailable.notify_all();
+}
+
+void StatvfsPool::request(int mountId, const std::string& path) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+
+    auto inserted = state->entries.try_emplace(mountId);
+    Entry& entry = inserted.first->second;
+    if (inserted.second || entry.path != path) {
+        // A reused ID: the answer of a call still pending for the old
+        // mount is dropped through the new ticket
+        entry.result = StatvfsResult{};
+        entry.path = path;
+    } else if (entry.result.pending) {
+        // Workers that got stuck since it was queued may be replaced now
+        startWorkers(state);
+        return;
+    }
+
+    entry.result.pending = true;
+    entry.result.queuedNs = SampleClock::nowNs();
+    entry.result.startedNs = 0;
+    entry.ticket = state->nextTicket++;
+    state->batchRemaining++;
+    state->queue.push_back(Job{mountId, entry.ticket, state->batch, path});
+
+    startWorkers(state);
+    state->workAvailable.notify_one();
+}
+
+void StatvfsPool::startWorkers(const std::shared_ptr<State>& state) {
+    // Busy workers may be stuck for good, so queued calls get new ones.
+    // Stuck workers are left out of the limit up to a limit of their own
+    if (state->idleWorkers >= state->queue.size()) {
+        return;
+    }
+    size_t stuck = std::min(stuckWorkers(*state, SampleClock::nowNs()), state->maxStuckWorkers);
+    while (state->idleWorkers < state->queue.size() && state->workers < state->maxWorkers + stuck) {
+        state->workers++;
+        state->idleWorkers++;
+        std::thread(&StatvfsPool::work, state).detach();
+    }
+}
+
+void StatvfsPool::wait(int64_t deadlineNs) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (state->batchRemaining > 0) {
+        int64_t remaining = deadlineNs - SampleClock::nowNs();
+        if (remaining <= 0) {
+            break;
+        }
+        state->batchDone.wait_for(lock, std::chrono::nanoseconds(remaining));
+    }
+
+    // Calls still pending now answer whenever they can, outside any batch
+    state->batch++;
+    state->batchRemaining = 0;
+}
+
+bool StatvfsPool::getResult(int mountId, StatvfsResult& result) const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto it = state->entries.find(mountId);
+    if (it == state->entries.end()) {
+        return false;
+    }
+    result = it->second.result;
+    return true;
+}
+
+void StatvfsPool::retain(const std::unordered_set<int>& mountIds) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    for (auto it = state->entries.begin(); it != state->entries.end(); ) {
+        if (mountIds.count(it->first)) {
+            ++it;
+        } else {
+            it = state->entries.erase(it);
+        }
+    }
+}
+
+size_t StatvfsPool::getWorkerCount() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->workers;
+}
+
+size_t StatvfsPool::getStuckWorkerCount() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return stuckWorkers(*state, SampleClock::nowNs());
+}
+
+size_t StatvfsPool::stuckWorkers(const State& state, int64_t now) {
+    size_t stuck = 0;
+    for (const auto& call : state.running) {
+        if (now - call.second > state.stuckAfterNs) {
+            stuck++;
+        }
+    }
+    return stuck;
+}
+
+void StatvfsPool::work(std::shared_ptr<State> state) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    for (;;) {
+        // A worker that was stuck has been replaced meanwhile, so the pool
+        // shrinks back to its limit as such workers come back
+        if (state->workers - stuckWorkers(*state, SampleClock::nowNs()) > state->maxWorkers) {
+            state->workers--;
+            state->idleWorkers--;
+            return;
+        }
+
+        state->workAvailable.wait(lock, [&state] { return state->stopping || !state->queue.empty(); });
+        if (state->stopping) {
+            state->workers--;
+            state->idleWorkers--;
+            return;
+        }
+
+        Job job = std::move(state->queue.front());
+        state->queue.pop_front();
+
+        // Skip calls for mounts forgotten while queued
+        auto it = state->entries.find(job.mountId);
+        if (it == state->entries.end() || it->second.ticket != job.ticket) {
+            finishJob(*state, job);
+            continue;
+        }
+        it->second.result.startedNs = SampleClock::nowNs();
+        state->running[job.ticket] = it->second.result.startedNs;
+        state->idleWorkers--;
+        lock.unlock();
+
+        struct statvfs stat;
+        int error = statvfs(job.path.c_str(), &stat) == 0 ? 0 : errno;
+        int64_t now = SampleClock::nowNs();
+
+        lock.lock();
+        state->idleWorkers++;
+        state->running.erase(job.ticket);
+        it = state->entries.find(job.mountId);
+        if (it == state->entries.end() || it->second.ticket != job.ticket) {
+            finishJob(*state, job);
+            continue;
+        }
+
+        StatvfsResult& result = it->second.result;
+        result.error = error;
+        if (error == 0) {
+            result.valid = true;
+            result.totalSize = static_cast<uint64_t>(stat.f_blocks) * stat.f_frsize;
+            result.freeSpace = static_cast<uint64_t>(stat.f_bfree) * stat.f_frsize;
+            result.availableSpace = static_cast<uint64_t>(stat.f_bavail) * stat.f_frsize;
+        }
+        result.sampledNs = now;
+        result.pending = false;
+        result.startedNs = 0;
+        finishJob(*state, job);
+    }
+}
+
+void StatvfsPool::finishJob(State& state, const Job& job) {
+    if (job.batch == state.batch && state.batchRemaining > 0 && --state.batchRemaining == 0) {
+        state.batchDone.notify_all();
+    }
+}
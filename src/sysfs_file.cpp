@@ -0,0 +1,114 @@
+#include "sysfs_file.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+
+SysfsFile::SysfsFile(const std::string& path) {
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+SysfsFile::SysfsFile(int dirFd, const char* name) {
+    fd = ::openat(dirFd, name, O_RDONLY | O_CLOEXEC);
+}
+
+SysfsFile::~SysfsFile() {
+    close();
+}
+
+SysfsFile::SysfsFile(SysfsFile&& other) noexcept : fd(other.fd) {
+    other.fd = -1;
+}
+
+SysfsFile& SysfsFile::operator=(SysfsFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd = other.fd;
+        other.fd = -1;
+    }
+    return *this;
+}
+
+void SysfsFile::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+ssize_t SysfsFile::read(char* buffer, size_t size) const {
+    if (fd < 0 || size == 0) {
+        return -1;
+    }
+
+    // sysfs and seq_file attributes regenerate their content on a read at
+    // offset 0, so pread() always yields a fresh value without lseek().
+    ssize_t total = 0;
+    while (static_cast<size_t>(total) < size - 1) {
+        ssize_t n = ::pread(fd, buffer + total, size - 1 - total, total);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+
+    buffer[total] = '\0';
+    return total;
+}
+
+bool SysfsFile::readUInt64(uint64_t& value) const {
+    char buffer[32];
+    if (read(buffer, sizeof(buffer)) <= 0) {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = std::strtoull(buffer, &end, 10);
+    if (end == buffer || errno != 0) {
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+bool SysfsFile::readInt64(int64_t& value) const {
+    char buffer[32];
+    if (read(buffer, sizeof(buffer)) <= 0) {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    long long parsed = std::strtoll(buffer, &end, 10);
+    if (end == buffer || errno != 0) {
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+std::string SysfsFile::readString() const {
+    char buffer[256];
+    ssize_t length = read(buffer, sizeof(buffer));
+    if (length <= 0) {
+        return "";
+    }
+
+    std::string content(buffer, length);
+
+    // Remove trailing newline if present
+    if (!content.empty() && content.back() == '\n') {
+        content.pop_back();
+    }
+
+    return content;
+}
@@ -0,0 +1,323 @@
+#include "thermal_info.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <set>
+#include <cctype>
+
+namespace fs = std::filesystem;
+
+ThermalInfoCollector::ThermalInfoCollector()
+    : lastCoreTotal(0),
+      lastPackageTotal(0),
+      hasPreviousSample(false) {
+
+    // Sensor paths are discovered once; every later sample goes through
+    // the descriptors kept open here
+    discoverHwmonSensors();
+    discoverThermalZones();
+    discoverThrottleCounters();
+
+    refresh();
+}
+
+std::vector<TemperatureSensor> ThermalInfoCollector::getSensors() const {
+    std::vector<TemperatureSensor> result;
+    result.reserve(sensors.size());
+    for (const auto& sensor : sensors) {
+        result.push_back(sensor.info);
+    }
+    return result;
+}
+
+std::vector<ThrottleInfo> ThermalInfoCollector::getThrottleInfo() const {
+    std::vector<ThrottleInfo> result;
+    result.reserve(throttles.size());
+    for (const auto& throttle : throttles) {
+        result.push_back(throttle.info);
+    }
+    return result;
+}
+
+const std::deque<ThrottleRateSample>& ThermalInfoCollector::getThrottleHistory() const {
+    return throttleHistory;
+}
+
+bool ThermalInfoCollector::hasThrottleCounters() const {
+    return !throttles.empty();
+}
+
+uint64_t ThermalInfoCollector::getTotalCoreThrottleCount() const {
+    uint64_t total = 0;
+    for (const auto& throttle : throttles) {
+        total += throttle.info.coreThrottleCount;
+    }
+    return total;
+}
+
+uint64_t ThermalInfoCollector::getTotalPackageThrottleCount() const {
+    // Every CPU of a package reports the same package counter
+    uint64_t total = 0;
+    for (const auto& throttle : throttles) {
+        if (throttle.firstInPackage) {
+            total += throttle.info.packageThrottleCount;
+        }
+    }
+    return total;
+}
+
+void ThermalInfoCollector::discoverHwmonSensors() {
+    const std::string hwmonRoot = "/sys/class/hwmon";
+    std::error_code ec;
+    if (!fs::exists(hwmonRoot, ec)) {
+        return;
+    }
+
+    std::vector<fs::path> hwmonDirs;
+    for (const auto& entry : fs::directory_iterator(hwmonRoot, ec)) {
+        hwmonDirs.push_back(entry.path());
+    }
+    std::sort(hwmonDirs.begin(), hwmonDirs.end());
+
+    for (const auto& hwmonDir : hwmonDirs) {
+        std::string chipName = readFileContent((hwmonDir / "name").string());
+        if (chipName.empty()) {
+            chipName = hwmonDir.filename().string();
+        }
+
+        std::vector<std::string> inputs;
+        for (const auto& entry : fs::directory_iterator(hwmonDir, ec)) {
+            std::string fileName = entry.path().filename().string();
+            if (fileName.compare(0, 4, "temp") == 0 &&
+                fileName.size() > 10 &&
+                fileName.compare(fileName.size() - 6, 6, "_input") == 0) {
+                inputs.push_back(fileName);
+            }
+        }
+        std::sort(inputs.begin(), inputs.end());
+
+        for (const auto& inputName : inputs) {
+            std::string prefix = inputName.substr(0, inputName.size() - 6);
+
+            SensorHandle handle;
+            handle.input = SysfsFile((hwmonDir / inputName).string());
+            if (!handle.input.isOpen()) {
+                continue;
+            }
+
+            handle.info.chip = chipName;
+            handle.info.label = readFileContent((hwmonDir / (prefix + "_label")).string());
+            if (handle.info.label.empty()) {
+                handle.info.label = prefix;
+            }
+            handle.info.source = "hwmon";
+            handle.info.temperatureC = 0.0;
+            handle.info.criticalC = 0.0;
+            handle.info.valid = false;
+
+            std::string critContent = readFileContent((hwmonDir / (prefix + "_crit")).string());
+            if (!critContent.empty()) {
+                try {
+                    handle.info.criticalC = std::stod(critContent) / 1000.0;
+                } catch (...) {
+                    handle.info.criticalC = 0.0;
+                }
+            }
+
+            sensors.push_back(std::move(handle));
+        }
+    }
+}
+
+void ThermalInfoCollector::discoverThermalZones() {
+    const std::string thermalRoot = "/sys/class/thermal";
+    std::error_code ec;
+    if (!fs::exists(thermalRoot, ec)) {
+        return;
+    }
+
+    std::vector<fs::path> zoneDirs;
+    for (const auto& entry : fs::directory_iterator(thermalRoot, ec)) {
+        if (entry.path().filename().string().compare(0, 12, "thermal_zone") == 0) {
+            zoneDirs.push_back(entry.path());
+        }
+    }
+    std::sort(zoneDirs.begin(), zoneDirs.end());
+
+    for (const auto& zoneDir : zoneDirs) {
+        SensorHandle handle;
+        handle.input = SysfsFile((zoneDir / "temp").string());
+        if (!handle.input.isOpen()) {
+            continue;
+        }
+
+        handle.info.chip = readFileContent((zoneDir / "type").string());
+        handle.info.label = zoneDir.filename().string();
+        handle.info.source = "thermal";
+        handle.info.temperatureC = 0.0;
+        handle.info.criticalC = 0.0;
+        handle.info.valid = false;
+
+        // Use the first trip point of type "critical" as the critical limit
+        for (int trip = 0; trip < 32; ++trip) {
+            std::string tripPrefix = "trip_point_" + std::to_string(trip);
+            std::string tripType = readFileContent((zoneDir / (tripPrefix + "_type")).string());
+            if (tripType.empty()) {
+                break;
+            }
+            if (tripType == "critical") {
+                std::string tripTemp = readFileContent((zoneDir / (tripPrefix + "_temp")).string());
+                try {
+                    handle.info.criticalC = std::stod(tripTemp) / 1000.0;
+                } catch (...) {
+                    handle.info.criticalC = 0.0;
+                }
+                break;
+            }
+        }
+
+        sensors.push_back(std::move(handle));
+    }
+}
+
+void ThermalInfoCollector::discoverThrottleCounters() {
+    const std::string cpuRoot = "/sys/devices/system/cpu";
+    std::error_code ec;
+    if (!fs::exists(cpuRoot, ec)) {
+        return;
+    }
+
+    std::vector<int> cpus;
+    for (const auto& entry : fs::directory_iterator(cpuRoot, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() > 3 && name.compare(0, 3, "cpu") == 0 &&
+            std::all_of(name.begin() + 3, name.end(), ::isdigit)) {
+            cpus.push_back(std::stoi(name.substr(3)));
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+
+    std::set<int> seenPackages;
+    for (int cpu : cpus) {
+        std::string cpuDir = cpuRoot + "/cpu" + std::to_string(cpu);
+
+        ThrottleHandle handle;
+        handle.coreCount = SysfsFile(cpuDir + "/thermal_throttle/core_throttle_count");
+        handle.packageCount = SysfsFile(cpuDir + "/thermal_throttle/package_throttle_count");
+        if (!handle.coreCount.isOpen() && !handle.packageCount.isOpen()) {
+            continue;
+        }
+
+        handle.info.cpu = cpu;
+        handle.info.packageId = -1;
+        handle.info.coreThrottleCount = 0;
+        handle.info.packageThrottleCount = 0;
+
+        std::string packageContent = readFileContent(cpuDir + "/topology/physical_package_id");
+        if (!packageContent.empty()) {
+            try {
+                handle.info.packageId = std::stoi(packageContent);
+            } catch (...) {
+                handle.info.packageId = -1;
+            }
+        }
+        handle.firstInPackage = seenPackages.insert(handle.info.packageId).second;
+
+        throttles.push_back(std::move(handle));
+    }
+}
+
+void ThermalInfoCollector::refresh() {
+    for (auto& sensor : sensors) {
+        int64_t milliDegrees = 0;
+        sensor.info.valid = sensor.input.readInt64(milliDegrees);
+        sensor.info.temperatureC = sensor.info.valid ? milliDegrees / 1000.0 : 0.0;
+    }
+
+    if (throttles.empty()) {
+        return;
+    }
+
+    for (auto& throttle : throttles) {
+        throttle.coreCount.readUInt64(throttle.info.coreThrottleCount);
+        throttle.packageCount.readUInt64(throttle.info.packageThrottleCount);
+    }
+
+    // Turn the monotonically increasing counters into event rates
+    auto now = std::chrono::steady_clock::now();
+    uint64_t coreTotal = getTotalCoreThrottleCount();
+    uint64_t packageTotal = getTotalPackageThrottleCount();
+
+    if (hasPreviousSample) {
+        double elapsed = std::chrono::duration<double>(now - lastSampleTime).count();
+        if (elapsed > 0.0) {
+            ThrottleRateSample sample;
+            sample.timestamp = now;
+            sample.coreEventsPerSec = coreTotal >= lastCoreTotal
+                ? (coreTotal - lastCoreTotal) / elapsed : 0.0;
+            sample.packageEventsPerSec = packageTotal >= lastPackageTotal
+                ? (packageTotal - lastPackageTotal) / elapsed : 0.0;
+
+            throttleHistory.push_back(sample);
+            if (throttleHistory.size() > MAX_HISTORY_SIZE) {
+                throttleHistory.pop_front();
+            }
+        }
+    }
+
+    lastCoreTotal = coreTotal;
+    lastPackageTotal = packageTotal;
+    lastSampleTime = now;
+    hasPreviousSample = true;
+}
+
+std::string ThermalInfoCollector::readFileContent(const std::string& filePath) const {
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        return "";
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string content = buffer.str();
+
+    // Remove trailing newline if present
+    if (!content.empty() && content.back() == '\n') {
+        content.pop_back();
+    }
+
+    return content;
+}
+
+void ThermalInfoCollector::printAllInfo() const {
+    std::cout << "Thermal Information:" << std::endl;
+    std::cout << "--------------------" << std::endl;
+
+    if (sensors.empty()) {
+        std::cout << "No temperature sensors found" << std::endl;
+    }
+
+    for (const auto& sensor : sensors) {
+        std::cout << sensor.info.chip << " / " << sensor.info.label
+                  << " [" << sensor.info.source << "]: ";
+        if (sensor.info.valid) {
+            std::cout << std::fixed << std::setprecision(1) << sensor.info.temperatureC << " C";
+            if (sensor.info.criticalC > 0) {
+                std::cout << " (critical " << sensor.info.criticalC << " C)";
+            }
+        } else {
+            std::cout << "unavailable";
+        }
+        std::cout << std::endl;
+    }
+
+    if (!throttles.empty()) {
+        std::cout << "\nThermal Throttling:" << std::endl;
+        std::cout << "-------------------" << std::endl;
+        std::cout << "Core throttle events: " << getTotalCoreThrottleCount() << std::endl;
+        std::cout << "Package throttle events: " << getTotalPackageThrottleCount() << std::endl;
+    }
+}
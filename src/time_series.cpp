@@ -0,0 +1,353 @@
+#include "time_series.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+namespace {
+
+const char FILE_MAGIC[8] = {'Q', 'T', 'S', 'S', 'T', 'S', 'E', 'R'};
+const uint32_t FILE_VERSION = 2;       // 2: one spare slot per ring
+
+// Points start on their own page, after the header
+const size_t HEADER_SIZE = 4096;
+
+uint64_t checksumOf(const void* data, size_t length) {
+    // FNV-1a
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+struct TimeSeries::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t pointSize;
+    uint64_t capacities[TIER_COUNT];
+    State states[2];
+};
+
+TimeSeries::TimeSeries()
+    : TimeSeries(Config()) {
+}
+
+TimeSeries::TimeSeries(const Config& config)
+    : capacities{std::max<size_t>(config.rawCapacity, 1),
+                 std::max<size_t>(config.minuteCapacity, 1),
+                 std::max<size_t>(config.hourCapacity, 1)},
+      state{},
+      header(nullptr),
+      tiers{},
+      mapping(nullptr),
+      mappingFd(-1),
+      writable(true) {
+
+    static_assert(sizeof(Header) <= HEADER_SIZE, "ring file header outgrew its page");
+
+    memory.resize(blockSize());
+    initializeBlock(memory.data());
+    useBlock(memory.data());
+    loadState();
+}
+
+TimeSeries::~TimeSeries() {
+    releaseMapping();
+}
+
+size_t TimeSeries::blockSize() const {
+    return HEADER_SIZE + (slotsOf(0) + slotsOf(1) + slotsOf(2)) * sizeof(TimeSeriesPoint);
+}
+
+size_t TimeSeries::slotsOf(int index) const {
+    return capacities[index] + 1;
+}
+
+void TimeSeries::initializeBlock(char* block) {
+    Header* fresh = reinterpret_cast<Header*>(block);
+    memset(fresh, 0, HEADER_SIZE);
+    memcpy(fresh->magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    fresh->version = FILE_VERSION;
+    fresh->pointSize = sizeof(TimeSeriesPoint);
+    for (int i = 0; i < TIER_COUNT; ++i) {
+        fresh->capacities[i] = capacities[i];
+    }
+
+    // An empty history; the second copy stays invalid until first written
+    State empty;
+    memset(&empty, 0, sizeof(empty));
+    empty.checksum = checksumOf(&empty, offsetof(State, checksum));
+    fresh->states[0] = empty;
+}
+
+void TimeSeries::useBlock(char* block) {
+    header = reinterpret_cast<Header*>(block);
+    TimeSeriesPoint* points = reinterpret_cast<TimeSeriesPoint*>(block + HEADER_SIZE);
+    for (int i = 0; i < TIER_COUNT; ++i) {
+        tiers[i] = points;
+        points += slotsOf(i);
+    }
+}
+
+bool TimeSeries::loadState() {
+    if (memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+        header->version != FILE_VERSION || header->pointSize != sizeof(TimeSeriesPoint)) {
+        return false;
+    }
+    for (int i = 0; i < TIER_COUNT; ++i) {
+        if (header->capacities[i] != capacities[i]) {
+            return false;
+        }
+    }
+
+    // The newest copy that is whole and in bounds
+    const State* newest = nullptr;
+    for (const State& candidate : header->states) {
+        if (candidate.checksum != checksumOf(&candidate, offsetof(State, checksum))) {
+            continue;
+        }
+        bool inBounds = true;
+        for (int i = 0; i < TIER_COUNT; ++i) {
+            inBounds = inBounds && candidate.rings[i].head < slotsOf(i) &&
+                       candidate.rings[i].count <= capacities[i];
+        }
+        if (inBounds && (!newest || candidate.sequence > newest->sequence)) {
+            newest = &candidate;
+        }
+    }
+    if (!newest) {
+        return false;
+    }
+
+    state = *newest;
+    return true;
+}
+
+void TimeSeries::publishState() {
+    state.sequence++;
+    state.checksum = checksumOf(&state, offsetof(State, checksum));
+    header->states[state.sequence % 2] = state;
+}
+
+bool TimeSeries::attachFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    // One writer per file; other instances get a private copy
+    bool exclusive = flock(fd, LOCK_EX | LOCK_NB) == 0;
+
+    struct stat info;
+    size_t size = blockSize();
+    bool sized = fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == size;
+    if (!sized && (!exclusive || ftruncate(fd, 0) != 0 || ftruncate(fd, size) != 0)) {
+        close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, exclusive ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    char* block = static_cast<char*>(mapped);
+    char* previousBlock = reinterpret_cast<char*>(header);
+    State previousState = state;
+
+    useBlock(block);
+    if (!loadState()) {
+        if (!exclusive) {
+            // Not ours to reset
+            useBlock(previousBlock);
+            state = previousState;
+            munmap(mapped, size);
+            close(fd);
+            return false;
+        }
+        initializeBlock(block);
+        loadState();
+    }
+
+    releaseMapping();
+    mapping = mapped;
+    mappingFd = fd;
+    writable = exclusive;
+    memory.clear();
+    memory.shrink_to_fit();
+    return true;
+}
+
+bool TimeSeries::isPersistent() const {
+    return mapping && writable;
+}
+
+void TimeSeries::releaseMapping() {
+    if (mapping) {
+        munmap(mapping, blockSize());
+        mapping = nullptr;
+    }
+    if (mappingFd >= 0) {
+        close(mappingFd);
+        mappingFd = -1;
+    }
+}
+
+void TimeSeries::push(TimeSeriesTier tier, const TimeSeriesPoint& point) {
+    // The slot after the newest point is never one the published state
+    // covers, even in a full ring, so a crash before publishState() leaves
+    // the previous state's points intact
+    int index = static_cast<int>(tier);
+    Ring& ring = state.rings[index];
+    tiers[index][(ring.head + ring.count) % slotsOf(index)] = point;
+    if (ring.count < capacities[index]) {
+        ring.count++;
+    } else {
+        // Full: drop the oldest
+        ring.head = (ring.head + 1) % slotsOf(index);
+    }
+}
+
+size_t TimeSeries::sizeOf(TimeSeriesTier tier) const {
+    return state.rings[static_cast<int>(tier)].count;
+}
+
+const TimeSeriesPoint& TimeSeries::at(TimeSeriesTier tier, size_t index) const {
+    int i = static_cast<int>(tier);
+    return tiers[i][(state.rings[i].head + index) % slotsOf(i)];
+}
+
+size_t TimeSeries::lowerBound(TimeSeriesTier tier, int64_t timeMs) const {
+    size_t low = 0;
+    size_t high = sizeOf(tier);
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (at(tier, middle).timeMs < timeMs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void TimeSeries::append(int64_t timeMs, double value) {
+    if (!isEmpty() && timeMs < getLastTime()) {
+        return;     // Clock stepped back; buckets would go out of order
+    }
+
+    // Point slots first, then the state that makes them visible
+    push(TimeSeriesTier::RAW, {timeMs, value, value, value, value, 1});
+    addToBucket(TimeSeriesTier::MINUTE, MINUTE_MS, timeMs, value);
+    addToBucket(TimeSeriesTier::HOUR, HOUR_MS, timeMs, value);
+    publishState();
+}
+
+void TimeSeries::addToBucket(TimeSeriesTier tier, int64_t intervalMs, int64_t timeMs, double value) {
+    Bucket& bucket = state.buckets[static_cast<int>(tier) - 1];
+    int64_t start = timeMs - ((timeMs % intervalMs) + intervalMs) % intervalMs;
+
+    if (bucket.open && bucket.point.timeMs != start) {
+        bucket.point.avg = bucket.sum / bucket.point.count;
+        push(tier, bucket.point);
+        bucket.completed++;
+        bucket.open = 0;
+    }
+
+    if (!bucket.open) {
+        bucket.open = 1;
+        bucket.point = {start, value, value, value, value, 1};
+        bucket.sum = value;
+        return;
+    }
+
+    bucket.point.min = std::min(bucket.point.min, value);
+    bucket.point.max = std::max(bucket.point.max, value);
+    bucket.point.last = value;
+    bucket.point.count++;
+    bucket.sum += value;
+}
+
+bool TimeSeries::isEmpty() const {
+    return sizeOf(TimeSeriesTier::RAW) == 0;
+}
+
+int64_t TimeSeries::getLastTime() const {
+    size_t count = sizeOf(TimeSeriesTier::RAW);
+    return count > 0 ? at(TimeSeriesTier::RAW, count - 1).timeMs : 0;
+}
+
+double TimeSeries::getLastValue() const {
+    size_t count = sizeOf(TimeSeriesTier::RAW);
+    return count > 0 ? at(TimeSeriesTier::RAW, count - 1).last : 0.0;
+}
+
+const TimeSeries::Bucket* TimeSeries::bucketOf(TimeSeriesTier tier) const {
+    return tier == TimeSeriesTier::RAW ? nullptr : &state.buckets[static_cast<int>(tier) - 1];
+}
+
+int64_t TimeSeries::getOldestTime(TimeSeriesTier tier) const {
+    if (sizeOf(tier) > 0) {
+        return at(tier, 0).timeMs;
+    }
+    const Bucket* bucket = bucketOf(tier);
+    return bucket && bucket->open ? bucket->point.timeMs : getLastTime();
+}
+
+uint64_t TimeSeries::getBucketCount(TimeSeriesTier tier) const {
+    const Bucket* bucket = bucketOf(tier);
+    return bucket ? bucket->completed : sizeOf(tier);
+}
+
+TimeSeriesTier TimeSeries::tierFor(int64_t fromMs, int64_t toMs, size_t maxPoints) const {
+    // Raw: count the points actually held, the sample rate is not fixed
+    if (getOldestTime(TimeSeriesTier::RAW) <= fromMs || sizeOf(TimeSeriesTier::RAW) < capacities[0]) {
+        size_t points = lowerBound(TimeSeriesTier::RAW, toMs + 1) - lowerBound(TimeSeriesTier::RAW, fromMs);
+        if (points <= maxPoints) {
+            return TimeSeriesTier::RAW;
+        }
+    }
+
+    // Minute buckets: also fine while the ring has not wrapped yet, as
+    // there is no older data in any tier then
+    if ((getOldestTime(TimeSeriesTier::MINUTE) <= fromMs || sizeOf(TimeSeriesTier::MINUTE) < capacities[1]) &&
+        static_cast<size_t>((toMs - fromMs) / MINUTE_MS) + 1 <= maxPoints) {
+        return TimeSeriesTier::MINUTE;
+    }
+
+    return TimeSeriesTier::HOUR;
+}
+
+std::vector<TimeSeriesPoint> TimeSeries::range(TimeSeriesTier tier, int64_t fromMs, int64_t toMs) const {
+    std::vector<TimeSeriesPoint> result;
+    const Bucket* bucket = bucketOf(tier);
+
+    // Include the bucket that fromMs falls in
+    int64_t intervalMs = tier == TimeSeriesTier::HOUR ? HOUR_MS : MINUTE_MS;
+    size_t begin = lowerBound(tier, bucket ? fromMs - intervalMs + 1 : fromMs);
+    size_t end = lowerBound(tier, toMs + 1);
+    result.reserve(end - begin + 1);
+    for (size_t i = begin; i < end; ++i) {
+        result.push_back(at(tier, i));
+    }
+
+    if (bucket && bucket->open && bucket->point.timeMs > fromMs - intervalMs && bucket->point.timeMs <= toMs) {
+        TimeSeriesPoint partial = bucket->point;
+        partial.avg = bucket->sum / partial.count;
+        result.push_back(partial);
+    }
+    return result;
+}
+
+size_t TimeSeries::memoryBytes() const {
+    return sizeof(*this) + blockSize();
+}
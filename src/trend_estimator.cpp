@@ -0,0 +1,135 @@
+#include "trend_estimator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace {
+
+// Fewer samples than this give a line that mostly fits the noise
+const size_t MIN_SAMPLES = 12;
+
+// Standard errors either side of the slope for the ~95% interval
+const double INTERVAL_WIDTH = 2.0;
+
+const double NEVER = std::numeric_limits<double>::infinity();
+
+} // namespace
+
+TrendEstimator::TrendEstimator(size_t capacity)
+    : times(std::max<size_t>(capacity, MIN_SAMPLES)),
+      values(times.size()) {
+    clear();
+}
+
+void TrendEstimator::clear() {
+    head = 0;
+    count = 0;
+    addsSinceResum = 0;
+    timeOrigin = 0.0;
+    valueOrigin = 0.0;
+    sumT = sumV = sumTT = sumTV = sumVV = 0.0;
+}
+
+size_t TrendEstimator::size() const {
+    return count;
+}
+
+void TrendEstimator::accumulate(double seconds, double value, double sign) {
+    double t = seconds - timeOrigin;
+    double v = value - valueOrigin;
+    sumT += sign * t;
+    sumV += sign * v;
+    sumTT += sign * t * t;
+    sumTV += sign * t * v;
+    sumVV += sign * v * v;
+}
+
+void TrendEstimator::add(double seconds, double value) {
+    if (count == 0) {
+        timeOrigin = seconds;
+        valueOrigin = value;
+    }
+
+    if (count == times.size()) {
+        accumulate(times[head], values[head], -1.0);
+    } else {
+        count++;
+    }
+    times[head] = seconds;
+    values[head] = value;
+    head = (head + 1) % times.size();
+    accumulate(seconds, value, 1.0);
+
+    if (++addsSinceResum >= times.size()) {
+        resum();
+    }
+}
+
+void TrendEstimator::resum() {
+    // Origin at the oldest sample keeps the terms small for the next turn
+    size_t oldest = (head + times.size() - count) % times.size();
+    timeOrigin = times[oldest];
+    valueOrigin = values[oldest];
+    sumT = sumV = sumTT = sumTV = sumVV = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t index = (oldest + i) % times.size();
+        accumulate(times[index], values[index], 1.0);
+    }
+    addsSinceResum = 0;
+}
+
+TrendForecast TrendEstimator::forecast(double limit) const {
+    TrendForecast result{false, false, 0.0, 0.0, NEVER, NEVER, NEVER};
+    if (count < MIN_SAMPLES) {
+        return result;
+    }
+
+    double n = static_cast<double>(count);
+    double meanT = sumT / n;
+    double meanV = sumV / n;
+    double sxx = sumTT - sumT * meanT;
+    double sxy = sumTV - sumT * meanV;
+    double syy = sumVV - sumV * meanV;
+    if (sxx <= 0.0) {
+        return result;
+    }
+
+    double slope = sxy / sxx;
+    double residual = std::max(0.0, syy - slope * sxy);
+    double slopeError = std::sqrt(residual / (n - 2.0) / sxx);
+    result.valid = true;
+    result.slope = slope;
+    result.rSquared = syy > 0.0 ? std::min(1.0, std::max(0.0, slope * sxy / syy)) : 0.0;
+
+    // Distance from the fitted value at the latest sample
+    size_t newest = (head + times.size() - 1) % times.size();
+    double fitted = valueOrigin + meanV + slope * (times[newest] - timeOrigin - meanT);
+    double distance = limit - fitted;
+
+    double margin = INTERVAL_WIDTH * slopeError;
+    if (std::fabs(slope) <= margin || distance / slope < 0.0) {
+        return result;
+    }
+
+    double direction = slope > 0.0 ? 1.0 : -1.0;
+    result.approaching = true;
+    result.secondsToLimit = distance / slope;
+    result.earliestSeconds = distance / (slope + direction * margin);
+    result.latestSeconds = distance / (slope - direction * margin);
+    return result;
+}
+
+std::string TrendEstimator::formatDuration(double seconds) {
+    char text[32];
+    if (seconds < 90.0) {
+        snprintf(text, sizeof(text), "%.0f s", seconds);
+    } else if (seconds < 90.0 * 60.0) {
+        snprintf(text, sizeof(text), "%.0f min", seconds / 60.0);
+    } else if (seconds < 48.0 * 3600.0) {
+        snprintf(text, sizeof(text), "%.1f h", seconds / 3600.0);
+    } else {
+        snprintf(text, sizeof(text), "%.1f d", seconds / 86400.0);
+    }
+    return text;
+}